@@ -0,0 +1,88 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <trianglelite/trianglelite.h>
+
+#include "SegmentGrid.h"
+#include "bench_utils.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+using bench::PerforatedPlate;
+using trianglelite::Index;
+using trianglelite::Scalar;
+
+/**
+ * Reference winding number computation: sum of signed angles over all segments.
+ */
+Scalar naive_winding_number(const PerforatedPlate& plate, const Scalar* p)
+{
+    double theta = 0;
+    for (Index i = 0; i < plate.num_segments(); i++) {
+        const Scalar* v0 = plate.points.data() + plate.segments[i * 2] * 2;
+        const Scalar* v1 = plate.points.data() + plate.segments[i * 2 + 1] * 2;
+        const double x0 = v0[0] - p[0], y0 = v0[1] - p[1];
+        const double x1 = v1[0] - p[0], y1 = v1[1] - p[1];
+        theta += std::atan2(x0 * y1 - y0 * x1, x0 * x1 + y0 * y1);
+    }
+    return static_cast<Scalar>(theta / (2 * std::acos(-1.0)));
+}
+
+} // namespace
+
+TEST_CASE("Winding number queries", "[benchmark][hole]")
+{
+    for (int k : {10, 30, 100}) {
+        PerforatedPlate plate(k, 32);
+        const std::string suffix = " (" + std::to_string(plate.num_holes()) + " holes, " +
+                                   std::to_string(plate.num_segments()) + " segments)";
+
+        if (k <= 30) {
+            BENCHMARK("naive atan2" + suffix)
+            {
+                Scalar total = 0;
+                for (Index i = 0; i < plate.num_holes(); i++) {
+                    total += naive_winding_number(plate, plate.hole_centers.data() + i * 2);
+                }
+                return total;
+            };
+        }
+
+        BENCHMARK("segment grid" + suffix)
+        {
+            trianglelite::SegmentGrid grid(
+                plate.points.data(), plate.segments.data(), plate.num_segments());
+            Index total = 0;
+            for (Index i = 0; i < plate.num_holes(); i++) {
+                total += grid.winding_number(plate.hole_centers.data() + i * 2);
+            }
+            return total;
+        };
+    }
+}
+
+TEST_CASE("Auto hole detection", "[benchmark][hole]")
+{
+    using namespace trianglelite;
+
+    for (int k : {10, 30, 100}) {
+        PerforatedPlate plate(k, 32);
+        Config config;
+        config.verbose_level = 0;
+        config.min_angle = 0;
+        config.auto_hole_detection = true;
+
+        BENCHMARK("perforated plate (" + std::to_string(plate.num_holes()) + " holes)")
+        {
+            Engine engine;
+            engine.set_in_points(plate.points.data(), plate.num_points());
+            engine.set_in_segments(plate.segments.data(), plate.num_segments());
+            engine.run(config);
+            return engine.get_out_triangles().rows();
+        };
+    }
+}
@@ -0,0 +1,562 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <trianglelite/trianglelite.h>
+
+#include "bench_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Engine::run benchmarks across algorithms, input types and sizes.
+//
+// Cases up to 1e5 points run by default.  Cases with 1e6 and 1e7 points are hidden and have to be
+// requested explicitly, e.g. `trianglelite_bench "[large]" --benchmark-samples 5`.
+
+namespace {
+
+using namespace trianglelite;
+
+struct PointCloud
+{
+    std::string name;
+    std::vector<Scalar> points;
+};
+
+std::vector<PointCloud> generate_point_clouds(Index n)
+{
+    return {{"random", bench::random_points(n)},
+        {"grid", bench::grid_points(n)},
+        {"clustered", bench::clustered_points(n)}};
+}
+
+std::string size_label(Index n)
+{
+    return "1e" + std::to_string(static_cast<int>(std::lround(std::log10(double(n)))));
+}
+
+/**
+ * Benchmark Delaunay triangulation of point clouds with all algorithms, followed by quality
+ * refinement of the random cloud with several min angles.
+ */
+void bench_point_clouds(Index n)
+{
+    for (const auto& cloud : generate_point_clouds(n)) {
+        const Index num_points = static_cast<Index>(cloud.points.size() / 2);
+        for (auto algorithm : bench::all_algorithms()) {
+            Config config;
+            config.verbose_level = 0;
+            config.min_angle = 0;
+            config.algorithm = algorithm;
+
+            Engine engine;
+            engine.set_in_points(cloud.points.data(), num_points);
+            const std::string name = "delaunay " + cloud.name + " " + size_label(n) + " " +
+                                     bench::algorithm_name(algorithm);
+            BENCHMARK(std::string(name))
+            {
+                engine.run(config);
+                return engine.get_out_triangles().rows();
+            };
+            bench::report_throughput(name, engine, config);
+        }
+    }
+
+    const auto points = bench::random_points(n);
+    for (auto algorithm : bench::all_algorithms()) {
+        for (Scalar min_angle : {20, 30}) {
+            Config config;
+            config.verbose_level = 0;
+            config.min_angle = min_angle;
+            config.algorithm = algorithm;
+
+            Engine engine;
+            engine.set_in_points(points.data(), n);
+            const std::string name = "quality random " + size_label(n) + " " +
+                                     bench::algorithm_name(algorithm) + " q" +
+                                     std::to_string(static_cast<int>(min_angle));
+            BENCHMARK(std::string(name))
+            {
+                engine.run(config);
+                return engine.get_out_triangles().rows();
+            };
+            bench::report_throughput(name, engine, config);
+        }
+    }
+}
+
+/**
+ * Benchmark refinement of a square domain into about `n` triangles.  The square is scaled with
+ * `n` so that max area stays well above the precision limit of Triangle's command line.
+ */
+void bench_refinement(Index n)
+{
+    const Scalar s = static_cast<Scalar>(std::sqrt(double(n)));
+    const std::vector<Scalar> points{0, 0, s, 0, s, s, 0, s};
+    const std::vector<Index> segments{0, 1, 1, 2, 2, 3, 3, 0};
+
+    for (auto algorithm : bench::all_algorithms()) {
+        for (Scalar min_angle : {0, 20, 30}) {
+            // Mean triangle area is roughly half the max area: 2 and 8 yield ~n and ~n/4
+            // triangles.
+            for (Scalar max_area : {2, 8}) {
+                Config config;
+                config.verbose_level = 0;
+                config.min_angle = min_angle;
+                config.max_area = max_area;
+                config.algorithm = algorithm;
+
+                Engine engine;
+                engine.set_in_points(points.data(), 4);
+                engine.set_in_segments(segments.data(), 4);
+                const std::string name = "refine square " + size_label(n) + " " +
+                                         bench::algorithm_name(algorithm) + " q" +
+                                         std::to_string(static_cast<int>(min_angle)) + " a" +
+                                         std::to_string(static_cast<int>(max_area));
+                BENCHMARK(std::string(name))
+                {
+                    engine.run(config);
+                    return engine.get_out_triangles().rows();
+                };
+                bench::report_throughput(name, engine, config);
+            }
+        }
+    }
+}
+
+/**
+ * Benchmark refinement of a square domain into about `n` triangles with an increasing number of
+ * threads (see `Config::parallel_refinement`), without and with points clustered in a corner.
+ * Speedups are relative to the serial case.
+ */
+void bench_parallel_refinement(Index n)
+{
+    const Scalar s = static_cast<Scalar>(std::sqrt(double(n)));
+    const std::vector<Index> segments{0, 1, 1, 2, 2, 3, 3, 0};
+
+    for (const char* domain : {"square", "clustered"}) {
+        std::vector<Scalar> points{0, 0, s, 0, s, s, 0, s};
+        if (std::string(domain) == "clustered") {
+            for (Scalar x : bench::random_points(n / 100)) points.push_back(s * (x + 1) / 100);
+        }
+        const Index num_points = static_cast<Index>(points.size() / 2);
+
+        double serial_seconds = 0;
+        for (Index num_threads : {0, 2, 4, 8, 16}) {
+            Config config;
+            config.verbose_level = 0;
+            config.min_angle = 20;
+            config.max_area = 2;
+            config.parallel_refinement = num_threads > 0;
+            config.num_threads = num_threads;
+
+            Engine engine;
+            engine.set_in_points(points.data(), num_points);
+            engine.set_in_segments(segments.data(), 4);
+            const std::string name = "parallel refine " + std::string(domain) + " " +
+                                     size_label(n) + " " +
+                                     (num_threads > 0 ? "t" + std::to_string(num_threads)
+                                                      : std::string("serial"));
+            BENCHMARK(std::string(name))
+            {
+                engine.run(config);
+                return engine.get_out_triangles().rows();
+            };
+            bench::report_throughput(name, engine, config);
+
+            const RunStats& stats = engine.get_run_stats();
+            if (num_threads == 0) serial_seconds = stats.total_time;
+            std::printf("%-72s %10.2fx speedup  %d subdomains  %.0f%% in serial triangle runs\n",
+                name.c_str(),
+                serial_seconds / stats.total_time,
+                static_cast<int>(stats.num_subdomains),
+                100 *
+                    (stats.input_time + stats.delaunay_time + stats.segment_time +
+                        stats.hole_time + stats.quality_time + stats.output_time) /
+                    stats.total_time);
+        }
+    }
+}
+
+/**
+ * Benchmark PSLGs with k x k holes given as hole points, with and without quality refinement.
+ */
+void bench_holes(int k)
+{
+    bench::PerforatedPlate plate(k, 32);
+    for (auto algorithm : bench::all_algorithms()) {
+        for (Scalar min_angle : {0, 20}) {
+            Config config;
+            config.verbose_level = 0;
+            config.min_angle = min_angle;
+            config.algorithm = algorithm;
+
+            Engine engine;
+            engine.set_in_points(plate.points.data(), plate.num_points());
+            engine.set_in_segments(plate.segments.data(), plate.num_segments());
+            engine.set_in_holes(plate.hole_centers.data(), plate.num_holes());
+            const std::string name = "holes " + std::to_string(plate.num_holes()) + " " +
+                                     bench::algorithm_name(algorithm) + " q" +
+                                     std::to_string(static_cast<int>(min_angle));
+            BENCHMARK(std::string(name))
+            {
+                engine.run(config);
+                return engine.get_out_triangles().rows();
+            };
+            bench::report_throughput(name, engine, config);
+        }
+    }
+}
+
+/**
+ * Benchmark parallel Delaunay triangulation of point clouds with an increasing number of threads.
+ * Speedups are relative to the serial divide and conquer case.
+ */
+void bench_parallel(Index n)
+{
+    for (const auto& cloud : generate_point_clouds(n)) {
+        const Index num_points = static_cast<Index>(cloud.points.size() / 2);
+        for (Index num_threads : {0, 1, 2, 4, 8, 16}) {
+            Config config;
+            config.verbose_level = 0;
+            config.min_angle = 0;
+            config.output_flags = OUTPUT_POINTS | OUTPUT_TRIANGLES;
+            if (num_threads > 0) {
+                config.algorithm = Algorithm::PARALLEL_DIVIDE_AND_CONQUER;
+                config.num_threads = num_threads;
+            }
+
+            Engine engine;
+            engine.set_in_points(cloud.points.data(), num_points);
+            const std::string name = "parallel " + cloud.name + " " + size_label(n) + " " +
+                                     (num_threads > 0 ? "t" + std::to_string(num_threads)
+                                                      : std::string("serial"));
+            BENCHMARK(std::string(name))
+            {
+                engine.run(config);
+                return engine.get_out_triangles().rows();
+            };
+            bench::report_throughput(name, engine, config);
+        }
+    }
+}
+
+/**
+ * Benchmark triangulation of point clouds in input order and in Hilbert curve order (see
+ * `Config::spatial_sort`).  The incremental algorithm locates each point starting from the last
+ * triangle created, so it benefits the most from spatially coherent input.
+ */
+void bench_spatial_sort(Index n)
+{
+    for (const auto& cloud : generate_point_clouds(n)) {
+        const Index num_points = static_cast<Index>(cloud.points.size() / 2);
+        for (auto algorithm : {Algorithm::DIVIDE_AND_CONQUER, Algorithm::INCREMENTAL}) {
+            for (int mode = 0; mode < 3; mode++) {
+                Config config;
+                config.verbose_level = 0;
+                config.min_angle = 0;
+                config.algorithm = algorithm;
+                config.output_flags = OUTPUT_POINTS | OUTPUT_TRIANGLES;
+                config.spatial_sort = mode > 0;
+                config.keep_spatial_order = mode > 1;
+
+                Engine engine;
+                engine.set_in_points(cloud.points.data(), num_points);
+                const char* mode_names[] = {"unsorted", "sorted", "sorted kept"};
+                const std::string name = "spatial sort " + cloud.name + " " + size_label(n) +
+                                         " " + bench::algorithm_name(algorithm) + " " +
+                                         mode_names[mode];
+                BENCHMARK(std::string(name))
+                {
+                    engine.run(config);
+                    return engine.get_out_triangles().rows();
+                };
+                bench::report_throughput(name, engine, config);
+            }
+        }
+    }
+}
+
+/**
+ * Benchmark a timestep of an adaptive simulation on a mesh of `n` random points: inserting (and
+ * removing) 256 points with `Engine::insert_points`, versus triangulating again from scratch.
+ */
+void bench_incremental(Index n)
+{
+    const Index m = 256;
+    std::vector<Scalar> points = bench::random_points(n + m);
+    // Corners first, so that inserted points are inside the convex hull.
+    const Scalar corners[] = {0, 0, 1, 0, 1, 1, 0, 1};
+    std::copy(corners, corners + 8, points.begin());
+
+    Config config;
+    config.verbose_level = 0;
+    config.min_angle = 0;
+    config.output_flags = OUTPUT_POINTS | OUTPUT_TRIANGLES | OUTPUT_NEIGHBORS;
+
+    Engine rebuilt;
+    rebuilt.set_in_points(points.data(), n + m);
+    BENCHMARK("incremental " + size_label(n) + " rebuild")
+    {
+        rebuilt.run(config);
+        return rebuilt.get_out_triangles().rows();
+    };
+
+    Engine engine;
+    engine.set_in_points(points.data(), n);
+    engine.run(config);
+    BENCHMARK("incremental " + size_label(n) + " insert and remove")
+    {
+        engine.insert_points(points.data() + static_cast<size_t>(n) * 2, m);
+        for (Index i = n + m - 1; i >= n; i--) engine.remove_point(i);
+        return engine.get_out_triangles().rows();
+    };
+}
+
+/**
+ * Benchmark an adaptive remeshing step on a square domain meshed into about `n / 4` triangles:
+ * refining a window covering 1% of the domain with `Engine::refine_polygon`, versus refining the
+ * whole domain to the same resolution.
+ */
+void bench_local_refinement(Index n)
+{
+    const Scalar s = static_cast<Scalar>(std::sqrt(double(n)));
+    const std::vector<Scalar> points{0, 0, s, 0, s, s, 0, s};
+    const std::vector<Index> segments{0, 1, 1, 2, 2, 3, 3, 0};
+    const Scalar w = s / 10;
+    const std::vector<Scalar> window{w, w, 2 * w, w, 2 * w, 2 * w, w, 2 * w};
+
+    Config coarse;
+    coarse.verbose_level = 0;
+    coarse.max_area = 8;
+    Config fine = coarse;
+    fine.max_area = 0.5;
+
+    Engine engine;
+    engine.set_in_points(points.data(), 4);
+    engine.set_in_segments(segments.data(), 4);
+    BENCHMARK("local refinement " + size_label(n) + " coarse run")
+    {
+        engine.run(coarse);
+        return engine.get_out_triangles().rows();
+    };
+    BENCHMARK("local refinement " + size_label(n) + " coarse run + window")
+    {
+        engine.run(coarse);
+        return engine.refine_polygon(window.data(), 4, fine).added_triangles.size();
+    };
+    BENCHMARK("local refinement " + size_label(n) + " fine run")
+    {
+        engine.run(fine);
+        return engine.get_out_triangles().rows();
+    };
+}
+
+/**
+ * Benchmark out-of-core triangulation of `n` random points with `stream_delaunay`, versus
+ * `Engine::run` on the whole point set.  Triangles are counted and discarded.  The streaming case
+ * runs first so that its peak RSS is not masked by the in-memory one.
+ */
+void bench_streaming(Index n)
+{
+    struct CountingWriter : public TriangleWriter
+    {
+        void write_triangles(const LargeIndex*, Index count) override { num_triangles += count; }
+        LargeIndex num_triangles = 0;
+    };
+
+    const std::vector<Scalar> points = bench::random_points(n);
+    StreamingConfig streaming_config;
+    streaming_config.points_per_tile = std::max<Index>(1000, n / 64);
+    streaming_config.max_points_in_memory = n / 8;
+
+    const std::string name = "streaming " + size_label(n);
+    BENCHMARK(name + " stream_delaunay")
+    {
+        ArrayPointStream stream(points.data(), n);
+        CountingWriter writer;
+        return stream_delaunay(stream, writer, streaming_config);
+    };
+    std::printf("%-72s peak RSS %8.1f MB\n",
+        (name + " stream_delaunay").c_str(),
+        bench::peak_rss() / (1024.0 * 1024.0));
+
+    Config config;
+    config.verbose_level = 0;
+    config.min_angle = 0;
+    config.output_flags = OUTPUT_TRIANGLES;
+    Engine engine;
+    engine.set_in_points(points.data(), n);
+    BENCHMARK(name + " in memory")
+    {
+        engine.run(config);
+        return engine.get_out_triangles().rows();
+    };
+    bench::report_throughput(name + " in memory", engine, config);
+}
+
+/**
+ * Benchmark quality meshing of `n` random points with `TiledMesh` on tiles of about 1e4 points,
+ * versus a single `Engine`.
+ */
+void bench_tiling(Index n)
+{
+    const std::vector<Scalar> points = bench::random_points(n);
+    Config config;
+    config.verbose_level = 0;
+    config.max_area = static_cast<Scalar>(0.5 / n);
+    config.output_flags = OUTPUT_POINTS | OUTPUT_TRIANGLES;
+
+    Engine engine;
+    engine.set_in_points(points.data(), n);
+    const std::string name = "tiling " + size_label(n);
+    BENCHMARK(name + " single engine")
+    {
+        engine.run(config);
+        return engine.get_out_triangles().rows();
+    };
+
+    TilingConfig tiling_config;
+    tiling_config.points_per_tile = 10000;
+    TiledMesh tiles(points.data(), n, tiling_config);
+    BENCHMARK(name + " tiles")
+    {
+        tiles.run(config);
+        return tiles.get_num_tiles();
+    };
+    BENCHMARK(name + " tiles + weld")
+    {
+        tiles.run(config);
+        Matrix2Fr welded_points;
+        Matrix3Ir welded_triangles;
+        tiles.weld(welded_points, welded_triangles);
+        return welded_triangles.rows();
+    };
+}
+
+} // namespace
+
+TEST_CASE("Point clouds", "[benchmark][engine]")
+{
+    for (Index n : {1000, 10000, 100000}) {
+        bench_point_clouds(n);
+    }
+}
+
+TEST_CASE("Point clouds (large)", "[.][benchmark][engine][large]")
+{
+    for (Index n : {1000000, 10000000}) {
+        bench_point_clouds(n);
+    }
+}
+
+TEST_CASE("Parallel Delaunay", "[benchmark][engine][parallel]")
+{
+    bench_parallel(100000);
+}
+
+TEST_CASE("Parallel Delaunay (large)", "[.][benchmark][engine][parallel][large]")
+{
+    for (Index n : {1000000, 10000000}) {
+        bench_parallel(n);
+    }
+}
+
+TEST_CASE("Spatial sort", "[benchmark][engine]")
+{
+    bench_spatial_sort(100000);
+}
+
+TEST_CASE("Spatial sort (large)", "[.][benchmark][engine][large]")
+{
+    bench_spatial_sort(1000000);
+}
+
+TEST_CASE("Incremental updates", "[benchmark][engine][incremental]")
+{
+    for (Index n : {10000, 100000}) {
+        bench_incremental(n);
+    }
+}
+
+TEST_CASE("Incremental updates (large)", "[.][benchmark][engine][incremental][large]")
+{
+    bench_incremental(1000000);
+}
+
+TEST_CASE("Local refinement", "[benchmark][engine][incremental]")
+{
+    for (Index n : {10000, 100000}) {
+        bench_local_refinement(n);
+    }
+}
+
+TEST_CASE("Local refinement (large)", "[.][benchmark][engine][incremental][large]")
+{
+    bench_local_refinement(1000000);
+}
+
+TEST_CASE("Streaming Delaunay", "[benchmark][engine][streaming]")
+{
+    bench_streaming(100000);
+}
+
+TEST_CASE("Streaming Delaunay (large)", "[.][benchmark][engine][streaming][large]")
+{
+    for (Index n : {1000000, 10000000}) {
+        bench_streaming(n);
+    }
+}
+
+TEST_CASE("Tiled meshing", "[benchmark][engine][tiling]")
+{
+    bench_tiling(100000);
+}
+
+TEST_CASE("Tiled meshing (large)", "[.][benchmark][engine][tiling][large]")
+{
+    bench_tiling(1000000);
+}
+
+TEST_CASE("Refinement", "[benchmark][engine]")
+{
+    for (Index n : {1000, 10000, 100000}) {
+        bench_refinement(n);
+    }
+}
+
+TEST_CASE("Refinement (large)", "[.][benchmark][engine][large]")
+{
+    for (Index n : {1000000, 10000000}) {
+        bench_refinement(n);
+    }
+}
+
+TEST_CASE("Parallel refinement", "[benchmark][engine][parallel]")
+{
+    bench_parallel_refinement(100000);
+}
+
+TEST_CASE("Parallel refinement (large)", "[.][benchmark][engine][parallel][large]")
+{
+    for (Index n : {1000000, 10000000}) {
+        bench_parallel_refinement(n);
+    }
+}
+
+TEST_CASE("PSLG with holes", "[benchmark][engine][hole]")
+{
+    for (int k : {10, 30, 100}) {
+        bench_holes(k);
+    }
+}
+
+TEST_CASE("PSLG with holes (large)", "[.][benchmark][engine][hole][large]")
+{
+    // About 1e6 and 1e7 boundary points.
+    for (int k : {180, 560}) {
+        bench_holes(k);
+    }
+}
@@ -0,0 +1,115 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <trianglelite/trianglelite.h>
+
+#include "bench_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Output renumbering (see `Config::output_order`): cost of the run, and bandwidth of the vertex
+// adjacency matrix and mean index distance between consecutive triangles, both printed per case.
+
+namespace {
+
+using namespace trianglelite;
+
+const char* output_order_name(OutputOrder order)
+{
+    switch (order) {
+    case OutputOrder::DEFAULT: return "default";
+    case OutputOrder::HILBERT: return "hilbert";
+    case OutputOrder::REVERSE_CUTHILL_MCKEE: return "reverse_cuthill_mckee";
+    case OutputOrder::STRIP: return "strip";
+    }
+    return "unknown";
+}
+
+/**
+ * Print the bandwidth (max index difference over mesh edges) and the mean index difference over
+ * mesh edges, i.e. how far apart neighboring points are in memory, along with the mean number of
+ * points not shared between consecutive triangles.
+ */
+void report_locality(const std::string& name, const Engine& engine)
+{
+    const auto triangles = engine.get_out_triangles();
+    Index bandwidth = 0;
+    double total_span = 0;
+    Index num_changed = 0;
+    for (Index t = 0; t < triangles.rows(); t++) {
+        for (Index j = 0; j < 3; j++) {
+            const Index span = std::abs(triangles(t, j) - triangles(t, (j + 1) % 3));
+            bandwidth = std::max(bandwidth, span);
+            total_span += span;
+        }
+        if (t == 0) continue;
+        for (Index j = 0; j < 3; j++) {
+            const auto previous = triangles.row(t - 1);
+            if (std::find(previous.data(), previous.data() + 3, triangles(t, j)) ==
+                previous.data() + 3) {
+                num_changed++;
+            }
+        }
+    }
+    const double num_edges = std::max<double>(1, triangles.rows() * 3.0);
+    std::printf("%-60s bandwidth %10ld  mean span %12.1f  new points/triangle %.2f\n",
+        name.c_str(),
+        static_cast<long>(bandwidth),
+        total_span / num_edges,
+        triangles.rows() > 1 ? double(num_changed) / (triangles.rows() - 1) : 0.0);
+    std::fflush(stdout);
+}
+
+/**
+ * Quality mesh of a square with about `n` triangles, renumbered with each ordering.
+ */
+void bench_output_order(Index n)
+{
+    const Scalar s = static_cast<Scalar>(std::sqrt(double(n)));
+    const std::vector<Scalar> points{0, 0, s, 0, s, s, 0, s};
+    const std::vector<Index> segments{0, 1, 1, 2, 2, 3, 3, 0};
+
+    for (auto order : {OutputOrder::DEFAULT,
+             OutputOrder::HILBERT,
+             OutputOrder::REVERSE_CUTHILL_MCKEE,
+             OutputOrder::STRIP}) {
+        Config config;
+        config.verbose_level = 0;
+        config.min_angle = 20;
+        config.max_area = 2;
+        config.output_order = order;
+
+        Engine engine;
+        engine.set_in_points(points.data(), 4);
+        engine.set_in_segments(segments.data(), 4);
+        const std::string name = "output order square 1e" +
+                                 std::to_string(static_cast<int>(std::lround(std::log10(n)))) +
+                                 " " + output_order_name(order);
+        BENCHMARK(std::string(name))
+        {
+            engine.run(config);
+            return engine.get_out_triangles().rows();
+        };
+        engine.run(config);
+        report_locality(name, engine);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Output order", "[benchmark][order]")
+{
+    for (Index n : {10000, 100000}) {
+        bench_output_order(n);
+    }
+}
+
+TEST_CASE("Output order (large)", "[.][benchmark][order][large]")
+{
+    bench_output_order(1000000);
+}
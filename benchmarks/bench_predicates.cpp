@@ -0,0 +1,96 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "bench_utils.h"
+#include "predicates.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Throughput of the exact predicates on a single core, one call per query versus batches (see
+// `predicates::orient2d_batch`).  Random points are certified by the floating point filter, while
+// points on a line are degenerate for both predicates and go through exact arithmetic.
+
+namespace {
+
+using namespace trianglelite;
+
+/**
+ * Time `fn` (which evaluates `num_queries` predicates) once more and print its throughput.
+ */
+template <typename Fn>
+void report_predicates(const std::string& name, Index num_queries, const Fn& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    std::printf("%-72s %10.1f Mpred/s\n",
+        name.c_str(),
+        seconds > 0 ? num_queries / seconds * 1e-6 : 0.0);
+    std::fflush(stdout);
+}
+
+void bench_predicates(const std::string& input, const std::vector<Scalar>& points)
+{
+    const Index n = static_cast<Index>(points.size() / 2);
+    // Fixed triangle from the input, and every point as the query.
+    const Scalar* a = points.data();
+    const Scalar* b = points.data() + (n / 3) * 2;
+    const Scalar* c = points.data() + (2 * n / 3) * 2;
+    std::vector<int> signs(n);
+    std::vector<int> expected(n);
+
+    auto orient2d_scalar = [&]() {
+        for (Index i = 0; i < n; i++) signs[i] = predicates::orient2d(a, b, points.data() + i * 2);
+        return signs[n - 1];
+    };
+    auto orient2d_batch = [&]() {
+        predicates::orient2d_batch(a, b, points.data(), n, signs.data());
+        return signs[n - 1];
+    };
+    auto incircle_scalar = [&]() {
+        for (Index i = 0; i < n; i++) {
+            signs[i] = predicates::incircle(a, b, c, points.data() + i * 2);
+        }
+        return signs[n - 1];
+    };
+    auto incircle_batch = [&]() {
+        predicates::incircle_batch(a, b, c, points.data(), n, signs.data());
+        return signs[n - 1];
+    };
+
+    // Batches give the same results as single calls.
+    orient2d_scalar();
+    expected = signs;
+    orient2d_batch();
+    REQUIRE(signs == expected);
+    incircle_scalar();
+    expected = signs;
+    incircle_batch();
+    REQUIRE(signs == expected);
+
+    const std::string name = "predicates " + input + " ";
+    BENCHMARK(name + "orient2d") { return orient2d_scalar(); };
+    report_predicates(name + "orient2d", n, orient2d_scalar);
+    BENCHMARK(name + "orient2d batch") { return orient2d_batch(); };
+    report_predicates(name + "orient2d batch", n, orient2d_batch);
+    BENCHMARK(name + "incircle") { return incircle_scalar(); };
+    report_predicates(name + "incircle", n, incircle_scalar);
+    BENCHMARK(name + "incircle batch") { return incircle_batch(); };
+    report_predicates(name + "incircle batch", n, incircle_batch);
+}
+
+} // namespace
+
+TEST_CASE("Predicates", "[benchmark][predicates]")
+{
+    const Index n = 1 << 20;
+    bench_predicates("random", bench::random_points(n));
+
+    std::vector<Scalar> line = bench::random_points(n);
+    for (Index i = 0; i < n; i++) line[i * 2 + 1] = line[i * 2];
+    bench_predicates("collinear", line);
+}
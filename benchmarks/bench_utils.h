@@ -0,0 +1,183 @@
+#pragma once
+
+#include <trianglelite/trianglelite.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+// clang-format off
+#include <windows.h>
+#include <psapi.h>
+// clang-format on
+#else
+#include <sys/resource.h>
+#endif
+
+namespace bench {
+
+using trianglelite::Index;
+using trianglelite::Scalar;
+
+/**
+ * Uniformly distributed random points in the unit square.
+ */
+inline std::vector<Scalar> random_points(Index n, unsigned int seed = 0)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    std::vector<Scalar> points(static_cast<size_t>(n) * 2);
+    for (auto& v : points) v = static_cast<Scalar>(dist(gen));
+    return points;
+}
+
+/**
+ * Regular grid of about n points in the unit square.  Grids are highly degenerate (every cell is
+ * cocircular), which stresses the exact predicates.
+ */
+inline std::vector<Scalar> grid_points(Index n)
+{
+    const Index k = std::max<Index>(2, static_cast<Index>(std::lround(std::sqrt(double(n)))));
+    std::vector<Scalar> points;
+    points.reserve(static_cast<size_t>(k) * k * 2);
+    for (Index i = 0; i < k; i++) {
+        for (Index j = 0; j < k; j++) {
+            points.push_back(static_cast<Scalar>(i) / (k - 1));
+            points.push_back(static_cast<Scalar>(j) / (k - 1));
+        }
+    }
+    return points;
+}
+
+/**
+ * Points drawn from a mixture of small Gaussian clusters, i.e. highly non-uniform density.
+ */
+inline std::vector<Scalar> clustered_points(Index n, unsigned int seed = 0)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const Index num_clusters = std::max<Index>(1, n / 1000);
+    std::vector<double> centers(static_cast<size_t>(num_clusters) * 2);
+    for (auto& v : centers) v = uniform(gen);
+
+    std::normal_distribution<double> normal(0.0, 0.01);
+    std::uniform_int_distribution<Index> pick(0, num_clusters - 1);
+    std::vector<Scalar> points(static_cast<size_t>(n) * 2);
+    for (Index i = 0; i < n; i++) {
+        const Index c = pick(gen);
+        points[i * 2] = static_cast<Scalar>(centers[c * 2] + normal(gen));
+        points[i * 2 + 1] = static_cast<Scalar>(centers[c * 2 + 1] + normal(gen));
+    }
+    return points;
+}
+
+/**
+ * Unit square plate with a k x k grid of circular holes, each approximated by an n-gon.  The outer
+ * boundary is counterclockwise and the holes are clockwise.
+ */
+struct PerforatedPlate
+{
+    std::vector<Scalar> points;
+    std::vector<Index> segments;
+    std::vector<Scalar> hole_centers;
+
+    PerforatedPlate(int k, int n)
+    {
+        const Scalar corners[] = {0, 0, 1, 0, 1, 1, 0, 1};
+        points.assign(corners, corners + 8);
+        segments = {0, 1, 1, 2, 2, 3, 3, 0};
+
+        const double pi = std::acos(-1.0);
+        const double cell = 1.0 / k;
+        const double radius = 0.3 * cell;
+        for (int i = 0; i < k; i++) {
+            for (int j = 0; j < k; j++) {
+                const double cx = (i + 0.5) * cell;
+                const double cy = (j + 0.5) * cell;
+                const Index base = static_cast<Index>(points.size() / 2);
+                for (int l = 0; l < n; l++) {
+                    const double theta = -2 * pi * l / n;
+                    points.push_back(static_cast<Scalar>(cx + radius * std::cos(theta)));
+                    points.push_back(static_cast<Scalar>(cy + radius * std::sin(theta)));
+                    segments.push_back(base + l);
+                    segments.push_back(base + (l + 1) % n);
+                }
+                hole_centers.push_back(static_cast<Scalar>(cx));
+                hole_centers.push_back(static_cast<Scalar>(cy));
+            }
+        }
+    }
+
+    Index num_points() const { return static_cast<Index>(points.size() / 2); }
+    Index num_segments() const { return static_cast<Index>(segments.size() / 2); }
+    Index num_holes() const { return static_cast<Index>(hole_centers.size() / 2); }
+};
+
+inline const char* algorithm_name(trianglelite::Algorithm algorithm)
+{
+    switch (algorithm) {
+    case trianglelite::Algorithm::DIVIDE_AND_CONQUER: return "divide_and_conquer";
+    case trianglelite::Algorithm::SWEEPLINE: return "sweepline";
+    case trianglelite::Algorithm::INCREMENTAL: return "incremental";
+    case trianglelite::Algorithm::PARALLEL_DIVIDE_AND_CONQUER: return "parallel_divide_and_conquer";
+    }
+    return "unknown";
+}
+
+inline std::vector<trianglelite::Algorithm> all_algorithms()
+{
+    return {trianglelite::Algorithm::DIVIDE_AND_CONQUER,
+        trianglelite::Algorithm::SWEEPLINE,
+        trianglelite::Algorithm::INCREMENTAL};
+}
+
+/**
+ * Peak resident set size of the process so far, in bytes (0 if unavailable).
+ */
+inline size_t peak_rss()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<size_t>(counters.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss); // Bytes.
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024; // Kilobytes.
+#endif
+#endif
+}
+
+/**
+ * Time a single call to `engine.run(config)` and print a throughput line.  Catch2 only reports
+ * timings, so triangles/sec and peak RSS are printed separately.  Peak RSS is process wide and
+ * never decreases, so cases are swept from small to large.
+ */
+inline void report_throughput(
+    const std::string& name, trianglelite::Engine& engine, const trianglelite::Config& config)
+{
+    const auto start = std::chrono::steady_clock::now();
+    engine.run(config);
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    const auto num_triangles = engine.get_out_triangles().rows();
+    std::printf("%-72s %10ld triangles %10.3f Mtri/s  peak RSS %8.1f MB\n",
+        name.c_str(),
+        static_cast<long>(num_triangles),
+        seconds > 0 ? num_triangles / seconds * 1e-6 : 0.0,
+        peak_rss() / (1024.0 * 1024.0));
+    std::fflush(stdout);
+}
+
+} // namespace bench
@@ -11,7 +11,90 @@ CPMAddPackage(
     GIT_TAG           6bbd92c7ddd6c803c403e005e1132eadb38fbe68
 )
 
+# Triangle keeps its exact arithmetic constants (set by `exactinit()`) and its random seed in
+# global variables, so concurrent `triangulate()` calls race on them.  We compile a patched copy of
+# `triangle.c` where these globals are thread-local.  The `plus1mod3`/`minus1mod3` tables are only
+# ever read, so they are left untouched.
+set(TRIANGLE_ORIGINAL_SOURCE "${triangle_SOURCE_DIR}/triangle.c")
+set(TRIANGLE_PATCHED_SOURCE "${CMAKE_CURRENT_BINARY_DIR}/triangle/triangle.c")
+set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS "${TRIANGLE_ORIGINAL_SOURCE}")
+
+file(READ "${TRIANGLE_ORIGINAL_SOURCE}" TRIANGLE_CONTENT)
+string(REGEX REPLACE
+    "\nREAL (splitter|epsilon|resulterrbound|ccwerrboundA|iccerrboundA|o3derrboundA)"
+    "\nTRI_THREAD_LOCAL REAL \\1"
+    TRIANGLE_CONTENT "${TRIANGLE_CONTENT}")
+string(REGEX REPLACE
+    "\nunsigned long randomseed;"
+    "\nTRI_THREAD_LOCAL unsigned long randomseed;"
+    TRIANGLE_CONTENT "${TRIANGLE_CONTENT}")
+foreach(symbol splitter epsilon resulterrbound ccwerrboundA iccerrboundA o3derrboundA)
+    string(FIND "${TRIANGLE_CONTENT}" "TRI_THREAD_LOCAL REAL ${symbol}" symbol_pos)
+    if (symbol_pos EQUAL -1)
+        message(FATAL_ERROR "Unable to make Triangle's global '${symbol}' thread-local.")
+    endif()
+endforeach()
+string(FIND "${TRIANGLE_CONTENT}" "TRI_THREAD_LOCAL unsigned long randomseed" symbol_pos)
+if (symbol_pos EQUAL -1)
+    message(FATAL_ERROR "Unable to make Triangle's global 'randomseed' thread-local.")
+endif()
+
+# Let an `OutputSink` provide the output vertex and triangle arrays.  Triangle only allocates them
+# if they are null, so the hook runs right before that check, once the final counts are known.
+string(REGEX REPLACE
+    "\n([ \t]*)if \\(\\*pointlist == \\(REAL \\*\\) NULL\\)"
+    "\n\\1trianglelite_output_hook(TRIANGLELITE_OUTPUT_POINTS, outvertices, (void **) pointlist);\n\\1if (*pointlist == (REAL *) NULL)"
+    TRIANGLE_CONTENT "${TRIANGLE_CONTENT}")
+string(REGEX REPLACE
+    "\n([ \t]*)if \\(\\*trianglelist == \\(int \\*\\) NULL\\)"
+    "\n\\1trianglelite_output_hook(TRIANGLELITE_OUTPUT_TRIANGLES, m->triangles.items, (void **) trianglelist);\n\\1if (*trianglelist == (int *) NULL)"
+    TRIANGLE_CONTENT "${TRIANGLE_CONTENT}")
+foreach(kind POINTS TRIANGLES)
+    string(FIND "${TRIANGLE_CONTENT}" "trianglelite_output_hook(TRIANGLELITE_OUTPUT_${kind}" hook_pos)
+    if (hook_pos EQUAL -1)
+        message(FATAL_ERROR "Unable to insert the output hook for ${kind} into Triangle.")
+    endif()
+endforeach()
+
+# Report the phases of `triangulate()` to `RunStatsScope`: once triangle is initialized, and right
+# before each of the (optional) timers that mark the end of a phase, so that the hooks do not
+# depend on `NO_TIMER` or on the quiet switch.  Predicates report their exact fallbacks.
+string(REGEX REPLACE
+    "\n([ \t]*)triangleinit\\(&m\\);"
+    "\n\\1triangleinit(&m);\n\\1trianglelite_phase_hook(0, 0, 0);"
+    TRIANGLE_CONTENT "${TRIANGLE_CONTENT}")
+string(REGEX REPLACE
+    "\n#ifndef NO_TIMER\n([ \t]*)if \\(!b\\.quiet\\) {\n([ \t]*)gettimeofday\\(&tv([1-6]), &tz\\);"
+    "\n\\1trianglelite_phase_hook(\\3, m.counterclockcount, m.incirclecount);\n#ifndef NO_TIMER\n\\1if (!b.quiet) {\n\\2gettimeofday(&tv\\3, &tz);"
+    TRIANGLE_CONTENT "${TRIANGLE_CONTENT}")
+string(REGEX REPLACE
+    "\n([ \t]*)return counterclockwiseadapt\\("
+    "\n\\1trianglelite_exact_hook(TRIANGLELITE_EXACT_ORIENT2D);\n\\1return counterclockwiseadapt("
+    TRIANGLE_CONTENT "${TRIANGLE_CONTENT}")
+string(REGEX REPLACE
+    "\n([ \t]*)return incircleadapt\\("
+    "\n\\1trianglelite_exact_hook(TRIANGLELITE_EXACT_INCIRCLE);\n\\1return incircleadapt("
+    TRIANGLE_CONTENT "${TRIANGLE_CONTENT}")
+foreach(phase 0 1 2 3 4 5 6)
+    string(FIND "${TRIANGLE_CONTENT}" "trianglelite_phase_hook(${phase}," hook_pos)
+    if (hook_pos EQUAL -1)
+        message(FATAL_ERROR "Unable to insert the hook of phase ${phase} into Triangle.")
+    endif()
+endforeach()
+foreach(predicate ORIENT2D INCIRCLE)
+    string(FIND "${TRIANGLE_CONTENT}" "trianglelite_exact_hook(TRIANGLELITE_EXACT_${predicate})" hook_pos)
+    if (hook_pos EQUAL -1)
+        message(FATAL_ERROR "Unable to insert the exact arithmetic hook for ${predicate} into Triangle.")
+    endif()
+endforeach()
+
+file(WRITE "${TRIANGLE_PATCHED_SOURCE}.tmp"
+    "#include <triangle_prelude.h>\n${TRIANGLE_CONTENT}")
+configure_file("${TRIANGLE_PATCHED_SOURCE}.tmp" "${TRIANGLE_PATCHED_SOURCE}" COPYONLY)
+set_property(TARGET triangle PROPERTY SOURCES "${TRIANGLE_PATCHED_SOURCE}")
+
 target_include_directories(triangle PUBLIC ${triangle_SOURCE_DIR})
+target_include_directories(triangle PRIVATE "${PROJECT_SOURCE_DIR}/src")
 target_compile_definitions(triangle PRIVATE -DANSI_DECLARATORS)
 if (MSVC)
     target_compile_options(triangle PRIVATE
@@ -23,3 +106,65 @@ if (MSVC)
         )
 endif()
 add_library(triangle::triangle ALIAS triangle)
+
+# Single precision copy of Triangle for `trianglelite::f32` (see `cmake/trianglelite_f32.cmake`).
+# Its external symbols, i.e. the functions and globals defined at file scope and the hooks it
+# calls, are prefixed with `trianglelite_f32_` so that both copies link into the same binary.
+if (TRIANGLELITE_F32)
+    set(TRIANGLE_F32_SYMBOLS
+        splitter epsilon resulterrbound ccwerrboundA ccwerrboundB ccwerrboundC iccerrboundA
+        iccerrboundB iccerrboundC o3derrboundA o3derrboundB o3derrboundC randomseed plus1mod3
+        minus1mod3)
+    string(REGEX MATCHALL "\n[A-Za-z_][A-Za-z0-9_ ]*[ *]+[A-Za-z_][A-Za-z0-9_]*\\("
+        TRIANGLE_DECLARATIONS "${TRIANGLE_CONTENT}")
+    foreach(declaration ${TRIANGLE_DECLARATIONS})
+        string(REGEX REPLACE ".*[ *]([A-Za-z_][A-Za-z0-9_]*)\\($" "\\1" symbol "${declaration}")
+        if (NOT symbol MATCHES "^(if|while|for|switch|return|sizeof|main)$")
+            list(APPEND TRIANGLE_F32_SYMBOLS ${symbol})
+        endif()
+    endforeach()
+    list(REMOVE_DUPLICATES TRIANGLE_F32_SYMBOLS)
+    foreach(symbol triangulate trifree exactinit triangleinit counterclockwise incircle)
+        list(FIND TRIANGLE_F32_SYMBOLS ${symbol} symbol_pos)
+        if (symbol_pos EQUAL -1)
+            message(FATAL_ERROR "Unable to find Triangle's function '${symbol}'.")
+        endif()
+    endforeach()
+
+    # Symbols shared with the C++ side, which is compiled with the same renaming.
+    list(REMOVE_ITEM TRIANGLE_F32_SYMBOLS triangulate trifree)
+    set(TRIANGLE_F32_EXPORTS
+        triangulate=trianglelite_f32_triangulate
+        trifree=trianglelite_f32_trifree)
+    foreach(hook malloc calloc realloc free output_hook phase_hook exact_hook)
+        list(APPEND TRIANGLE_F32_EXPORTS trianglelite_${hook}=trianglelite_f32_${hook})
+    endforeach()
+
+    set(TRIANGLE_F32_RENAMES "")
+    foreach(symbol ${TRIANGLE_F32_SYMBOLS})
+        string(APPEND TRIANGLE_F32_RENAMES "#define ${symbol} trianglelite_f32_${symbol}\n")
+    endforeach()
+    foreach(export ${TRIANGLE_F32_EXPORTS})
+        string(REPLACE "=" " " export "${export}")
+        string(APPEND TRIANGLE_F32_RENAMES "#define ${export}\n")
+    endforeach()
+
+    # System headers come first so that the renaming does not reach them.
+    set(TRIANGLE_F32_SOURCE "${CMAKE_CURRENT_BINARY_DIR}/triangle/triangle_f32.c")
+    file(WRITE "${TRIANGLE_F32_SOURCE}.tmp"
+        "#include <math.h>\n#include <stdio.h>\n#include <stdlib.h>\n#include <string.h>\n"
+        "#ifndef NO_TIMER\n#include <sys/time.h>\n#endif\n"
+        "${TRIANGLE_F32_RENAMES}"
+        "#include <triangle_prelude.h>\n${TRIANGLE_CONTENT}")
+    configure_file("${TRIANGLE_F32_SOURCE}.tmp" "${TRIANGLE_F32_SOURCE}" COPYONLY)
+
+    add_library(triangle_f32 STATIC "${TRIANGLE_F32_SOURCE}")
+    target_include_directories(triangle_f32 PUBLIC ${triangle_SOURCE_DIR})
+    target_include_directories(triangle_f32 PRIVATE "${PROJECT_SOURCE_DIR}/src")
+    target_compile_definitions(triangle_f32
+        PUBLIC -DSINGLE $<TARGET_PROPERTY:triangle,INTERFACE_COMPILE_DEFINITIONS>
+        PRIVATE $<TARGET_PROPERTY:triangle,COMPILE_DEFINITIONS>
+        INTERFACE ${TRIANGLE_F32_EXPORTS})
+    target_compile_options(triangle_f32 PRIVATE $<TARGET_PROPERTY:triangle,COMPILE_OPTIONS>)
+    set_target_properties(triangle_f32 PROPERTIES POSITION_INDEPENDENT_CODE ON)
+endif()
@@ -0,0 +1,59 @@
+if (TARGET trianglelite::f32)
+    return()
+endif()
+
+if (NOT TARGET triangle_f32)
+    message(FATAL_ERROR "trianglelite::f32 requires the single precision copy of Triangle.")
+endif()
+
+# Single precision copy of the library, so that float and double meshing coexist in one binary.
+# The sources are compiled a second time with `Scalar = float`, in namespace `trianglelite_f32`
+# (aliased as `trianglelite::f32`), against `triangle_f32`.
+#
+# Its public headers are generated from ours as `<trianglelite/f32/*.h>`, with the same renaming,
+# so that both sets can be included in the same translation unit.
+set(TRIANGLELITE_F32_INCLUDE_DIR "${CMAKE_CURRENT_BINARY_DIR}/f32/include")
+foreach(header ${INC_FILES})
+    get_filename_component(header_name "${header}" NAME)
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS "${header}")
+    file(READ "${header}" HEADER_CONTENT)
+    string(REPLACE "#include <trianglelite/" "#include <trianglelite/f32/"
+        HEADER_CONTENT "${HEADER_CONTENT}")
+    string(REGEX REPLACE "([^A-Za-z0-9_])trianglelite([^A-Za-z0-9_/])" "\\1trianglelite_f32\\2"
+        HEADER_CONTENT "${HEADER_CONTENT}")
+    if (header_name STREQUAL "common.h")
+        set(SCALAR_DEFINITION
+            "#ifdef TRIANGLELITE_SINGLE\nusing Scalar = float;\n#else\nusing Scalar = double;\n#endif")
+        string(FIND "${HEADER_CONTENT}" "${SCALAR_DEFINITION}" scalar_pos)
+        if (scalar_pos EQUAL -1)
+            message(FATAL_ERROR "Unable to find the definition of Scalar in common.h.")
+        endif()
+        string(REPLACE "${SCALAR_DEFINITION}" "using Scalar = float;"
+            HEADER_CONTENT "${HEADER_CONTENT}")
+        string(APPEND HEADER_CONTENT
+            "\nnamespace trianglelite {\nnamespace f32 = ::trianglelite_f32;\n}\n")
+    endif()
+    set(F32_HEADER_TMP "${CMAKE_CURRENT_BINARY_DIR}/f32/${header_name}.tmp")
+    file(WRITE "${F32_HEADER_TMP}" "${HEADER_CONTENT}")
+    configure_file("${F32_HEADER_TMP}"
+        "${TRIANGLELITE_F32_INCLUDE_DIR}/trianglelite/f32/${header_name}" COPYONLY)
+endforeach()
+
+add_library(trianglelite_f32 STATIC ${SRC_FILES})
+target_link_libraries(trianglelite_f32 PUBLIC Eigen3::Eigen PRIVATE triangle_f32 Threads::Threads)
+target_include_directories(trianglelite_f32 PUBLIC "${TRIANGLELITE_F32_INCLUDE_DIR}")
+target_include_directories(trianglelite_f32 PRIVATE "${PROJECT_SOURCE_DIR}/include/")
+target_compile_definitions(trianglelite_f32 PRIVATE
+    -Dtrianglelite=trianglelite_f32
+    -DTRIANGLELITE_SINGLE
+    -DEIGEN_NO_MALLOC)
+set_target_properties(trianglelite_f32 PROPERTIES POSITION_INDEPENDENT_CODE ON)
+if (TRIANGLELITE_MSHIO)
+    target_compile_definitions(trianglelite_f32 PRIVATE -DWITH_MSHIO)
+    target_link_libraries(trianglelite_f32 PRIVATE mshio::mshio)
+endif()
+if (MSVC)
+    target_compile_definitions(trianglelite_f32 PRIVATE -D_USE_MATH_DEFINES)
+endif()
+
+add_library(trianglelite::f32 ALIAS trianglelite_f32)
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <trianglelite/Config.h>
+#include <trianglelite/Engine.h>
+#include <trianglelite/common.h>
+
+namespace trianglelite {
+
+/**
+ * Run a batch of independent triangulation jobs across a pool of threads.
+ *
+ * Each job is an `Engine` whose input has already been set.  Outputs are stored in the
+ * corresponding engine, exactly as if `engine.run(config)` was called on each of them.  Jobs are
+ * dispatched largest-first (by input size) so that a single large job does not end up as the
+ * tail of the batch.
+ *
+ * If any job throws, the remaining jobs are still run and the first exception is rethrown once
+ * the whole batch is done.
+ *
+ * @param engines      Array of engines, one per job.
+ * @param num_engines  Number of engines.
+ * @param config       Configuration shared by all jobs.
+ * @param num_threads  Number of worker threads.  Non-positive value means using all hardware
+ *                     threads.
+ */
+void run_batch(Engine* engines, Index num_engines, const Config& config, Index num_threads = 0);
+
+} // namespace trianglelite
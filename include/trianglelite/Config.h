@@ -7,7 +7,35 @@ namespace trianglelite {
 enum class Algorithm {
     DIVIDE_AND_CONQUER, // Default algorithm.
     SWEEPLINE, // Steven Fortune's sweepline algorithm (-F option)
-    INCREMENTAL // Incremental algorithm (-i options).
+    INCREMENTAL, // Incremental algorithm (-i options).
+    // Multi-threaded divide and conquer for large point clouds.  Inputs with segments or
+    // triangles, and small point clouds, are triangulated serially with `DIVIDE_AND_CONQUER`.
+    PARALLEL_DIVIDE_AND_CONQUER
+};
+
+/**
+ * Numbering of the output points and triangles.  Orderings other than `DEFAULT` renumber the input
+ * points as well.
+ */
+enum class OutputOrder {
+    DEFAULT, // Triangle's own order, input points first.
+    HILBERT, // Points, and triangles by centroid, along a Hilbert curve.
+    REVERSE_CUTHILL_MCKEE, // Points by reverse Cuthill-McKee, triangles by their first point.
+    STRIP // Triangles in strips of adjacent triangles, points by first use.
+};
+
+/**
+ * Bit flags selecting which output arrays are generated.  Arrays that are not selected are never
+ * allocated and their `get_out_*` accessors return empty maps.
+ */
+enum OutputFlag : int {
+    OUTPUT_POINTS = 1 << 0, // get_out_points()
+    OUTPUT_TRIANGLES = 1 << 1, // get_out_triangles()
+    OUTPUT_SEGMENTS = 1 << 2, // get_out_segments()
+    OUTPUT_EDGES = 1 << 3, // get_out_edges()
+    OUTPUT_NEIGHBORS = 1 << 4, // get_out_triangle_neighbors()
+    OUTPUT_MARKERS = 1 << 5, // get_out_point_markers(), get_out_segment/edge_markers()
+    OUTPUT_ALL = (1 << 6) - 1
 };
 
 struct Config
@@ -22,6 +50,15 @@ struct Config
     bool exact = true; // Use exact arithmetic.
     bool split_boundary = true; // Allow splitting of boundary.
     bool auto_hole_detection = false; // Auto hole detection using winding number.
+    bool auto_hole_reuse_mesh = false; // Refine the hole detection mesh instead of remeshing.
+    bool voronoi = false; // Compute the Voronoi diagram.
+    int output_flags = OUTPUT_ALL; // Bitwise or of `OutputFlag`s.
+    bool reuse_buffers = false; // Recycle Triangle's memory across runs of the same Engine.
+    Index num_threads = 0; // Threads of parallel algorithms, non-positive means all.
+    bool parallel_refinement = false; // Refine PSLGs in parallel subdomains (see num_threads).
+    bool spatial_sort = false; // Insert points in Hilbert curve order, output in input order.
+    bool keep_spatial_order = false; // With spatial_sort, output in Hilbert curve order instead.
+    OutputOrder output_order = OutputOrder::DEFAULT; // Renumbering of the output.
 };
 
 } // namespace triangle
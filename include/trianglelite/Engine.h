@@ -3,20 +3,77 @@
 #include <Eigen/Core>
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <trianglelite/Config.h>
+#include <trianglelite/OutputSink.h>
 #include <trianglelite/common.h>
 
 struct triangulateio; // Data structure defined by triangle.
 
 namespace trianglelite {
 
+class BufferCache;
+class LiveMesh;
+struct Partition;
+struct SegmentMesh;
+
+/**
+ * Changes made to the output by a local refinement (see `Engine::refine_triangles`).  Removed
+ * triangles hand their indices over to added triangles first, so an index can appear in both
+ * lists.  All other triangles and points are left untouched.
+ */
+struct RefinementDelta
+{
+    std::vector<Index> removed_triangles; // Triangles replaced by the refinement.
+    std::vector<Index> added_triangles; // Triangles created by the refinement.
+    std::vector<Index> added_points; // Points created by the refinement, appended.
+};
+
+/**
+ * Statistics of the last `Engine::run`, to monitor performance.
+ *
+ * Phases are those of triangle, summed over its runs (e.g. the constrained triangulation of auto
+ * hole detection, then the final mesh).  Work done concurrently by the parallel algorithms
+ * (`Algorithm::PARALLEL_DIVIDE_AND_CONQUER`, `Config::parallel_refinement`) only counts toward
+ * `total_time`.
+ */
+struct RunStats
+{
+    // Wall time of each phase of triangle in seconds.
+    double input_time = 0; // Building triangle's mesh from the input.
+    double delaunay_time = 0; // Delaunay triangulation, or reconstruction of an input mesh.
+    double segment_time = 0; // Insertion of segments.
+    double hole_time = 0; // Carving of holes and concavities.
+    double quality_time = 0; // Quality refinement.
+    double output_time = 0; // Writing of the output arrays.
+
+    // Wall time of each step of auto hole detection in seconds, triangle phases included.
+    double auto_hole_triangulation_time = 0; // Constrained triangulation of the input.
+    double auto_hole_region_time = 0; // Flood fill of the regions bounded by segments.
+    double auto_hole_winding_time = 0; // Winding numbers of the regions.
+    double auto_hole_extraction_time = 0; // Hole points, and the mesh kept for reuse.
+
+    double total_time = 0; // Wall time of the whole run in seconds.
+
+    Index num_triangle_runs = 0; // Calls to triangle.
+    LargeIndex num_orient2d = 0; // Orientation tests made by triangle.
+    LargeIndex num_incircle = 0; // In-circle tests made by triangle.
+    LargeIndex num_exact_orient2d = 0; // Orientation tests left undecided by the float filter.
+    LargeIndex num_exact_incircle = 0; // In-circle tests left undecided by the float filter.
+    Index num_steiner_points = 0; // Output points that are not input points.
+    Index num_subdomains = 0; // Parts meshed concurrently by a parallel algorithm, 0 if serial.
+    size_t peak_memory = 0; // Peak bytes allocated by a triangle run (pools and output arrays).
+};
+
 class Engine
 {
 public:
     Engine();
     ~Engine();
+    Engine(Engine&&);
+    Engine& operator=(Engine&&);
 
 public:
     //================== Input Geometry ========================
@@ -100,23 +157,252 @@ public:
 
     const Matrix1IMap get_out_edge_markers() const;
 
+    /**
+     * Shared ownership of the current output arrays (including the Voronoi
+     * diagram).  While any copy of the returned pointer is alive, the arrays
+     * behind the current `get_out_*` and `get_voronoi_*` maps stay valid,
+     * even after the engine is run again or destroyed.  The next run then
+     * writes into new arrays instead of recycling these ones.
+     */
+    std::shared_ptr<const void> get_out_owner() const;
+
+public:
+    //================== Voronoi Diagram ========================
+    // Only available if `Config::voronoi` is set.
+
+    /**
+     * Voronoi vertices, i.e. circumcenters of the output triangles.
+     */
+    const Matrix2FrMap get_voronoi_points() const;
+
+    /**
+     * Voronoi edges.  An edge with -1 as its second vertex is an infinite ray starting from its
+     * first vertex, whose direction is given by `get_voronoi_normals()`.
+     */
+    const Matrix2IrMap get_voronoi_edges() const;
+
+    /**
+     * Direction of infinite Voronoi rays.  One row per Voronoi edge, zero for finite edges.
+     */
+    const Matrix2FrMap get_voronoi_normals() const;
+
 public:
     void run(const Config& config);
 
+    /**
+     * Same as `run(config)`, except that the output points and triangles
+     * are written to `sink` instead of being kept by the engine, i.e.
+     * `get_out_points()` and `get_out_triangles()` are empty afterwards
+     * unless the sink throws.  All other outputs are kept by the engine.
+     */
+    void run(const Config& config, OutputSink& sink);
+
+    /**
+     * Statistics of the last `run`.
+     */
+    const RunStats& get_run_stats() const { return m_stats; }
+
+public:
+    //================== Incremental Updates ========================
+    // Edit the output of the last run in place, restoring the (constrained)
+    // Delaunay property locally instead of running triangle again, so that
+    // the cost is proportional to the size of the change.  Output points,
+    // triangles and neighbors are required.  Segments and markers are kept up
+    // to date.  Edges and the Voronoi diagram are discarded by the first edit.
+    // Quality constraints (min angle, max area) are not enforced.
+
+    /**
+     * Insert points into the output triangulation.  They are appended to the
+     * output points in order, and split the output segments they lie on.
+     * Duplicates of existing points are appended without being triangulated.
+     *
+     * @throws std::runtime_error if a point is outside of the triangulation.
+     */
+    void insert_points(const Scalar* points, Index num_points);
+
+    /**
+     * Remove an interior output point that is not on an output segment.  The
+     * last output point takes its index.
+     *
+     * @throws std::runtime_error if the point is on the boundary or on a
+     *         segment.
+     */
+    void remove_point(Index point);
+
+public:
+    //================== Local Refinement ========================
+    // Refine a patch of the output of the last run with new quality
+    // constraints, without running triangle on the rest of the mesh, so that
+    // the cost is proportional to the size of the patch.  The boundary of the
+    // patch is not split, and the rest of the output is left untouched (see
+    // `RefinementDelta`).  Same requirements and limitations as incremental
+    // updates.
+
+    /**
+     * Refine the given output triangles with the quality constraints of
+     * `config` (`min_angle`, `max_area`, `max_num_steiner`, ...).  Segments
+     * inside of the patch may be split.
+     *
+     * @throws std::runtime_error if a triangle index is invalid.
+     */
+    RefinementDelta refine_triangles(
+        const Index* triangles, Index num_triangles, const Config& config);
+
+    /**
+     * Refine the output triangles whose centroid is inside of `polygon`
+     * (even-odd rule), as `refine_triangles` does.
+     *
+     * The array is row major, i.e. [x0, y0, x1, y1, ...]
+     */
+    RefinementDelta refine_polygon(const Scalar* polygon, Index num_vertices, const Config& config);
+
 private:
     /**
      * Automatically generated a list of hole points based on winding number.
      * This method assumes `m_in` is setup correctly.
      *
+     * Winding numbers are propagated across the constrained triangulation,
+     * changing by +/-1 whenever an oriented input segment is crossed.  If the
+     * input segments do not form closed loops, winding numbers are instead
+     * evaluated at one point per region.
+     *
      * Warning: This method only works if the input segments forms closed and
      * correctly oriented loops.
+     *
+     * @param mesh  If not null, the triangles of the hole detection mesh that
+     *              are outside of holes, and the segments bounding them, are
+     *              extracted into it.
+     */
+    struct AutoHoleMesh;
+    std::vector<Scalar> run_auto_hole_detection(AutoHoleMesh* mesh = nullptr);
+
+    /**
+     * Remove holes from the hole detection mesh and refine the result with
+     * `config` directly, instead of triangulating the input again.
+     *
+     * @returns false if the mesh cannot be reused, in which case the output is
+     *          left untouched.
+     */
+    bool refine_auto_hole_mesh(
+        const Config& config, const AutoHoleMesh& mesh, OutputSink* sink = nullptr);
+
+    /**
+     * Delaunay triangulate the input point cloud with multiple threads (see
+     * `Algorithm::PARALLEL_DIVIDE_AND_CONQUER`).
+     *
+     * @returns false if the serial algorithm should be used instead, in which
+     *          case the output is left untouched.
+     */
+    bool run_parallel_delaunay(const Config& config, OutputSink* sink);
+
+    /**
+     * Refine the input PSLG with multiple threads (see
+     * `Config::parallel_refinement`): its constrained Delaunay triangulation
+     * is split into subdomains that are refined concurrently, and triangle
+     * then refines the band of the welded result around the interfaces.
+     *
+     * @returns false if the serial algorithm should be used instead, in which
+     *          case the output is left untouched.
+     */
+    bool run_parallel_refinement(const Config& config, OutputSink* sink);
+
+    /**
+     * Refine with `config` the triangles of `mesh`, welded from the refined
+     * subdomains of `partition`, that are around interfaces or that do not
+     * meet the constraints, without splitting the boundary of that band.
+     * `neighbors` receives the triangle neighbors of the result.
+     *
+     * @returns false if some triangles still do not meet the constraints, in
+     *          which case `mesh` is valid but has to be refined as a whole.
+     */
+    bool refine_interfaces(const Config& config,
+        const Partition& partition,
+        SegmentMesh& mesh,
+        std::vector<Index>& neighbors);
+
+    /**
+     * Write `mesh`, whose triangle neighbors are `neighbors`, as the output
+     * with `config.output_flags`, the same way triangle would.
+     */
+    void write_mesh(const Config& config,
+        const SegmentMesh& mesh,
+        const std::vector<Index>& neighbors,
+        OutputSink* sink);
+
+    /**
+     * Refine `mesh` with `config`, respecting its segments (i.e. `rp`),
+     * instead of the input.
+     */
+    void refine_mesh(const Config& config, const SegmentMesh& mesh, OutputSink* sink = nullptr);
+
+    /**
+     * Run with the input points sorted along a Hilbert curve (see
+     * `Config::spatial_sort`), then renumber the output points accordingly.
+     */
+    void run_spatially_sorted(const Config& config, OutputSink* sink);
+
+    /**
+     * Run, then renumber the output with `config.output_order`.
+     */
+    void run_reordered(const Config& config, OutputSink* sink);
+
+    /**
+     * Run with statistics (see `get_run_stats`), gathered into those of the enclosing run if
+     * nested.
+     */
+    void run(const Config& config, OutputSink* sink);
+    void run_stages(const Config& config, OutputSink* sink);
+
+    /**
+     * Renumber the output points and triangles with the given ordering.
+     */
+    void reorder_output(OutputOrder order, Index num_threads);
+
+    /**
+     * Release the output points and triangles if they are not in
+     * `output_flags`, i.e. they were only generated for internal use.
+     */
+    void release_unrequested_output(int output_flags);
+
+    /**
+     * Renumber the output points (triangles), i.e. output point (triangle) `i`
+     * becomes `new_index[i]`, updating every output array that refers to them.
+     */
+    void permute_out_points(const std::vector<Index>& new_index);
+    void permute_out_triangles(const std::vector<Index>& new_index);
+
+    /**
+     * Hand the current output points and triangles to `sink`, the same way
+     * `run_triangle` does.
+     */
+    void write_output(OutputSink* sink);
+
+    /**
+     * Run triangle on `m_in` with the given command line options, recycling
+     * the memory of the previous output.  If `sink` is not null, it receives
+     * the output points and triangles.
+     */
+    void run_triangle(const std::string& options, OutputSink* sink = nullptr);
+
+    /**
+     * Release the previous output for recycling, or detach from it if it is
+     * still in use through `get_out_owner()`.
+     */
+    void reset_output();
+
+    /**
+     * Editable view of the current output (see `insert_points`), copied
+     * first if it is still in use through `get_out_owner()`.
      */
-    std::vector<Scalar> run_auto_hole_detection();
+    LiveMesh& get_live_mesh();
 
 private:
     std::unique_ptr<triangulateio> m_in;
-    std::unique_ptr<triangulateio> m_out;
-    std::unique_ptr<triangulateio> m_vorout;
+    std::shared_ptr<triangulateio> m_out;
+    std::shared_ptr<triangulateio> m_vorout;
+    std::unique_ptr<BufferCache> m_buffers;
+    std::unique_ptr<LiveMesh> m_live;
+    RunStats m_stats;
 };
 
 } // namespace trianglelite
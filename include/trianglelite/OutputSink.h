@@ -0,0 +1,80 @@
+#pragma once
+
+#include <trianglelite/common.h>
+
+namespace trianglelite {
+
+/**
+ * Destination for the output points and triangles of `Engine::run(config, sink)`.
+ *
+ * Once triangle knows the final number of output points (triangles), it calls `reserve_points`
+ * (`reserve_triangles`).  If the sink returns storage, triangle writes the output directly into
+ * it.  Otherwise, triangle writes into its own array, which is handed to `append_points`
+ * (`append_triangles`) after the run.
+ *
+ * Throwing from a hook aborts the run cleanly: triangle finishes with its own arrays, and the
+ * exception is rethrown by `Engine::run` afterwards.
+ */
+class OutputSink
+{
+public:
+    virtual ~OutputSink() = default;
+
+    /**
+     * @returns Storage for `num_points` row major points, i.e. [x0, y0, x1, y1, ...], or null.
+     */
+    virtual Scalar* reserve_points(Index /*num_points*/) { return nullptr; }
+
+    /**
+     * @returns Storage for `num_triangles` row major triangles, or null.
+     */
+    virtual Index* reserve_triangles(Index /*num_triangles*/) { return nullptr; }
+
+    /**
+     * Receive the output points if `reserve_points` returned null.
+     */
+    virtual void append_points(const Scalar* /*points*/, Index /*num_points*/) {}
+
+    /**
+     * Receive the output triangles if `reserve_triangles` returned null.
+     */
+    virtual void append_triangles(const Index* /*triangles*/, Index /*num_triangles*/) {}
+};
+
+/**
+ * Output sink backed by caller-provided arrays of fixed capacity.
+ *
+ * If the output does not fit, `Engine::run` throws `std::overflow_error`.  The arrays may have
+ * been partially written, but the output remains available from the engine's `get_out_*`
+ * methods.
+ */
+class FixedOutputSink : public OutputSink
+{
+public:
+    /**
+     * @param points         Array of at least `max_points * 2` scalars.
+     * @param max_points     Capacity of `points`.
+     * @param triangles      Array of at least `max_triangles * 3` indices.
+     * @param max_triangles  Capacity of `triangles`.
+     */
+    FixedOutputSink(Scalar* points, Index max_points, Index* triangles, Index max_triangles);
+
+    Scalar* reserve_points(Index num_points) override;
+    Index* reserve_triangles(Index num_triangles) override;
+
+    /**
+     * Number of points (triangles) written by the last run.
+     */
+    Index get_num_points() const { return m_num_points; }
+    Index get_num_triangles() const { return m_num_triangles; }
+
+private:
+    Scalar* m_points;
+    Index* m_triangles;
+    Index m_max_points;
+    Index m_max_triangles;
+    Index m_num_points = 0;
+    Index m_num_triangles = 0;
+};
+
+} // namespace trianglelite
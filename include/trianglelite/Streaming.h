@@ -0,0 +1,150 @@
+#pragma once
+
+#include <trianglelite/common.h>
+
+#include <cstdio>
+#include <string>
+
+namespace trianglelite {
+
+/**
+ * Input points of `stream_delaunay`, read sequentially in chunks.
+ */
+class PointStream
+{
+public:
+    virtual ~PointStream() = default;
+
+    /**
+     * Total number of points.
+     */
+    virtual LargeIndex size() const = 0;
+
+    /**
+     * Copy the `count` points starting at point `first` into `points`, row major.
+     */
+    virtual void read(LargeIndex first, Index count, Scalar* points) = 0;
+};
+
+/**
+ * Points held in a caller-provided row major array, i.e. [x0, y0, x1, y1, ...], in single or
+ * double precision.
+ */
+class ArrayPointStream : public PointStream
+{
+public:
+    ArrayPointStream(const float* points, LargeIndex num_points);
+    ArrayPointStream(const double* points, LargeIndex num_points);
+
+    LargeIndex size() const override { return m_num_points; }
+    void read(LargeIndex first, Index count, Scalar* points) override;
+
+private:
+    const void* m_points;
+    CoordinateType m_coordinate_type;
+    LargeIndex m_num_points;
+};
+
+/**
+ * Points stored in a raw binary file of row major coordinates in native byte order, i.e.
+ * [x0, y0, x1, y1, ...].  The file is memory-mapped, so only the pages being read need to be
+ * resident.
+ */
+class MappedPointFile : public PointStream
+{
+public:
+    /**
+     * @param coordinate_type  Precision of the coordinates stored in the file.
+     *
+     * @throws std::runtime_error if the file cannot be mapped, or does not hold a whole number of
+     *         points.
+     */
+    explicit MappedPointFile(
+        const std::string& filename, CoordinateType coordinate_type = scalar_coordinate_type);
+    ~MappedPointFile() override;
+    MappedPointFile(const MappedPointFile&) = delete;
+    MappedPointFile& operator=(const MappedPointFile&) = delete;
+
+    LargeIndex size() const override { return m_num_points; }
+    void read(LargeIndex first, Index count, Scalar* points) override;
+
+private:
+    const void* m_points = nullptr;
+    CoordinateType m_coordinate_type;
+    LargeIndex m_num_points = 0;
+    void* m_file = nullptr; // Platform handles, if any.
+    void* m_mapping = nullptr;
+};
+
+/**
+ * Destination of the triangles finalized by `stream_delaunay`.
+ */
+class TriangleWriter
+{
+public:
+    virtual ~TriangleWriter() = default;
+
+    /**
+     * Receive finalized triangles: row major, counterclockwise, indexing into the input points.
+     * Calls are made from one thread at a time.
+     */
+    virtual void write_triangles(const LargeIndex* triangles, Index num_triangles) = 0;
+};
+
+/**
+ * Write triangles to a raw binary file of row major `LargeIndex` indices in native byte order.
+ */
+class TriangleFileWriter : public TriangleWriter
+{
+public:
+    /**
+     * @throws std::runtime_error if the file cannot be created.
+     */
+    explicit TriangleFileWriter(const std::string& filename);
+    ~TriangleFileWriter() override;
+    TriangleFileWriter(const TriangleFileWriter&) = delete;
+    TriangleFileWriter& operator=(const TriangleFileWriter&) = delete;
+
+    void write_triangles(const LargeIndex* triangles, Index num_triangles) override;
+
+private:
+    std::FILE* m_file;
+};
+
+struct StreamingConfig
+{
+    Index points_per_tile = 1 << 20; // Target number of points per tile.
+    LargeIndex max_points_in_memory = LargeIndex(1) << 26; // Loaded per batch, margins included.
+    Scalar margin = Scalar(0.25); // Overlap of neighboring tiles, relative to the tile size.
+    Index num_threads = 0; // Tiles triangulated concurrently, non-positive means all.
+};
+
+/**
+ * Delaunay triangulation of a point set that does not need to fit in memory, such as a
+ * `MappedPointFile`.
+ *
+ * The bounding box of the points is split into a grid of tiles of about `config.points_per_tile`
+ * points.  Each tile is triangulated along with the points within a margin around it, and a
+ * triangle is final as soon as its circumcircle is certified empty, i.e. it reaches no point of
+ * the bounding box beyond the tile and its margin.  Final triangles are written by the tile holding
+ * their circumcenter, so each one is written exactly once, even among cocircular points.  Tiles
+ * are loaded in batches of at most `config.max_points_in_memory` points.  With several batches,
+ * one sequential pass over the input spills the points of each batch to a temporary file, which
+ * is then read back one batch at a time.  The few remaining triangles, whose circumcircles are too
+ * large to be certified (typically along the convex hull), are recovered from a Delaunay
+ * triangulation of the points that are not surrounded by final triangles, and checked by one last
+ * pass.  The input is thus read at most four times, whatever its size.
+ *
+ * Peak memory is bounded by the batch size plus the seam points, rather than by the size of the
+ * input, and the temporary file holds about as many points as the input.
+ *
+ * @returns the number of triangles written.
+ *
+ * @throws std::runtime_error if the configuration is invalid, or if the result fails its sanity
+ *         checks (Euler's formula and total area), in which case the triangles already written
+ *         are not a valid triangulation.
+ */
+LargeIndex stream_delaunay(
+    PointStream& points, TriangleWriter& writer, const StreamingConfig& config = StreamingConfig());
+
+} // namespace trianglelite
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <trianglelite/Config.h>
+#include <trianglelite/Engine.h>
+#include <trianglelite/Streaming.h>
+#include <trianglelite/common.h>
+
+#include <vector>
+
+namespace trianglelite {
+
+struct TilingConfig
+{
+    Index num_cols = 0; // Tiles along x, non-positive means derived from points_per_tile.
+    Index num_rows = 0; // Tiles along y, non-positive means derived from points_per_tile.
+    Index points_per_tile = 1 << 16; // Target number of input points per tile.
+    Scalar border_spacing = 0; // Distance between border points, non-positive means automatic.
+    Index num_threads = 0; // Tiles meshed concurrently, non-positive means all.
+};
+
+/**
+ * Mesh of a large point cloud (e.g. terrain samples) as a grid of tiles over its bounding box, each
+ * meshed by its own `Engine`.
+ *
+ * Tile borders are segments that triangle may not split (`Config::split_boundary == false`).  A
+ * border shared by two tiles holds the same points on both sides: the input points lying on it,
+ * and Steiner points spaced by `TilingConfig::border_spacing`, or by the edge length of an
+ * equilateral triangle of `Config::max_area`, or by the average point spacing.  Tiles thus match
+ * along their borders, and can be meshed concurrently, cached and meshed again independently.
+ */
+class TiledMesh
+{
+public:
+    /**
+     * @param points      Row major input points, which must outlive the tiled mesh.  They are
+     *                    stored in single or double precision, and meshed in `Scalar`.
+     * @param num_points  Number of input points, which may exceed the 32-bit `Index` range as long
+     *                    as each tile stays within it.
+     */
+    TiledMesh(
+        const float* points, LargeIndex num_points, const TilingConfig& config = TilingConfig());
+    TiledMesh(
+        const double* points, LargeIndex num_points, const TilingConfig& config = TilingConfig());
+
+    LargeIndex get_num_points() const { return m_num_points; }
+    Index get_num_cols() const { return m_num_cols; }
+    Index get_num_rows() const { return m_num_rows; }
+
+    /**
+     * Tiles are numbered row by row, i.e. tile (col, row) is `row * get_num_cols() + col`.
+     */
+    Index get_num_tiles() const { return m_num_cols * m_num_rows; }
+
+    /**
+     * Place the tile borders and mesh all tiles, concurrently.  Each tile is meshed with `config`,
+     * except that borders are kept and the options that do not apply to a tile (convex hull,
+     * conforming, auto hole detection, parallel algorithms and output ordering) are turned off.
+     * Tile input points are listed counterclockwise along the border first, then the input points
+     * inside of the tile.  Segments on the domain boundary are marked 1, and the ones shared with
+     * a neighboring tile 2.
+     */
+    void run(const Config& config);
+
+    /**
+     * Mesh tile `tile` again (e.g. with other quality constraints), with the borders placed by
+     * the last `run`.
+     */
+    void run_tile(Index tile, const Config& config);
+
+    /**
+     * Mesh of tile `tile`, with its own point indices.
+     */
+    const Engine& get_tile(Index tile) const;
+
+    /**
+     * Index in the welded mesh of each output point of tile `tile` (see `weld`).
+     */
+    std::vector<LargeIndex> get_tile_point_ids(Index tile) const;
+
+    /**
+     * Weld the tile meshes into a single mesh.  Its points are the input points first, in order,
+     * then the Steiner points placed on the borders, then the points inserted by each tile, tile by
+     * tile.  Triangles are listed tile by tile.
+     *
+     * @throws std::runtime_error if tiles were meshed without output points or triangles, or if
+     *         the welded mesh does not fit in 32-bit indices.
+     */
+    void weld(Matrix2Fr& points, Matrix3Ir& triangles) const;
+
+    /**
+     * Weld the tile meshes into a single mesh with 64-bit indices, for meshes beyond the 2^31
+     * elements of `Matrix3Ir`.  Points are numbered as above, but only the ones that are not input
+     * points are copied: welded point `get_num_points() + i` is point i of `steiner_points` (row
+     * major).  Triangles are handed to `writer` tile by tile, in chunks.
+     *
+     * @returns the number of triangles written.
+     * @throws std::runtime_error if tiles were meshed without output points or triangles.
+     */
+    LargeIndex weld(TriangleWriter& writer, std::vector<Scalar>& steiner_points) const;
+
+private:
+    TiledMesh(const void* points,
+        CoordinateType coordinate_type,
+        LargeIndex num_points,
+        const TilingConfig& config);
+
+    struct Tile
+    {
+        std::vector<Scalar> points; // Input of the tile engine.
+        std::vector<Index> segments;
+        std::vector<int> segment_markers;
+        std::vector<LargeIndex> point_ids; // Index in the welded mesh of each input point.
+    };
+
+    void place_borders(const Config& config);
+    void check_tile(Index tile) const;
+
+    /**
+     * Index in the welded mesh of the first point inserted by each tile, plus the total number of
+     * points.
+     */
+    std::vector<LargeIndex> get_point_offsets() const;
+
+private:
+    const void* m_points;
+    CoordinateType m_coordinate_type;
+    LargeIndex m_num_points;
+    TilingConfig m_config;
+    Index m_num_cols = 1;
+    Index m_num_rows = 1;
+    std::vector<Scalar> m_x_lines; // Tile border abscissas, num_cols + 1 of them.
+    std::vector<Scalar> m_y_lines; // Tile border ordinates, num_rows + 1 of them.
+    std::vector<Scalar> m_border_points; // Steiner points on the borders.
+    std::vector<Tile> m_tiles;
+    std::vector<Engine> m_engines; // One per tile, contiguous for `run_batch`.
+};
+
+} // namespace trianglelite
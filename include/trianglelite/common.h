@@ -2,8 +2,12 @@
 
 #include <Eigen/Core>
 
+#include <cstdint>
+#include <type_traits>
+
 namespace trianglelite {
 
+// Meshing precision, which follows Triangle's `REAL` (see `TRIANGLELITE_F32` for a float copy).
 #ifdef TRIANGLELITE_SINGLE
 using Scalar = float;
 #else
@@ -13,6 +17,19 @@ using Scalar = double;
 // Triangle requires index to be encoded as int.
 using Index = int;
 
+// Indices into data sets that are processed out of core, and may exceed the range of `Index`.
+using LargeIndex = std::int64_t;
+
+/**
+ * Storage precision of large point sets (see `ArrayPointStream`, `MappedPointFile` and
+ * `TiledMesh`).  Coordinates are converted to `Scalar` as they are read, so that single precision
+ * storage halves the memory and bandwidth taken by the input while meshing runs in `Scalar`.
+ */
+enum class CoordinateType { FLOAT32, FLOAT64 };
+
+constexpr CoordinateType scalar_coordinate_type =
+    std::is_same<Scalar, float>::value ? CoordinateType::FLOAT32 : CoordinateType::FLOAT64;
+
 using Matrix1F  = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
 using Matrix2Fr = Eigen::Matrix<Scalar, Eigen::Dynamic, 2, Eigen::RowMajor>;
 using Matrix1I  = Eigen::Matrix<Index, Eigen::Dynamic, 1>;
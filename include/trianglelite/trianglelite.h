@@ -1,5 +1,9 @@
 #pragma once
 
+#include <trianglelite/Batch.h>
 #include <trianglelite/Config.h>
 #include <trianglelite/Engine.h>
+#include <trianglelite/OutputSink.h>
+#include <trianglelite/Streaming.h>
+#include <trianglelite/Tiling.h>
 #include <trianglelite/common.h>
@@ -3,10 +3,17 @@
 #include <fmt/core.h>
 #include <nanobind/eigen/dense.h>
 #include <nanobind/nanobind.h>
+#include <nanobind/ndarray.h>
 #include <nanobind/stl/string.h>
 
+#include <algorithm>
+#include <array>
 #include <exception>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 
 namespace nb = nanobind;
@@ -17,6 +24,7 @@ std::string algorithm_to_string(trianglelite::Algorithm algorithm)
     case trianglelite::Algorithm::DIVIDE_AND_CONQUER: return "divide_and_conquer";
     case trianglelite::Algorithm::SWEEPLINE: return "sweepline";
     case trianglelite::Algorithm::INCREMENTAL: return "incremental";
+    case trianglelite::Algorithm::PARALLEL_DIVIDE_AND_CONQUER: return "parallel_divide_and_conquer";
     default: throw std::runtime_error("Unknown algorithm");
     }
 }
@@ -29,11 +37,293 @@ trianglelite::Algorithm string_to_algorithm(const std::string& value)
         return trianglelite::Algorithm::SWEEPLINE;
     } else if (value == "incremental") {
         return trianglelite::Algorithm::INCREMENTAL;
+    } else if (value == "parallel_divide_and_conquer") {
+        return trianglelite::Algorithm::PARALLEL_DIVIDE_AND_CONQUER;
     } else {
         throw std::runtime_error("Unknown algorithm");
     }
 }
 
+std::string output_order_to_string(trianglelite::OutputOrder order)
+{
+    switch (order) {
+    case trianglelite::OutputOrder::DEFAULT: return "default";
+    case trianglelite::OutputOrder::HILBERT: return "hilbert";
+    case trianglelite::OutputOrder::REVERSE_CUTHILL_MCKEE: return "reverse_cuthill_mckee";
+    case trianglelite::OutputOrder::STRIP: return "strip";
+    default: throw std::runtime_error("Unknown output order");
+    }
+}
+
+trianglelite::OutputOrder string_to_output_order(const std::string& value)
+{
+    if (value == "default") {
+        return trianglelite::OutputOrder::DEFAULT;
+    } else if (value == "hilbert") {
+        return trianglelite::OutputOrder::HILBERT;
+    } else if (value == "reverse_cuthill_mckee") {
+        return trianglelite::OutputOrder::REVERSE_CUTHILL_MCKEE;
+    } else if (value == "strip") {
+        return trianglelite::OutputOrder::STRIP;
+    } else {
+        throw std::runtime_error("Unknown output order");
+    }
+}
+
+using ScalarArray2 =
+    nb::ndarray<const trianglelite::Scalar, nb::shape<-1, 2>, nb::c_contig, nb::device::cpu>;
+using ScalarArray1 =
+    nb::ndarray<const trianglelite::Scalar, nb::shape<-1>, nb::c_contig, nb::device::cpu>;
+using IndexArray1 =
+    nb::ndarray<const trianglelite::Index, nb::shape<-1>, nb::c_contig, nb::device::cpu>;
+using IndexArray2 =
+    nb::ndarray<const trianglelite::Index, nb::shape<-1, 2>, nb::c_contig, nb::device::cpu>;
+using IndexArray3 =
+    nb::ndarray<const trianglelite::Index, nb::shape<-1, 3>, nb::c_contig, nb::device::cpu>;
+using IntArray1 = nb::ndarray<const int, nb::shape<-1>, nb::c_contig, nb::device::cpu>;
+
+template <typename T>
+const char* numpy_dtype()
+{
+    static_assert(std::is_same<T, double>::value || std::is_same<T, float>::value ||
+                      std::is_same<T, int>::value,
+        "Unsupported dtype");
+    return std::is_same<T, double>::value ? "float64"
+           : std::is_same<T, float>::value ? "float32"
+                                           : "int32";
+}
+
+/**
+ * Engine that keeps its Python input arrays alive.
+ *
+ * `Engine` only stores raw pointers to its input, so the arrays they point into are referenced
+ * here for as long as they are in use.  Arrays are accepted as is (zero-copy) only if they are
+ * C-contiguous with the expected dtype.  Other arrays are rejected, unless `allow_input_copy` is
+ * set, in which case the converted copy is kept alive instead and `input_copied()` reports it.
+ */
+struct PyEngine : public trianglelite::Engine
+{
+    enum Input {
+        POINTS,
+        SEGMENTS,
+        TRIANGLES,
+        HOLES,
+        AREAS,
+        POINT_MARKERS,
+        SEGMENT_MARKERS,
+        NUM_INPUTS
+    };
+
+    bool allow_input_copy = false;
+    std::array<nb::object, NUM_INPUTS> arrays;
+    std::array<bool, NUM_INPUTS> copied{};
+
+    bool input_copied() const
+    {
+        return std::any_of(copied.begin(), copied.end(), [](bool c) { return c; });
+    }
+
+    /**
+     * Set (or unset, if `value` is None) one input from a Python object.
+     */
+    template <typename Array, typename T>
+    void set_input(Input input,
+        nb::handle value,
+        const char* name,
+        void (trianglelite::Engine::*set)(const T*, trianglelite::Index),
+        void (trianglelite::Engine::*unset)())
+    {
+        if (value.is_none()) {
+            (this->*unset)();
+            arrays[input] = nb::object();
+            copied[input] = false;
+            return;
+        }
+
+        // Zero-copy if possible.  Otherwise convert with NumPy, and keep the converted copy alive.
+        nb::object source = nb::borrow(value);
+        Array array;
+        bool copy = false;
+        if (!nb::try_cast(source, array, /*convert*/ false)) {
+            if (allow_input_copy) {
+                source = nb::module_::import_("numpy").attr("ascontiguousarray")(
+                    value, nb::arg("dtype") = numpy_dtype<T>());
+                copy = true;
+            }
+            if (!copy || !nb::try_cast(source, array, /*convert*/ false)) {
+                throw nb::type_error((std::string("`") + name +
+                                      "` must be a C-contiguous CPU array with the expected "
+                                      "dtype and shape; set `allow_input_copy` to convert it.")
+                                         .c_str());
+            }
+        }
+
+        (this->*set)(array.data(), static_cast<trianglelite::Index>(array.shape(0)));
+        arrays[input] = std::move(source);
+        copied[input] = copy;
+    }
+};
+
+/**
+ * Zero-copy NumPy view of an engine output.  The view shares ownership of the output arrays
+ * through a capsule, so it stays valid after the engine is run again or destroyed.
+ */
+template <typename Map>
+nb::ndarray<nb::numpy, typename Map::Scalar> output_view(
+    const trianglelite::Engine& engine, const Map& map)
+{
+    using T = typename Map::Scalar;
+    static T empty = 0; // Unselected outputs have no data.
+
+    auto* owner = new std::shared_ptr<const void>(engine.get_out_owner());
+    nb::capsule capsule(owner,
+        [](void* ptr) noexcept { delete static_cast<std::shared_ptr<const void>*>(ptr); });
+
+    const size_t shape[2] = {static_cast<size_t>(map.rows()), static_cast<size_t>(map.cols())};
+    const size_t ndim = Map::ColsAtCompileTime == 1 ? 1 : 2;
+    T* data = map.data() != nullptr ? const_cast<T*>(map.data()) : &empty;
+    return nb::ndarray<nb::numpy, T>(data, ndim, shape, capsule);
+}
+
+/**
+ * `RefinementDelta` as a dict of NumPy index arrays, which take ownership of its vectors.
+ */
+nb::dict delta_output(trianglelite::RefinementDelta delta)
+{
+    using Indices = std::vector<trianglelite::Index>;
+    nb::dict output;
+    auto add = [&](const char* key, Indices& values) {
+        auto* owner = new Indices(std::move(values));
+        nb::capsule capsule(owner, [](void* ptr) noexcept { delete static_cast<Indices*>(ptr); });
+        const size_t shape[1] = {owner->size()};
+        output[key] = nb::cast(
+            nb::ndarray<nb::numpy, trianglelite::Index>(owner->data(), 1, shape, capsule));
+    };
+    add("removed_triangles", delta.removed_triangles);
+    add("added_triangles", delta.added_triangles);
+    add("added_points", delta.added_points);
+    return output;
+}
+
+/**
+ * Input of one `triangulate_many` job.  Arrays are converted to owned matrices while holding the
+ * GIL so that the batch itself can run without it.
+ */
+struct BatchInput
+{
+    trianglelite::Matrix2Fr points;
+    trianglelite::Matrix2Ir segments;
+    trianglelite::Matrix3Ir triangles;
+    trianglelite::Matrix2Fr holes;
+    trianglelite::Matrix1F areas;
+    trianglelite::Matrix1I point_markers;
+    trianglelite::Matrix1I segment_markers;
+
+    explicit BatchInput(nb::handle item)
+    {
+        if (!nb::isinstance<nb::dict>(item)) {
+            points = nb::cast<trianglelite::Matrix2Fr>(item);
+            return;
+        }
+        nb::dict input = nb::borrow<nb::dict>(item);
+        for (auto entry : input) {
+            const std::string key = nb::cast<std::string>(entry.first);
+            if (key == "points") {
+                points = nb::cast<trianglelite::Matrix2Fr>(entry.second);
+            } else if (key == "segments") {
+                segments = nb::cast<trianglelite::Matrix2Ir>(entry.second);
+            } else if (key == "triangles") {
+                triangles = nb::cast<trianglelite::Matrix3Ir>(entry.second);
+            } else if (key == "holes") {
+                holes = nb::cast<trianglelite::Matrix2Fr>(entry.second);
+            } else if (key == "areas") {
+                areas = nb::cast<trianglelite::Matrix1F>(entry.second);
+            } else if (key == "point_markers") {
+                point_markers = nb::cast<trianglelite::Matrix1I>(entry.second);
+            } else if (key == "segment_markers") {
+                segment_markers = nb::cast<trianglelite::Matrix1I>(entry.second);
+            } else {
+                throw std::runtime_error("Unknown triangulation input: " + key);
+            }
+        }
+        if (points.rows() == 0) {
+            throw std::runtime_error("Triangulation input without points");
+        }
+    }
+
+    void apply(trianglelite::Engine& engine)
+    {
+        using trianglelite::Index;
+        engine.set_in_points(points.data(), static_cast<Index>(points.rows()));
+        if (segments.rows() > 0) {
+            engine.set_in_segments(segments.data(), static_cast<Index>(segments.rows()));
+        }
+        if (triangles.rows() > 0) {
+            engine.set_in_triangles(triangles.data(), static_cast<Index>(triangles.rows()));
+        }
+        if (holes.rows() > 0) {
+            engine.set_in_holes(holes.data(), static_cast<Index>(holes.rows()));
+        }
+        if (areas.rows() > 0) {
+            engine.set_in_areas(areas.data(), static_cast<Index>(areas.rows()));
+        }
+        if (point_markers.rows() > 0) {
+            engine.set_in_point_markers(
+                point_markers.data(), static_cast<Index>(point_markers.rows()));
+        }
+        if (segment_markers.rows() > 0) {
+            engine.set_in_segment_markers(
+                segment_markers.data(), static_cast<Index>(segment_markers.rows()));
+        }
+    }
+};
+
+/**
+ * Outputs of `engine` as a dict of zero-copy NumPy arrays.  Arrays that were not generated are
+ * omitted.
+ */
+nb::dict batch_output(const trianglelite::Engine& engine)
+{
+    nb::dict output;
+    auto add = [&](const char* key, const auto& value) {
+        if (value.data() != nullptr) output[key] = nb::cast(output_view(engine, value));
+    };
+    add("points", engine.get_out_points());
+    add("triangles", engine.get_out_triangles());
+    add("segments", engine.get_out_segments());
+    add("edges", engine.get_out_edges());
+    add("triangle_neighbors", engine.get_out_triangle_neighbors());
+    add("point_markers", engine.get_out_point_markers());
+    add("segment_markers", engine.get_out_segment_markers());
+    add("edge_markers", engine.get_out_edge_markers());
+    add("voronoi_points", engine.get_voronoi_points());
+    add("voronoi_edges", engine.get_voronoi_edges());
+    add("voronoi_normals", engine.get_voronoi_normals());
+    return output;
+}
+
+/**
+ * Tiled mesh that owns a copy of its input points, kept in single precision if given so.
+ */
+struct PyTiledMesh
+{
+    std::vector<float> points_f32;
+    trianglelite::Matrix2Fr points;
+    trianglelite::TiledMesh mesh;
+
+    PyTiledMesh(trianglelite::Matrix2Fr input, const trianglelite::TilingConfig& config)
+        : points(std::move(input))
+        , mesh(points.data(), static_cast<trianglelite::LargeIndex>(points.rows()), config)
+    {}
+
+    PyTiledMesh(std::vector<float> input, const trianglelite::TilingConfig& config)
+        : points_f32(std::move(input))
+        , mesh(points_f32.data(),
+            static_cast<trianglelite::LargeIndex>(points_f32.size() / 2),
+            config)
+    {}
+};
+
 NB_MODULE(pytrianglelite, m)
 {
     nb::class_<trianglelite::Config>(m, "Config", "Triangulation configuration.")
@@ -44,7 +334,11 @@ NB_MODULE(pytrianglelite, m)
                                    "max_num_steiner={},\n  verbose_level={},\n  "
                                    "algorithm={},\n  convex_hull={},\n  conforming={},\n  "
                                    "exact={},\n  split_boundary={},\n  "
-                                   "auto_hole_detection={}\n)",
+                                   "auto_hole_detection={},\n  auto_hole_reuse_mesh={},\n  "
+                                   "voronoi={},\n  "
+                                   "output_flags={},\n  reuse_buffers={},\n  num_threads={},\n  "
+                                   "parallel_refinement={},\n  spatial_sort={},\n  "
+                                   "keep_spatial_order={},\n  output_order={}\n)",
                     self.min_angle,
                     self.max_area,
                     self.max_num_steiner,
@@ -54,7 +348,16 @@ NB_MODULE(pytrianglelite, m)
                     self.conforming,
                     self.exact,
                     self.split_boundary,
-                    self.auto_hole_detection);
+                    self.auto_hole_detection,
+                    self.auto_hole_reuse_mesh,
+                    self.voronoi,
+                    self.output_flags,
+                    self.reuse_buffers,
+                    self.num_threads,
+                    self.parallel_refinement,
+                    self.spatial_sort,
+                    self.keep_spatial_order,
+                    output_order_to_string(self.output_order));
             })
         .def_rw("min_angle",
             &trianglelite::Config::min_angle,
@@ -72,9 +375,10 @@ NB_MODULE(pytrianglelite, m)
             "algorithm",
             [](trianglelite::Config& self) { return algorithm_to_string(self.algorithm); },
             [](trianglelite::Config& self, std::string value) {
-                return algorithm_to_string(self.algorithm);
+                self.algorithm = string_to_algorithm(value);
             },
-            R"(Algorithm: "divide_and_conquer", "sweepline", "incremental")")
+            R"(Algorithm: "divide_and_conquer", "sweepline", "incremental",
+"parallel_divide_and_conquer".  The latter is serial for inputs with segments or triangles.)")
         .def_rw("convex_hull", &trianglelite::Config::convex_hull, R"(Whether to keep convex hul)")
         .def_rw("conforming",
             &trianglelite::Config::conforming,
@@ -87,92 +391,511 @@ NB_MODULE(pytrianglelite, m)
             R"(Whether to allow splitting the boundary.)")
         .def_rw("auto_hole_detection",
             &trianglelite::Config::auto_hole_detection,
-            R"(Whether to detect holes automatically based on winding number.)");
+            R"(Whether to detect holes automatically based on winding number.)")
+        .def_rw("auto_hole_reuse_mesh",
+            &trianglelite::Config::auto_hole_reuse_mesh,
+            R"(Whether to refine the auto hole detection mesh directly instead of remeshing.)")
+        .def_rw("voronoi",
+            &trianglelite::Config::voronoi,
+            R"(Whether to compute the Voronoi diagram as well.)")
+        .def_rw("output_flags",
+            &trianglelite::Config::output_flags,
+            R"(Bitwise or of OUTPUT_* flags selecting which output arrays are generated.)")
+        .def_rw("reuse_buffers",
+            &trianglelite::Config::reuse_buffers,
+            R"(Whether to recycle memory across repeated runs of the same engine.)")
+        .def_rw("num_threads",
+            &trianglelite::Config::num_threads,
+            R"(Number of threads of parallel algorithms (all if not positive).)")
+        .def_rw("parallel_refinement",
+            &trianglelite::Config::parallel_refinement,
+            R"(Whether to refine PSLGs in subdomains in parallel, using num_threads threads.)")
+        .def_rw("spatial_sort",
+            &trianglelite::Config::spatial_sort,
+            R"(Whether to insert points in Hilbert curve order (output keeps input numbering).)")
+        .def_rw("keep_spatial_order",
+            &trianglelite::Config::keep_spatial_order,
+            R"(With spatial_sort, whether to number output points and triangles along the curve.)")
+        .def_prop_rw(
+            "output_order",
+            [](trianglelite::Config& self) { return output_order_to_string(self.output_order); },
+            [](trianglelite::Config& self, std::string value) {
+                self.output_order = string_to_output_order(value);
+            },
+            R"(Numbering of the output: "default", "hilbert", "reverse_cuthill_mckee", "strip")");
+
+    m.attr("OUTPUT_POINTS") = static_cast<int>(trianglelite::OUTPUT_POINTS);
+    m.attr("OUTPUT_TRIANGLES") = static_cast<int>(trianglelite::OUTPUT_TRIANGLES);
+    m.attr("OUTPUT_SEGMENTS") = static_cast<int>(trianglelite::OUTPUT_SEGMENTS);
+    m.attr("OUTPUT_EDGES") = static_cast<int>(trianglelite::OUTPUT_EDGES);
+    m.attr("OUTPUT_NEIGHBORS") = static_cast<int>(trianglelite::OUTPUT_NEIGHBORS);
+    m.attr("OUTPUT_MARKERS") = static_cast<int>(trianglelite::OUTPUT_MARKERS);
+    m.attr("OUTPUT_ALL") = static_cast<int>(trianglelite::OUTPUT_ALL);
+
+    nb::class_<trianglelite::RunStats>(m, "RunStats", "Statistics of the last run of an engine.")
+        .def_ro("input_time",
+            &trianglelite::RunStats::input_time,
+            R"(Seconds spent building triangle's mesh from the input.)")
+        .def_ro("delaunay_time",
+            &trianglelite::RunStats::delaunay_time,
+            R"(Seconds spent in Delaunay triangulation, or reconstruction of an input mesh.)")
+        .def_ro("segment_time",
+            &trianglelite::RunStats::segment_time,
+            R"(Seconds spent inserting segments.)")
+        .def_ro("hole_time",
+            &trianglelite::RunStats::hole_time,
+            R"(Seconds spent carving holes and concavities.)")
+        .def_ro("quality_time",
+            &trianglelite::RunStats::quality_time,
+            R"(Seconds spent in quality refinement.)")
+        .def_ro("output_time",
+            &trianglelite::RunStats::output_time,
+            R"(Seconds spent writing the output arrays.)")
+        .def_ro("auto_hole_triangulation_time",
+            &trianglelite::RunStats::auto_hole_triangulation_time,
+            R"(Seconds spent in the constrained triangulation of auto hole detection.)")
+        .def_ro("auto_hole_region_time",
+            &trianglelite::RunStats::auto_hole_region_time,
+            R"(Seconds spent finding the regions bounded by segments in auto hole detection.)")
+        .def_ro("auto_hole_winding_time",
+            &trianglelite::RunStats::auto_hole_winding_time,
+            R"(Seconds spent computing winding numbers in auto hole detection.)")
+        .def_ro("auto_hole_extraction_time",
+            &trianglelite::RunStats::auto_hole_extraction_time,
+            R"(Seconds spent extracting hole points (and the reused mesh) in auto hole detection.)")
+        .def_ro("total_time",
+            &trianglelite::RunStats::total_time,
+            R"(Seconds spent in the whole run.)")
+        .def_ro("num_triangle_runs",
+            &trianglelite::RunStats::num_triangle_runs,
+            R"(Number of calls to triangle.)")
+        .def_ro("num_orient2d",
+            &trianglelite::RunStats::num_orient2d,
+            R"(Number of orientation tests made by triangle.)")
+        .def_ro("num_incircle",
+            &trianglelite::RunStats::num_incircle,
+            R"(Number of in-circle tests made by triangle.)")
+        .def_ro("num_exact_orient2d",
+            &trianglelite::RunStats::num_exact_orient2d,
+            R"(Number of orientation tests that fell back to exact arithmetic.)")
+        .def_ro("num_exact_incircle",
+            &trianglelite::RunStats::num_exact_incircle,
+            R"(Number of in-circle tests that fell back to exact arithmetic.)")
+        .def_ro("num_steiner_points",
+            &trianglelite::RunStats::num_steiner_points,
+            R"(Number of output points that are not input points.)")
+        .def_ro("num_subdomains",
+            &trianglelite::RunStats::num_subdomains,
+            R"(Number of parts meshed concurrently by a parallel algorithm, 0 if run serially.)")
+        .def_ro("peak_memory",
+            &trianglelite::RunStats::peak_memory,
+            R"(Peak bytes allocated by a triangle run (pools and output arrays).)");
 
-    nb::class_<trianglelite::Engine>(m, "Engine", "Triangulation engine.")
+    nb::class_<PyEngine>(m, "Engine", "Triangulation engine.")
         .def(nb::init<>())
+        .def_rw("allow_input_copy",
+            &PyEngine::allow_input_copy,
+            R"(Whether input arrays that are not C-contiguous or not of the expected dtype are
+converted (copied).  Otherwise, setting such an array raises TypeError.  Default is False.)")
+        .def_prop_ro(
+            "input_copied",
+            [](const PyEngine& self) { return self.input_copied(); },
+            R"(Whether any of the current input arrays is a converted copy of the array it was set
+from, rather than the array itself.)")
         .def_prop_rw(
             "in_points",
-            [](trianglelite::Engine& self) { return self.get_in_points(); },
-            [](trianglelite::Engine& self, trianglelite::Matrix2FrMap value) {
-                self.set_in_points(value.data(), static_cast<trianglelite::Index>(value.rows()));
+            [](PyEngine& self) { return self.get_in_points(); },
+            [](PyEngine& self, nb::handle value) {
+                self.set_input<ScalarArray2>(PyEngine::POINTS,
+                    value,
+                    "in_points",
+                    &trianglelite::Engine::set_in_points,
+                    &trianglelite::Engine::unset_in_points);
             },
-            R"(Input 2D point cloud to be triangulated or Voronoi diagrammed.)")
+            R"(Input 2D point cloud to be triangulated or Voronoi diagrammed.
+
+A C-contiguous array of shape (n, 2) and dtype float64 (float32 for single
+precision builds).  The engine keeps a reference to it instead of copying it.)")
         .def_prop_rw(
             "in_segments",
-            [](trianglelite::Engine& self) { return self.get_in_segments(); },
-            [](trianglelite::Engine& self, trianglelite::Matrix2IrMap value) {
-                self.set_in_segments(value.data(), static_cast<trianglelite::Index>(value.rows()));
+            [](PyEngine& self) { return self.get_in_segments(); },
+            [](PyEngine& self, nb::handle value) {
+                self.set_input<IndexArray2>(PyEngine::SEGMENTS,
+                    value,
+                    "in_segments",
+                    &trianglelite::Engine::set_in_segments,
+                    &trianglelite::Engine::unset_in_segments);
             },
-            R"(Input segment constraints.)")
+            R"(Input segment constraints.  C-contiguous int32 array of shape (n, 2).)")
         .def_prop_rw(
             "in_triangles",
-            [](trianglelite::Engine& self) { return self.get_in_triangles(); },
-            [](trianglelite::Engine& self, trianglelite::Matrix3IrMap value) {
-                self.set_in_triangles(value.data(), static_cast<trianglelite::Index>(value.rows()));
+            [](PyEngine& self) { return self.get_in_triangles(); },
+            [](PyEngine& self, nb::handle value) {
+                self.set_input<IndexArray3>(PyEngine::TRIANGLES,
+                    value,
+                    "in_triangles",
+                    &trianglelite::Engine::set_in_triangles,
+                    &trianglelite::Engine::unset_in_triangles);
             },
-            R"(Input existing triangulation of the point cloud. Used for refining an existing triangulation.)")
+            R"(Input existing triangulation of the point cloud.  Used for refining an
+existing triangulation.  C-contiguous int32 array of shape (n, 3).)")
         .def_prop_rw(
             "in_holes",
-            [](trianglelite::Engine& self) { return self.get_in_holes(); },
-            [](trianglelite::Engine& self, trianglelite::Matrix2FrMap value) {
-                self.set_in_holes(value.data(), static_cast<trianglelite::Index>(value.rows()));
+            [](PyEngine& self) { return self.get_in_holes(); },
+            [](PyEngine& self, nb::handle value) {
+                self.set_input<ScalarArray2>(PyEngine::HOLES,
+                    value,
+                    "in_holes",
+                    &trianglelite::Engine::set_in_holes,
+                    &trianglelite::Engine::unset_in_holes);
             },
             R"(Input hole points. Used by triangle to flood and remove faces representing holes.)")
         .def_prop_rw(
             "in_areas",
-            [](trianglelite::Engine& self) { return self.get_in_areas(); },
-            [](trianglelite::Engine& self, trianglelite::Matrix1FMap value) {
-                self.set_in_areas(value.data(), static_cast<trianglelite::Index>(value.rows()));
+            [](PyEngine& self) { return self.get_in_areas(); },
+            [](PyEngine& self, nb::handle value) {
+                self.set_input<ScalarArray1>(PyEngine::AREAS,
+                    value,
+                    "in_areas",
+                    &trianglelite::Engine::set_in_areas,
+                    &trianglelite::Engine::unset_in_areas);
             },
             R"(Input triangle area constraints. One area per triangle.)")
         .def_prop_rw(
             "in_point_markers",
-            [](trianglelite::Engine& self) { return self.get_in_point_markers(); },
-            [](trianglelite::Engine& self, trianglelite::Matrix1IMap value) {
-                self.set_in_point_markers(
-                    value.data(), static_cast<trianglelite::Index>(value.rows()));
+            [](PyEngine& self) { return self.get_in_point_markers(); },
+            [](PyEngine& self, nb::handle value) {
+                self.set_input<IntArray1>(PyEngine::POINT_MARKERS,
+                    value,
+                    "in_point_markers",
+                    &trianglelite::Engine::set_in_point_markers,
+                    &trianglelite::Engine::unset_in_point_markers);
             },
-            R"(Input point markers. One positive integer marker per point.)")
+            R"(Input point markers. One positive int32 marker per point.)")
         .def_prop_rw(
             "in_segment_markers",
-            [](trianglelite::Engine& self) { return self.get_in_segment_markers(); },
-            [](trianglelite::Engine& self, trianglelite::Matrix1IMap value) {
-                self.set_in_segment_markers(
-                    value.data(), static_cast<trianglelite::Index>(value.rows()));
+            [](PyEngine& self) { return self.get_in_segment_markers(); },
+            [](PyEngine& self, nb::handle value) {
+                self.set_input<IntArray1>(PyEngine::SEGMENT_MARKERS,
+                    value,
+                    "in_segment_markers",
+                    &trianglelite::Engine::set_in_segment_markers,
+                    &trianglelite::Engine::unset_in_segment_markers);
             },
-            R"(Input segment markers. One positive integer marker per segment.)")
+            R"(Input segment markers. One positive int32 marker per segment.)")
         .def_prop_ro(
             "out_points",
-            [](trianglelite::Engine& self) { return self.get_out_points(); },
+            [](PyEngine& self) { return output_view(self, self.get_out_points()); },
             R"(Output 2D point cloud.)")
         .def_prop_ro(
             "out_segments",
-            [](trianglelite::Engine& self) { return self.get_out_segments(); },
+            [](PyEngine& self) { return output_view(self, self.get_out_segments()); },
             R"(Output segment constraints.)")
         .def_prop_ro(
             "out_triangles",
-            [](trianglelite::Engine& self) { return self.get_out_triangles(); },
+            [](PyEngine& self) { return output_view(self, self.get_out_triangles()); },
             R"(Output triangulation.)")
         .def_prop_ro(
             "out_edges",
-            [](trianglelite::Engine& self) { return self.get_out_edges(); },
+            [](PyEngine& self) { return output_view(self, self.get_out_edges()); },
             R"(Output edges.)")
         .def_prop_ro(
             "out_triangle_neighbors",
-            [](trianglelite::Engine& self) { return self.get_out_triangle_neighbors(); },
+            [](PyEngine& self) { return output_view(self, self.get_out_triangle_neighbors()); },
             R"(Output triangle neighbors.)")
         .def_prop_ro(
             "out_point_markers",
-            [](trianglelite::Engine& self) { return self.get_out_point_markers(); },
+            [](PyEngine& self) { return output_view(self, self.get_out_point_markers()); },
             R"(Output point markers.)")
         .def_prop_ro(
             "out_segment_markers",
-            [](trianglelite::Engine& self) { return self.get_out_segment_markers(); },
+            [](PyEngine& self) { return output_view(self, self.get_out_segment_markers()); },
             R"(Output segment markers.)")
         .def_prop_ro(
             "out_edge_markers",
-            [](trianglelite::Engine& self) { return self.get_out_edge_markers(); },
+            [](PyEngine& self) { return output_view(self, self.get_out_edge_markers()); },
             R"(Output edge markers.)")
-        .def("run", &trianglelite::Engine::run, R"(Run triangulation.)");
+        .def_prop_ro(
+            "voronoi_points",
+            [](PyEngine& self) { return output_view(self, self.get_voronoi_points()); },
+            R"(Voronoi vertices. Only available if `Config.voronoi` is set.)")
+        .def_prop_ro(
+            "voronoi_edges",
+            [](PyEngine& self) { return output_view(self, self.get_voronoi_edges()); },
+            R"(Voronoi edges. -1 as second vertex indicates an infinite ray.)")
+        .def_prop_ro(
+            "voronoi_normals",
+            [](PyEngine& self) { return output_view(self, self.get_voronoi_normals()); },
+            R"(Directions of infinite Voronoi rays. One row per Voronoi edge.)")
+        .def(
+            "run",
+            [](PyEngine& self, const trianglelite::Config& config) { self.run(config); },
+            nb::arg("config"),
+            nb::call_guard<nb::gil_scoped_release>(),
+            R"(Run triangulation.
+
+The GIL is released while triangulating, so other Python threads may run
+concurrently.  Input arrays must not be modified until `run` returns.)")
+        .def_prop_ro(
+            "run_stats",
+            [](const PyEngine& self) { return self.get_run_stats(); },
+            R"(Per-phase timings, predicate counts, Steiner points and peak memory of the
+last `run`, as a `RunStats`.)")
+        .def(
+            "insert_points",
+            [](PyEngine& self, ScalarArray2 points) {
+                const auto num_points = static_cast<trianglelite::Index>(points.shape(0));
+                self.insert_points(points.data(), num_points);
+            },
+            nb::arg("points"),
+            R"(Insert points into the output triangulation without running triangle again.
+
+The (constrained) Delaunay property is restored locally, but quality
+constraints are not enforced.  Points are appended to `out_points` in order.
+Requires output points, triangles and neighbors.  Output arrays obtained
+before the call keep their previous content.)")
+        .def(
+            "remove_point",
+            [](PyEngine& self, trianglelite::Index point) { self.remove_point(point); },
+            nb::arg("point"),
+            R"(Remove an interior output point that is not on an output segment.
+
+The last output point takes its index.)")
+        .def(
+            "refine_triangles",
+            [](PyEngine& self, IndexArray1 triangles, const trianglelite::Config& config) {
+                const auto num_triangles = static_cast<trianglelite::Index>(triangles.shape(0));
+                return delta_output(self.refine_triangles(triangles.data(), num_triangles, config));
+            },
+            nb::arg("triangles"),
+            nb::arg("config"),
+            R"(Refine the given output triangles with the quality constraints of `config`.
+
+The boundary of the patch is not split and the rest of the output is left
+untouched.  Returns a dict with the `removed_triangles`, `added_triangles`
+and `added_points` indices.  Removed triangle indices are reused by added
+triangles first.  Same requirements as `insert_points`.)")
+        .def(
+            "refine_polygon",
+            [](PyEngine& self, ScalarArray2 polygon, const trianglelite::Config& config) {
+                const auto num_vertices = static_cast<trianglelite::Index>(polygon.shape(0));
+                return delta_output(self.refine_polygon(polygon.data(), num_vertices, config));
+            },
+            nb::arg("polygon"),
+            nb::arg("config"),
+            R"(Refine the output triangles whose centroid is inside of `polygon`.
+
+See `refine_triangles`.)");
+
+    m.def(
+        "triangulate_many",
+        [](nb::list inputs, const trianglelite::Config& config, trianglelite::Index num_threads) {
+            std::vector<BatchInput> jobs;
+            jobs.reserve(inputs.size());
+            for (auto item : inputs) {
+                jobs.emplace_back(item);
+            }
+
+            std::vector<trianglelite::Engine> engines(jobs.size());
+            for (size_t i = 0; i < jobs.size(); i++) {
+                jobs[i].apply(engines[i]);
+            }
+
+            {
+                nb::gil_scoped_release release;
+                trianglelite::run_batch(engines.data(),
+                    static_cast<trianglelite::Index>(engines.size()),
+                    config,
+                    num_threads);
+            }
+
+            nb::list outputs;
+            for (const auto& engine : engines) {
+                outputs.append(batch_output(engine));
+            }
+            return outputs;
+        },
+        nb::arg("inputs"),
+        nb::arg("config"),
+        nb::arg("num_threads") = 0,
+        R"(Triangulate a list of independent inputs in parallel.
+
+Each input is either an array of points or a dict with any of the keys
+"points" (required), "segments", "triangles", "holes", "areas",
+"point_markers" and "segment_markers".  The batch runs in C++ across
+`num_threads` threads (all hardware threads if not positive) without holding
+the GIL.
+
+Returns a list of dicts of NumPy arrays, one per input, keyed by "points",
+"triangles", "segments", "edges", "triangle_neighbors", "point_markers",
+"segment_markers", "edge_markers" and, if `config.voronoi` is set,
+"voronoi_points", "voronoi_edges" and "voronoi_normals".  Arrays that are
+not generated (see `config.output_flags`) are omitted.)");
+
+    nb::class_<PyTiledMesh>(m, "TiledMesh", R"(Mesh of a large point cloud as a grid of tiles.
+
+Each tile is meshed by its own engine, with the borders shared by two tiles
+holding the same points on both sides, so that tiles can be meshed
+concurrently, meshed again independently and welded into a single mesh.)")
+        .def(
+            "__init__",
+            [](PyTiledMesh* self,
+                nb::handle points,
+                trianglelite::Index num_cols,
+                trianglelite::Index num_rows,
+                trianglelite::Index points_per_tile,
+                trianglelite::Scalar border_spacing,
+                trianglelite::Index num_threads) {
+                trianglelite::TilingConfig config;
+                config.num_cols = num_cols;
+                config.num_rows = num_rows;
+                config.points_per_tile = points_per_tile;
+                config.border_spacing = border_spacing;
+                config.num_threads = num_threads;
+                using Float32Array =
+                    nb::ndarray<const float, nb::shape<-1, 2>, nb::c_contig, nb::device::cpu>;
+                Float32Array points_f32;
+                if (nb::try_cast(points, points_f32, /*convert*/ false)) {
+                    std::vector<float> copy(points_f32.data(),
+                        points_f32.data() + points_f32.shape(0) * 2);
+                    new (self) PyTiledMesh(std::move(copy), config);
+                } else {
+                    new (self) PyTiledMesh(nb::cast<trianglelite::Matrix2Fr>(points), config);
+                }
+            },
+            nb::arg("points"),
+            nb::arg("num_cols") = 0,
+            nb::arg("num_rows") = 0,
+            nb::arg("points_per_tile") = trianglelite::TilingConfig().points_per_tile,
+            nb::arg("border_spacing") = 0,
+            nb::arg("num_threads") = 0,
+            R"(Split the bounding box of `points` into `num_cols` x `num_rows` tiles,
+or tiles of about `points_per_tile` points if either is not positive.  Border
+points are spaced by `border_spacing` if positive, or else by the edge length
+of an equilateral triangle of `config.max_area`, or by the average point
+spacing.  A C-contiguous float32 `points` array is kept in single precision,
+halving the memory taken by the copy of the input.)")
+        .def_prop_ro("num_tiles",
+            [](const PyTiledMesh& self) { return self.mesh.get_num_tiles(); })
+        .def(
+            "run",
+            [](PyTiledMesh& self, const trianglelite::Config& config) {
+                nb::gil_scoped_release release;
+                self.mesh.run(config);
+            },
+            nb::arg("config"),
+            "Place the tile borders and mesh all tiles concurrently.")
+        .def(
+            "run_tile",
+            [](PyTiledMesh& self, trianglelite::Index tile, const trianglelite::Config& config) {
+                nb::gil_scoped_release release;
+                self.mesh.run_tile(tile, config);
+            },
+            nb::arg("tile"),
+            nb::arg("config"),
+            "Mesh one tile again, keeping its borders.")
+        .def(
+            "get_tile",
+            [](const PyTiledMesh& self, trianglelite::Index tile) {
+                return batch_output(self.mesh.get_tile(tile));
+            },
+            nb::arg("tile"),
+            R"(Mesh of one tile, with its own point indices, as a dict of NumPy arrays
+(see `triangulate_many`).  Tiles are numbered row by row.)")
+        .def(
+            "get_tile_point_ids",
+            [](const PyTiledMesh& self, trianglelite::Index tile) {
+                using Indices = std::vector<trianglelite::LargeIndex>;
+                auto* owner = new Indices(self.mesh.get_tile_point_ids(tile));
+                nb::capsule capsule(
+                    owner, [](void* ptr) noexcept { delete static_cast<Indices*>(ptr); });
+                const size_t shape[1] = {owner->size()};
+                return nb::ndarray<nb::numpy, trianglelite::LargeIndex>(
+                    owner->data(), 1, shape, capsule);
+            },
+            nb::arg("tile"),
+            "Index in the welded mesh (int64) of each output point of one tile.")
+        .def(
+            "weld",
+            [](const PyTiledMesh& self) {
+                trianglelite::Matrix2Fr points;
+                trianglelite::Matrix3Ir triangles;
+                self.mesh.weld(points, triangles);
+                nb::dict output;
+                output["points"] = nb::cast(std::move(points));
+                output["triangles"] = nb::cast(std::move(triangles));
+                return output;
+            },
+            R"(Weld the tiles into a single mesh, returned as a dict with "points" and
+"triangles".  Input points come first, in order.)")
+        .def(
+            "weld_to_file",
+            [](const PyTiledMesh& self, const std::string& triangles_file) {
+                std::vector<trianglelite::Scalar> steiner_points;
+                trianglelite::LargeIndex num_triangles = 0;
+                {
+                    nb::gil_scoped_release release;
+                    trianglelite::TriangleFileWriter writer(triangles_file);
+                    num_triangles = self.mesh.weld(writer, steiner_points);
+                }
+                const auto num_steiner = static_cast<Eigen::Index>(steiner_points.size() / 2);
+                nb::dict output;
+                output["num_triangles"] = num_triangles;
+                output["steiner_points"] = nb::cast(trianglelite::Matrix2Fr(
+                    trianglelite::Matrix2FrMap(steiner_points.data(), num_steiner, 2)));
+                return output;
+            },
+            nb::arg("triangles_file"),
+            R"(Weld the tiles into a single mesh with 64-bit indices, for meshes beyond
+2^31 elements.  Triangles are written to `triangles_file` as raw int64 index
+triples (see `stream_delaunay`).  Returns a dict with "num_triangles" and
+"steiner_points", the welded points that follow the input points.)");
+
+    m.def(
+        "stream_delaunay",
+        [](const std::string& points_file,
+            const std::string& triangles_file,
+            trianglelite::Index points_per_tile,
+            trianglelite::LargeIndex max_points_in_memory,
+            trianglelite::Scalar margin,
+            trianglelite::Index num_threads,
+            const std::string& dtype) {
+            trianglelite::CoordinateType coordinate_type;
+            if (dtype == "float64") {
+                coordinate_type = trianglelite::CoordinateType::FLOAT64;
+            } else if (dtype == "float32") {
+                coordinate_type = trianglelite::CoordinateType::FLOAT32;
+            } else {
+                throw nb::value_error("`dtype` must be \"float64\" or \"float32\"");
+            }
+            trianglelite::StreamingConfig config;
+            config.points_per_tile = points_per_tile;
+            config.max_points_in_memory = max_points_in_memory;
+            config.margin = margin;
+            config.num_threads = num_threads;
+            nb::gil_scoped_release release;
+            trianglelite::MappedPointFile points(points_file, coordinate_type);
+            trianglelite::TriangleFileWriter writer(triangles_file);
+            return trianglelite::stream_delaunay(points, writer, config);
+        },
+        nb::arg("points_file"),
+        nb::arg("triangles_file"),
+        nb::arg("points_per_tile") = trianglelite::StreamingConfig().points_per_tile,
+        nb::arg("max_points_in_memory") = trianglelite::StreamingConfig().max_points_in_memory,
+        nb::arg("margin") = trianglelite::StreamingConfig().margin,
+        nb::arg("num_threads") = 0,
+        nb::arg("dtype") = numpy_dtype<trianglelite::Scalar>(),
+        R"(Delaunay triangulation of a point set that does not need to fit in memory.
+
+`points_file` holds raw (x, y) pairs of type `dtype`, "float64" or "float32",
+e.g. written with `points.astype(np.float32).tofile(points_file)`.  Single
+precision files take half the space and bandwidth; points are meshed in
+double precision (single for single precision builds) either way.  The
+triangles are written to `triangles_file` as raw int64 index triples, to be
+read back with `np.fromfile(triangles_file, dtype=np.int64).reshape(-1, 3)`.  At most about
+`max_points_in_memory` points are loaded at once, in tiles of about
+`points_per_tile` points overlapping by `margin` times the tile size; larger
+inputs are spilled batch by batch to a temporary file.
+
+Returns the number of triangles written.)");
 }
@@ -0,0 +1,41 @@
+#include <trianglelite/Batch.h>
+#include "parallel_for.h"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using namespace trianglelite;
+
+namespace {
+
+size_t get_job_size(Engine& engine)
+{
+    return static_cast<size_t>(engine.get_in_points().rows()) +
+           static_cast<size_t>(engine.get_in_segments().rows()) +
+           static_cast<size_t>(engine.get_in_triangles().rows());
+}
+
+} // namespace
+
+namespace trianglelite {
+
+void run_batch(Engine* engines, Index num_engines, const Config& config, Index num_threads)
+{
+    if (num_engines <= 0) return;
+
+    // Largest jobs first so that the tail of the batch is made of small jobs.
+    std::vector<size_t> job_sizes(num_engines);
+    for (Index i = 0; i < num_engines; i++) {
+        job_sizes[i] = get_job_size(engines[i]);
+    }
+    std::vector<Index> order(num_engines);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](Index i, Index j) {
+        return job_sizes[i] > job_sizes[j];
+    });
+
+    parallel_for(num_engines, num_threads, [&](Index k) { engines[order[k]].run(config); });
+}
+
+} // namespace trianglelite
@@ -0,0 +1,181 @@
+#include "BufferCache.h"
+#include "RunStatsScope.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace trianglelite {
+
+namespace {
+
+// Block layout: [header | user data].  The header keeps user data maximally aligned.
+constexpr size_t header_size = alignof(std::max_align_t) > sizeof(size_t)
+                                   ? alignof(std::max_align_t)
+                                   : sizeof(size_t);
+
+thread_local BufferCache* t_current_cache = nullptr;
+
+inline void* to_block(void* ptr)
+{
+    return static_cast<char*>(ptr) - header_size;
+}
+
+inline void* to_user(void* block)
+{
+    return static_cast<char*>(block) + header_size;
+}
+
+} // namespace
+
+BufferCache::~BufferCache()
+{
+    trim();
+}
+
+void* BufferCache::allocate_block(size_t size)
+{
+    void* block = std::malloc(size + header_size);
+    if (block == nullptr) throw std::bad_alloc();
+    *static_cast<size_t*>(block) = size;
+    return to_user(block);
+}
+
+void BufferCache::free_block(void* ptr)
+{
+    if (ptr == nullptr) return;
+    std::free(to_block(ptr));
+}
+
+size_t BufferCache::get_capacity(const void* ptr)
+{
+    return *static_cast<const size_t*>(to_block(const_cast<void*>(ptr)));
+}
+
+void* BufferCache::allocate(size_t size)
+{
+    if (m_enabled) {
+        // Best fit, as long as no more than half of the block is wasted.
+        auto itr = std::lower_bound(m_blocks.begin(),
+            m_blocks.end(),
+            size,
+            [](const std::pair<size_t, void*>& entry, size_t s) { return entry.first < s; });
+        if (itr != m_blocks.end() && itr->first / 2 <= size) {
+            void* ptr = itr->second;
+            m_blocks.erase(itr);
+            return ptr;
+        }
+    }
+    return allocate_block(size);
+}
+
+void BufferCache::release(void* ptr)
+{
+    if (ptr == nullptr) return;
+    if (!m_enabled) {
+        free_block(ptr);
+        return;
+    }
+
+    const size_t capacity = get_capacity(ptr);
+    auto itr = std::upper_bound(m_blocks.begin(),
+        m_blocks.end(),
+        capacity,
+        [](size_t c, const std::pair<size_t, void*>& entry) { return c < entry.first; });
+    m_blocks.emplace(itr, capacity, ptr);
+}
+
+void BufferCache::set_enabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (!enabled) trim();
+}
+
+void BufferCache::trim()
+{
+    for (auto& entry : m_blocks) {
+        free_block(entry.second);
+    }
+    m_blocks.clear();
+    m_blocks.shrink_to_fit();
+}
+
+size_t BufferCache::get_cached_bytes() const
+{
+    size_t total = 0;
+    for (const auto& entry : m_blocks) {
+        total += entry.first;
+    }
+    return total;
+}
+
+BufferCache::Scope::Scope(BufferCache& cache)
+    : m_previous(t_current_cache)
+{
+    t_current_cache = &cache;
+}
+
+BufferCache::Scope::~Scope()
+{
+    t_current_cache = m_previous;
+}
+
+BufferCache* BufferCache::get_current()
+{
+    return t_current_cache;
+}
+
+} // namespace trianglelite
+
+//================== Triangle allocation hooks ========================
+// See `triangle_prelude.h`.  Triangle reports allocation failures through null pointers, so no
+// exception may escape into C code.
+
+using trianglelite::BufferCache;
+using trianglelite::RunStatsScope;
+
+extern "C" void* trianglelite_malloc(size_t size)
+{
+    void* ptr = nullptr;
+    try {
+        BufferCache* cache = BufferCache::get_current();
+        ptr = cache != nullptr ? cache->allocate(size) : BufferCache::allocate_block(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+    RunStatsScope* stats = RunStatsScope::get_current();
+    if (stats != nullptr) stats->allocate(BufferCache::get_capacity(ptr));
+    return ptr;
+}
+
+extern "C" void* trianglelite_calloc(size_t count, size_t size)
+{
+    void* ptr = trianglelite_malloc(count * size);
+    if (ptr != nullptr) std::memset(ptr, 0, count * size);
+    return ptr;
+}
+
+extern "C" void trianglelite_free(void* ptr)
+{
+    RunStatsScope* stats = RunStatsScope::get_current();
+    if (stats != nullptr && ptr != nullptr) stats->free(BufferCache::get_capacity(ptr));
+    BufferCache* cache = BufferCache::get_current();
+    if (cache != nullptr) {
+        cache->release(ptr);
+    } else {
+        BufferCache::free_block(ptr);
+    }
+}
+
+extern "C" void* trianglelite_realloc(void* ptr, size_t size)
+{
+    if (ptr == nullptr) return trianglelite_malloc(size);
+    if (BufferCache::get_capacity(ptr) >= size) return ptr;
+
+    void* new_ptr = trianglelite_malloc(size);
+    if (new_ptr == nullptr) return nullptr;
+    std::memcpy(new_ptr, ptr, BufferCache::get_capacity(ptr));
+    trianglelite_free(ptr);
+    return new_ptr;
+}
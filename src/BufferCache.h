@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace trianglelite {
+
+/**
+ * Recycles the memory blocks allocated by Triangle.
+ *
+ * Every block handed to Triangle carries a small header recording its capacity, so that released
+ * blocks can be reused for later requests of similar size.  When caching is enabled, memory
+ * released by one run (internal pools as well as the previous output arrays) serves the next run,
+ * so repeated runs on similar inputs reach a steady state without heap allocation.
+ *
+ * Blocks are plain `malloc` memory, so any block can also be freed with `free_block` regardless
+ * of the cache it came from.
+ */
+class BufferCache
+{
+public:
+    BufferCache() = default;
+    ~BufferCache();
+    BufferCache(const BufferCache&) = delete;
+    BufferCache& operator=(const BufferCache&) = delete;
+
+public:
+    void* allocate(size_t size);
+    void release(void* ptr);
+
+    /**
+     * Enable or disable caching.  Disabling caching frees all cached blocks.
+     */
+    void set_enabled(bool enabled);
+    bool is_enabled() const { return m_enabled; }
+
+    /**
+     * Free all cached blocks.
+     */
+    void trim();
+
+    /**
+     * Total size of the cached blocks in bytes.
+     */
+    size_t get_cached_bytes() const;
+
+public:
+    /**
+     * Allocate a block without any cache.
+     */
+    static void* allocate_block(size_t size);
+
+    /**
+     * Free a block directly, bypassing any cache.
+     */
+    static void free_block(void* ptr);
+
+    /**
+     * Capacity of a block in bytes.
+     */
+    static size_t get_capacity(const void* ptr);
+
+    /**
+     * RAII helper that routes Triangle's allocations on the current thread through a cache.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(BufferCache& cache);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        BufferCache* m_previous;
+    };
+
+    /**
+     * Cache used by Triangle's allocations on the current thread, or null.
+     */
+    static BufferCache* get_current();
+
+private:
+    bool m_enabled = false;
+    std::vector<std::pair<size_t, void*>> m_blocks; // (capacity, block) sorted by capacity.
+};
+
+} // namespace trianglelite
@@ -0,0 +1,172 @@
+#include "Circumcircle.h"
+#include "predicates.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace trianglelite {
+
+namespace {
+
+// Points tested at once with the batch predicates before checking for an early exit.
+constexpr Index batch_size = 64;
+
+} // namespace
+
+bool compute_circumcircle(const Scalar* a, const Scalar* b, const Scalar* c, Circle& circle)
+{
+    const double bx = double(b[0]) - a[0], by = double(b[1]) - a[1];
+    const double cx = double(c[0]) - a[0], cy = double(c[1]) - a[1];
+    const double bxcy = bx * cy;
+    const double bycx = by * cx;
+    const double det = bxcy - bycx;
+    if (det == 0) return false;
+
+    const double b2 = bx * bx + by * by;
+    const double c2 = cx * cx + cy * cy;
+    const double ux = (cy * b2 - by * c2) / (2 * det);
+    const double uy = (bx * c2 - cx * b2) / (2 * det);
+    circle.x = a[0] + ux;
+    circle.y = a[1] + uy;
+    circle.r = std::sqrt(ux * ux + uy * uy);
+
+    // Generous bound covering the rounding of the inputs and the cancellation in `det`.
+    const double condition = (std::abs(bxcy) + std::abs(bycx)) / std::abs(det);
+    circle.error =
+        1e-12 * condition * (circle.r + std::abs(double(a[0])) + std::abs(double(a[1])));
+    return std::isfinite(circle.r) && std::isfinite(circle.error);
+}
+
+bool has_triangle(const Scalar* points, Index num_points)
+{
+    if (num_points < 3) return false;
+    Index i = 1;
+    while (i < num_points && points[i * 2] == points[0] && points[i * 2 + 1] == points[1]) i++;
+    int signs[batch_size];
+    for (Index j = i + 1; j < num_points; j += batch_size) {
+        const Index count = std::min(batch_size, num_points - j);
+        predicates::orient2d_batch(points, points + i * 2, points + j * 2, count, signs);
+        if (std::any_of(signs, signs + count, [](int s) { return s != 0; })) return true;
+    }
+    return false;
+}
+
+Config get_serial_delaunay_config()
+{
+    Config config;
+    config.min_angle = 0;
+    config.verbose_level = 0;
+    config.algorithm = Algorithm::DIVIDE_AND_CONQUER;
+    config.output_flags = OUTPUT_TRIANGLES | OUTPUT_NEIGHBORS;
+    return config;
+}
+
+double signed_area(const Scalar* a, const Scalar* b, const Scalar* c)
+{
+    return ((double(b[0]) - a[0]) * (double(c[1]) - a[1]) -
+               (double(b[1]) - a[1]) * (double(c[0]) - a[0])) /
+           2;
+}
+
+double checked_area(const Scalar* a, const Scalar* b, const Scalar* c)
+{
+    const double area = signed_area(a, b, c);
+    if (area <= 0 && predicates::orient2d(a, b, c) <= 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return area;
+}
+
+void PointGrid::build(const Scalar* points, Index num_points)
+{
+    m_points.clear();
+    m_offsets.assign(1, 0);
+    if (num_points == 0) return;
+
+    double min_x = points[0], max_x = points[0];
+    double min_y = points[1], max_y = points[1];
+    for (Index i = 1; i < num_points; i++) {
+        min_x = std::min<double>(min_x, points[i * 2]);
+        max_x = std::max<double>(max_x, points[i * 2]);
+        min_y = std::min<double>(min_y, points[i * 2 + 1]);
+        max_y = std::max<double>(max_y, points[i * 2 + 1]);
+    }
+
+    // About two points per cell.
+    const double width = max_x - min_x;
+    const double height = max_y - min_y;
+    const double num_cells = std::max(1.0, num_points / 2.0);
+    double cell_size = std::sqrt(width * height / num_cells);
+    if (!(cell_size > 0)) cell_size = std::max(width, height) / num_cells;
+    if (!(cell_size > 0)) cell_size = 1;
+    m_min_x = min_x;
+    m_min_y = min_y;
+    m_cell_size = cell_size;
+    m_num_cols = static_cast<Index>(std::min(width / cell_size, num_cells)) + 1;
+    m_num_rows = static_cast<Index>(std::min(height / cell_size, num_cells)) + 1;
+
+    // Counting sort of the points by cell.
+    std::vector<Index> cells(num_points);
+    m_offsets.assign(static_cast<size_t>(m_num_cols) * m_num_rows + 1, 0);
+    for (Index i = 0; i < num_points; i++) {
+        const Index col = clamp_col((points[i * 2] - m_min_x) / m_cell_size);
+        const Index row = clamp_row((points[i * 2 + 1] - m_min_y) / m_cell_size);
+        cells[i] = row * m_num_cols + col;
+        m_offsets[cells[i] + 1]++;
+    }
+    std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+    std::vector<Index> cursor(m_offsets.begin(), m_offsets.end() - 1);
+    m_points.resize(static_cast<size_t>(num_points) * 2);
+    for (Index i = 0; i < num_points; i++) {
+        const Index j = cursor[cells[i]]++;
+        m_points[j * 2] = points[i * 2];
+        m_points[j * 2 + 1] = points[i * 2 + 1];
+    }
+}
+
+bool PointGrid::has_point_inside(
+    const Scalar* a, const Scalar* b, const Scalar* c, const Circle& circle) const
+{
+    if (m_points.empty()) return false;
+
+    const double r = circle.r + circle.error;
+    const double row_begin = (circle.y - r - m_min_y) / m_cell_size;
+    const double row_end = (circle.y + r - m_min_y) / m_cell_size;
+    if (row_end < 0 || row_begin >= m_num_rows) return false;
+
+    for (Index row = clamp_row(row_begin); row <= clamp_row(row_end); row++) {
+        // Extent of the disk over the rows of the cell.
+        const double y0 = m_min_y + row * m_cell_size;
+        const double y1 = y0 + m_cell_size;
+        const double dy = circle.y < y0 ? y0 - circle.y : (circle.y > y1 ? circle.y - y1 : 0);
+        if (dy > r) continue;
+        const double half_width = std::sqrt(r * r - dy * dy);
+        const double col_begin = (circle.x - half_width - m_min_x) / m_cell_size;
+        const double col_end = (circle.x + half_width - m_min_x) / m_cell_size;
+        if (col_end < 0 || col_begin >= m_num_cols) continue;
+
+        const Index first = m_offsets[row * m_num_cols + clamp_col(col_begin)];
+        const Index last = m_offsets[row * m_num_cols + clamp_col(col_end) + 1];
+        int signs[batch_size];
+        for (Index i = first; i < last; i += batch_size) {
+            const Index count = std::min(batch_size, last - i);
+            predicates::incircle_batch(a, b, c, m_points.data() + i * 2, count, signs);
+            if (std::any_of(signs, signs + count, [](int s) { return s > 0; })) return true;
+        }
+    }
+    return false;
+}
+
+Index PointGrid::clamp_col(double col) const
+{
+    return static_cast<Index>(std::max(0.0, std::min<double>(col, m_num_cols - 1)));
+}
+
+Index PointGrid::clamp_row(double row) const
+{
+    return static_cast<Index>(std::max(0.0, std::min<double>(row, m_num_rows - 1)));
+}
+
+} // namespace trianglelite
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <trianglelite/Config.h>
+#include <trianglelite/common.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace trianglelite {
+
+/**
+ * Circumcircle of a triangle, along with a bound on the error of its center and radius.
+ */
+struct Circle
+{
+    double x, y, r;
+    double error;
+};
+
+/**
+ * Compute the circumcircle of (a, b, c) relative to `a`.  Callers pass the vertex with the
+ * smallest index as `a` so that every evaluation for a given triangle gives the same result.
+ *
+ * @returns false if the triangle is degenerate.
+ */
+bool compute_circumcircle(const Scalar* a, const Scalar* b, const Scalar* c, Circle& circle);
+
+/**
+ * Whether the points span a 2D region, i.e. triangle would output at least one triangle.
+ */
+bool has_triangle(const Scalar* points, Index num_points);
+
+/**
+ * Configuration of the serial Delaunay triangulations that the parallel and streaming algorithms
+ * are built from: triangles and neighbors only.  Output indices follow input order, so local
+ * triangles canonicalized with `canonicalize` match their canonical input triangles.
+ */
+Config get_serial_delaunay_config();
+
+/**
+ * Signed area of (a, b, c), positive if counterclockwise.
+ */
+double signed_area(const Scalar* a, const Scalar* b, const Scalar* c);
+
+/**
+ * Area of the triangle (a, b, c) of a triangulation, or NaN if it is inverted, so that the sanity
+ * check on the total area of a merged triangulation also catches inverted triangles.
+ */
+double checked_area(const Scalar* a, const Scalar* b, const Scalar* c);
+
+/**
+ * Rotate a counterclockwise triangle so that its smallest index comes first.
+ */
+template <typename T>
+void canonicalize(T* t)
+{
+    std::rotate(t, std::min_element(t, t + 3), t + 3);
+}
+
+/**
+ * Uniform grid over a set of points, answering empty circle queries.
+ */
+class PointGrid
+{
+public:
+    void build(const Scalar* points, Index num_points);
+
+    /**
+     * Whether a point lies strictly inside the circumcircle of the counterclockwise triangle
+     * (a, b, c), whose (approximate) circumcircle is `circle`.
+     */
+    bool has_point_inside(
+        const Scalar* a, const Scalar* b, const Scalar* c, const Circle& circle) const;
+
+private:
+    Index clamp_col(double col) const;
+    Index clamp_row(double row) const;
+
+private:
+    double m_min_x = 0;
+    double m_min_y = 0;
+    double m_cell_size = 1;
+    Index m_num_cols = 0;
+    Index m_num_rows = 0;
+    std::vector<Index> m_offsets; // Row major cells, CSR offsets into m_points.
+    std::vector<Scalar> m_points; // Sorted by cell.
+};
+
+} // namespace trianglelite
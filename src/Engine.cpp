@@ -1,15 +1,28 @@
 #include <trianglelite/Engine.h>
+#include "BufferCache.h"
+#include "LiveMesh.h"
+#include "MeshOrdering.h"
+#include "OutputSinkScope.h"
+#include "ParallelDelaunay.h"
+#include "ParallelRefinement.h"
+#include "RunStatsScope.h"
+#include "SegmentMarkers.h"
+#include "parallel_for.h"
+#include "SegmentGrid.h"
+#include "SpatialSort.h"
 #ifdef WITH_MSHIO
 #include <mshio/mshio.h>
 #endif
 
-#include <array>
+#include <algorithm>
 #include <exception>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <numeric>
-#include <set>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #define VOID void
@@ -23,19 +36,32 @@ using namespace trianglelite;
 
 namespace {
 
-void clear_triangulateio(triangulateio& io)
+/**
+ * Release the output arrays of `io`.  They are allocated by triangle through the hooks in
+ * `triangle_prelude.h`, so they must be handed back to `buffers` (or freed as `BufferCache`
+ * blocks if it is null) rather than deleted.
+ */
+void clear_triangulateio(triangulateio& io, BufferCache* buffers)
 {
+    auto release = [buffers](void* ptr) {
+        if (buffers != nullptr) {
+            buffers->release(ptr);
+        } else {
+            BufferCache::free_block(ptr);
+        }
+    };
+
     // Points.
     if (io.pointlist != nullptr) {
-        delete[] io.pointlist;
+        release(io.pointlist);
         io.pointlist = nullptr;
     }
     if (io.pointmarkerlist != nullptr) {
-        delete[] io.pointmarkerlist;
+        release(io.pointmarkerlist);
         io.pointmarkerlist = nullptr;
     }
     if (io.pointattributelist != nullptr) {
-        delete[] io.pointattributelist;
+        release(io.pointattributelist);
         io.pointattributelist = nullptr;
     }
     io.numberofpoints = 0;
@@ -43,19 +69,19 @@ void clear_triangulateio(triangulateio& io)
 
     // Triangles.
     if (io.trianglelist != nullptr) {
-        delete[] io.trianglelist;
+        release(io.trianglelist);
         io.trianglelist = nullptr;
     }
     if (io.trianglearealist != nullptr) {
-        delete[] io.trianglearealist;
+        release(io.trianglearealist);
         io.trianglearealist = nullptr;
     }
     if (io.triangleattributelist != nullptr) {
-        delete[] io.triangleattributelist;
+        release(io.triangleattributelist);
         io.triangleattributelist = nullptr;
     }
     if (io.neighborlist != nullptr) {
-        delete[] io.neighborlist;
+        release(io.neighborlist);
         io.neighborlist = nullptr;
     }
     io.numberoftriangles = 0;
@@ -64,22 +90,22 @@ void clear_triangulateio(triangulateio& io)
 
     // Segments.
     if (io.segmentlist != nullptr) {
-        delete[] io.segmentlist;
+        release(io.segmentlist);
         io.segmentlist = nullptr;
     }
     if (io.segmentmarkerlist != nullptr) {
-        delete[] io.segmentmarkerlist;
+        release(io.segmentmarkerlist);
         io.segmentmarkerlist = nullptr;
     }
     io.numberofsegments = 0;
 
     // Edges.
     if (io.edgelist != nullptr) {
-        delete[] io.edgelist;
+        release(io.edgelist);
         io.edgelist = nullptr;
     }
     if (io.edgemarkerlist != nullptr) {
-        delete[] io.edgemarkerlist;
+        release(io.edgemarkerlist);
         io.edgemarkerlist = nullptr;
     }
     io.numberofedges = 0;
@@ -98,7 +124,7 @@ void clear_triangulateio(triangulateio& io)
     //}
     // io.numberofregions = 0;
     if (io.normlist != nullptr) {
-        delete[] io.normlist;
+        release(io.normlist);
         io.normlist = nullptr;
     }
 }
@@ -130,21 +156,57 @@ void initialize_triangulateio(triangulateio& io)
     io.normlist = nullptr;
 }
 
-std::string generate_command_line_options(const triangulateio& io, const Config& config)
+/**
+ * Create an empty output.  Its arrays are freed along with it, so that it can outlive the engine
+ * when shared through `Engine::get_out_owner()`.
+ */
+std::shared_ptr<triangulateio> make_output()
+{
+    auto io = std::shared_ptr<triangulateio>(new triangulateio, [](triangulateio* ptr) {
+        clear_triangulateio(*ptr, nullptr);
+        delete ptr;
+    });
+    initialize_triangulateio(*io);
+    return io;
+}
+
+/**
+ * Translate `config` into triangle's command line switches.
+ *
+ * @param refine_pslg  Refine the input triangles while respecting the input segments (i.e. `rp`).
+ *                     By default, input triangles are ignored when segments are provided.
+ */
+std::string generate_command_line_options(
+    const triangulateio& io, const Config& config, bool refine_pslg = false)
 {
     // Basic flag:
     //   z: index starts from zero.
+    std::string opt = "z";
+
+    // Output selection:
     //   n: output triangle neighbor info.
     //   e: output edge list.
-    std::string opt = "zne";
+    //   B: no boundary markers.
+    //   P: no output segments.
+    //   N: no output points.
+    //   E: no output triangles.
+    if (config.output_flags & OUTPUT_NEIGHBORS) opt += "n";
+    if (config.output_flags & OUTPUT_EDGES) opt += "e";
+    if (!(config.output_flags & OUTPUT_MARKERS)) opt += "B";
+    if (!(config.output_flags & OUTPUT_SEGMENTS)) opt += "P";
+    if (!(config.output_flags & OUTPUT_POINTS)) opt += "N";
+    if (!(config.output_flags & OUTPUT_TRIANGLES)) opt += "E";
 
     if (io.numberofpoints == 0) {
         throw std::runtime_error("Empty input detected for triangulation");
+    } else if (refine_pslg) {
+        opt += "rp"; // Refinement with segment constraints.
     } else if (io.numberofsegments > 0) {
         opt += "p"; // Triangulate PSLG.
     } else if (io.numberoftriangles > 0) {
         opt += "r"; // Refinement.
-    } else {
+    }
+    if (config.voronoi) {
         opt += "v"; // Also compute Voronoi diagram.
     }
 
@@ -202,6 +264,7 @@ std::string generate_command_line_options(const triangulateio& io, const Config&
     }
     switch (config.algorithm) {
     case Algorithm::DIVIDE_AND_CONQUER: break;
+    case Algorithm::PARALLEL_DIVIDE_AND_CONQUER: break; // Serial fallback (see `Engine::run`).
     case Algorithm::SWEEPLINE: opt += "F"; break;
     case Algorithm::INCREMENTAL: opt += "i"; break;
     default: throw std::runtime_error("Unknown triangulation algorithm");
@@ -209,6 +272,62 @@ std::string generate_command_line_options(const triangulateio& io, const Config&
     return opt;
 }
 
+/**
+ * Triangle reports element counts even for output arrays that are not generated (see
+ * `Config::output_flags`).  Treat such arrays as empty.
+ */
+Index num_rows(const void* data, Index count)
+{
+    return data == nullptr ? 0 : count;
+}
+
+/**
+ * Move row `i` of the `num_rows` x `stride` array `data` to row `new_index[i]`.
+ */
+template <typename T>
+void permute_rows(T* data, Index num_rows, Index stride, const std::vector<Index>& new_index)
+{
+    if (data == nullptr || stride <= 0) return;
+    const std::vector<T> rows(data, data + static_cast<size_t>(num_rows) * stride);
+    for (Index i = 0; i < num_rows; i++) {
+        std::copy(&rows[static_cast<size_t>(i) * stride],
+            &rows[static_cast<size_t>(i + 1) * stride],
+            data + static_cast<size_t>(new_index[i]) * stride);
+    }
+}
+
+/**
+ * Replace the `count` indices of `data` by their new values, leaving negative ones (i.e. missing
+ * neighbors and infinite Voronoi rays) as they are.
+ */
+void remap_indices(Index* data, size_t count, const std::vector<Index>& new_index)
+{
+    if (data == nullptr) return;
+    for (size_t i = 0; i < count; i++) {
+        if (data[i] >= 0) data[i] = new_index[data[i]];
+    }
+}
+
+/**
+ * Rank of each element in `order`, i.e. the inverse permutation.
+ */
+std::vector<Index> invert_order(const std::vector<Index>& order)
+{
+    std::vector<Index> rank(order.size());
+    for (size_t i = 0; i < order.size(); i++) rank[order[i]] = static_cast<Index>(i);
+    return rank;
+}
+
+// Number of coarse triangles per subdomain of `Engine::run_parallel_refinement`, for balance.
+constexpr Index coarse_triangles_per_subdomain = 64;
+
+// Rings of neighbors added around the triangles refined by `Engine::refine_interfaces`, so that
+// they are away from the boundary of the band, which cannot be split.
+constexpr Index band_rings = 2;
+
+// Number of band refinements tried by `Engine::refine_interfaces` before giving up.
+constexpr Index max_band_rounds = 4;
+
 #ifdef WITH_MSHIO
 void debug_save(const std::string& filename,
     const trianglelite::Engine& engine,
@@ -278,22 +397,34 @@ void debug_save(const std::string& filename,
 
 } // namespace
 
+struct Engine::AutoHoleMesh
+{
+    std::vector<Index> triangles; // Row major, 3 indices per triangle.
+    std::vector<Index> segments; // Row major, 2 indices per segment.
+    std::vector<int> segment_ids; // Input segment each segment comes from.
+};
+
 Engine::Engine()
 {
     m_in = std::make_unique<triangulateio>();
-    m_out = std::make_unique<triangulateio>();
-    m_vorout = std::make_unique<triangulateio>();
+    m_out = make_output();
+    m_vorout = make_output();
+    m_buffers = std::make_unique<BufferCache>();
     initialize_triangulateio(*m_in);
-    initialize_triangulateio(*m_out);
-    initialize_triangulateio(*m_vorout);
 }
 
-Engine::~Engine()
+// m_in's memory is mamanged by user.  m_out and m_vorout free their arrays once they are no
+// longer shared (see `make_output`).
+Engine::~Engine() = default;
+
+Engine::Engine(Engine&&) = default;
+
+Engine& Engine::operator=(Engine&&) = default;
+
+std::shared_ptr<const void> Engine::get_out_owner() const
 {
-    // m_in's memory is mamanged by user.
-    // However, m_out and m_vorout need to be cleaned.
-    clear_triangulateio(*m_out);
-    clear_triangulateio(*m_vorout);
+    return std::make_shared<std::pair<std::shared_ptr<triangulateio>,
+        std::shared_ptr<triangulateio>>>(m_out, m_vorout);
 }
 
 void Engine::set_in_points(const Scalar* points, Index num_points)
@@ -423,65 +554,492 @@ void Engine::unset_in_segment_markers()
 
 const Matrix2FrMap Engine::get_out_points() const
 {
-    return Matrix2FrMap(m_out->pointlist, m_out->numberofpoints, 2);
+    return Matrix2FrMap(m_out->pointlist, num_rows(m_out->pointlist, m_out->numberofpoints), 2);
 }
 
 const Matrix3IrMap Engine::get_out_triangles() const
 {
-    return Matrix3IrMap(m_out->trianglelist, m_out->numberoftriangles, 3);
+    return Matrix3IrMap(
+        m_out->trianglelist, num_rows(m_out->trianglelist, m_out->numberoftriangles), 3);
 }
 
 const Matrix2IrMap Engine::get_out_segments() const
 {
-    return Matrix2IrMap(m_out->segmentlist, m_out->numberofsegments, 2);
+    return Matrix2IrMap(
+        m_out->segmentlist, num_rows(m_out->segmentlist, m_out->numberofsegments), 2);
 }
 
 const Matrix2IrMap Engine::get_out_edges() const
 {
-    return Matrix2IrMap(m_out->edgelist, m_out->numberofedges, 2);
+    return Matrix2IrMap(m_out->edgelist, num_rows(m_out->edgelist, m_out->numberofedges), 2);
 }
 
 const Matrix3IrMap Engine::get_out_triangle_neighbors() const
 {
-    return Matrix3IrMap(m_out->neighborlist, m_out->numberoftriangles, 3);
+    return Matrix3IrMap(
+        m_out->neighborlist, num_rows(m_out->neighborlist, m_out->numberoftriangles), 3);
 }
 
 const Matrix1IMap Engine::get_out_point_markers() const
 {
-    return Matrix1IMap(m_out->pointmarkerlist, m_out->numberofpoints);
+    return Matrix1IMap(
+        m_out->pointmarkerlist, num_rows(m_out->pointmarkerlist, m_out->numberofpoints));
 }
 
 const Matrix1IMap Engine::get_out_segment_markers() const
 {
-    return Matrix1IMap(m_out->segmentmarkerlist, m_out->numberofsegments);
+    return Matrix1IMap(
+        m_out->segmentmarkerlist, num_rows(m_out->segmentmarkerlist, m_out->numberofsegments));
 }
 
 const Matrix1IMap Engine::get_out_edge_markers() const
 {
-    return Matrix1IMap(m_out->edgemarkerlist, m_out->numberofedges);
+    return Matrix1IMap(
+        m_out->edgemarkerlist, num_rows(m_out->edgemarkerlist, m_out->numberofedges));
+}
+
+const Matrix2FrMap Engine::get_voronoi_points() const
+{
+    return Matrix2FrMap(
+        m_vorout->pointlist, num_rows(m_vorout->pointlist, m_vorout->numberofpoints), 2);
+}
+
+const Matrix2IrMap Engine::get_voronoi_edges() const
+{
+    return Matrix2IrMap(
+        m_vorout->edgelist, num_rows(m_vorout->edgelist, m_vorout->numberofedges), 2);
+}
+
+const Matrix2FrMap Engine::get_voronoi_normals() const
+{
+    return Matrix2FrMap(
+        m_vorout->normlist, num_rows(m_vorout->normlist, m_vorout->numberofedges), 2);
 }
 
 void Engine::run(const Config& config)
 {
+    run(config, nullptr);
+}
+
+void Engine::run(const Config& config, OutputSink& sink)
+{
+    run(config, &sink);
+}
+
+void Engine::insert_points(const Scalar* points, Index num_points)
+{
+    LiveMesh& mesh = get_live_mesh();
+    for (Index i = 0; i < num_points; i++) mesh.insert_point(points + static_cast<size_t>(i) * 2);
+}
+
+void Engine::remove_point(Index point)
+{
+    get_live_mesh().remove_point(point);
+}
+
+RefinementDelta Engine::refine_triangles(
+    const Index* triangles, Index num_triangles, const Config& config)
+{
+    LiveMesh& mesh = get_live_mesh();
+    const Region region = mesh.extract_region(triangles, num_triangles);
+    if (region.triangle_ids.empty()) return {};
+
+    // Refine the region on its own, without splitting its boundary so that it still matches the
+    // rest of the mesh.
+    Config region_config = config;
+    region_config.split_boundary = false;
+    region_config.convex_hull = false;
+    region_config.voronoi = false;
+    region_config.reuse_buffers = false;
+    region_config.output_flags =
+        OUTPUT_POINTS | OUTPUT_TRIANGLES | OUTPUT_SEGMENTS | OUTPUT_NEIGHBORS | OUTPUT_MARKERS;
+    Engine refined;
+    refined.refine_mesh(region_config, region.mesh);
+    return mesh.splice_region(region, refined);
+}
+
+RefinementDelta Engine::refine_polygon(
+    const Scalar* polygon, Index num_vertices, const Config& config)
+{
+    const std::vector<Index> triangles = get_live_mesh().select_triangles(polygon, num_vertices);
+    return refine_triangles(triangles.data(), static_cast<Index>(triangles.size()), config);
+}
+
+void Engine::run(const Config& config, OutputSink* sink)
+{
+    // Runs nested in a run of this engine (e.g. for auto hole detection) are part of it.
+    RunStatsScope* scope = RunStatsScope::get_current();
+    if (scope != nullptr && &scope->get_stats() == &m_stats) {
+        run_stages(config, sink);
+        return;
+    }
+
+    RunStatsScope stats_scope(m_stats);
+    run_stages(config, sink);
+    m_stats.num_steiner_points = std::max(0, m_out->numberofpoints - m_in->numberofpoints);
+}
+
+void Engine::run_stages(const Config& config, OutputSink* sink)
+{
+    m_buffers->set_enabled(config.reuse_buffers);
+
+    if (config.output_order != OutputOrder::DEFAULT) {
+        run_reordered(config, sink);
+        return;
+    }
+    if (config.spatial_sort && m_in->numberofpoints > 0) {
+        run_spatially_sorted(config, sink);
+        return;
+    }
+    if (config.algorithm == Algorithm::PARALLEL_DIVIDE_AND_CONQUER &&
+        m_in->numberofsegments == 0 && m_in->numberoftriangles == 0) {
+        if (run_parallel_delaunay(config, sink)) return;
+    }
+    if (config.parallel_refinement && m_in->numberofsegments > 0 &&
+        m_in->numberoftriangles == 0 && (config.min_angle > 0 || config.max_area > 0) &&
+        !config.conforming && config.max_num_steiner < 0) {
+        if (run_parallel_refinement(config, sink)) return;
+    }
+
     std::vector<Scalar> holes;
     if (config.auto_hole_detection) {
-        holes = run_auto_hole_detection();
+        if (config.auto_hole_reuse_mesh) {
+            AutoHoleMesh mesh;
+            holes = run_auto_hole_detection(&mesh);
+            if (refine_auto_hole_mesh(config, mesh, sink)) return;
+        } else {
+            holes = run_auto_hole_detection();
+        }
         set_in_holes(holes.data(), static_cast<Index>(holes.size() / 2));
     }
 
-    // Cleanup to ensure repeated call does not leak memory.
-    clear_triangulateio(*m_out);
-    clear_triangulateio(*m_vorout);
-
-    const auto opt = generate_command_line_options(*m_in, config);
-    triangulate(const_cast<char*>(opt.c_str()), m_in.get(), m_out.get(), m_vorout.get());
+    try {
+        run_triangle(generate_command_line_options(*m_in, config), sink);
+    } catch (...) {
+        if (config.auto_hole_detection) unset_in_holes();
+        throw;
+    }
 
     if (config.auto_hole_detection) {
         unset_in_holes();
     }
 }
 
-std::vector<Scalar> Engine::run_auto_hole_detection()
+void Engine::run_triangle(const std::string& options, OutputSink* sink)
+{
+    // Memory released here, and everything triangle frees internally, is recycled by the
+    // allocations of this run when buffer reuse is enabled.
+    BufferCache::Scope scope(*m_buffers);
+    OutputSinkScope sink_scope(sink);
+    reset_output();
+    ::triangulate(const_cast<char*>(options.c_str()), m_in.get(), m_out.get(), m_vorout.get());
+    sink_scope.finalize(m_out->pointlist,
+        m_out->numberofpoints,
+        m_out->trianglelist,
+        m_out->numberoftriangles);
+}
+
+void Engine::reset_output()
+{
+    m_live.reset();
+    if (m_out.use_count() > 1) {
+        // The previous output is still in use through `get_out_owner()`.
+        m_out = make_output();
+        m_vorout = make_output();
+    } else {
+        clear_triangulateio(*m_out, m_buffers.get());
+        clear_triangulateio(*m_vorout, m_buffers.get());
+    }
+}
+
+LiveMesh& Engine::get_live_mesh()
+{
+    if (m_out->pointlist == nullptr || m_out->trianglelist == nullptr ||
+        m_out->neighborlist == nullptr) {
+        throw std::runtime_error(
+            "Editing the output requires output points, triangles and neighbors");
+    }
+
+    if (m_out.use_count() > 1) {
+        // Copy on write: the current output is still in use through `get_out_owner()`.
+        auto copy = [this](const auto* data, size_t count) {
+            using T = std::remove_const_t<std::remove_pointer_t<decltype(data)>>;
+            if (data == nullptr) return static_cast<T*>(nullptr);
+            T* result = static_cast<T*>(m_buffers->allocate(count * sizeof(T)));
+            std::copy(data, data + count, result);
+            return result;
+        };
+        const triangulateio& out = *m_out;
+        auto edited = make_output();
+        edited->numberofpoints = out.numberofpoints;
+        edited->pointlist = copy(out.pointlist, size_t(out.numberofpoints) * 2);
+        edited->pointmarkerlist = copy(out.pointmarkerlist, size_t(out.numberofpoints));
+        edited->numberoftriangles = out.numberoftriangles;
+        edited->numberofcorners = out.numberofcorners;
+        edited->trianglelist = copy(out.trianglelist, size_t(out.numberoftriangles) * 3);
+        edited->neighborlist = copy(out.neighborlist, size_t(out.numberoftriangles) * 3);
+        edited->numberofsegments = out.numberofsegments;
+        edited->segmentlist = copy(out.segmentlist, size_t(out.numberofsegments) * 2);
+        edited->segmentmarkerlist = copy(out.segmentmarkerlist, size_t(out.numberofsegments));
+        m_out = edited;
+        m_vorout = make_output();
+        m_live.reset();
+    }
+
+    if (!m_live) {
+        clear_triangulateio(*m_vorout, m_buffers.get());
+        m_live = std::make_unique<LiveMesh>(*m_out, *m_buffers);
+    }
+    return *m_live;
+}
+
+void Engine::run_spatially_sorted(const Config& config, OutputSink* sink)
+{
+    const Index num_points = m_in->numberofpoints;
+    const std::vector<Index> order =
+        compute_hilbert_order(m_in->pointlist, num_points, config.num_threads);
+    const std::vector<Index> rank = invert_order(order);
+
+    std::vector<Scalar> points(static_cast<size_t>(num_points) * 2);
+    std::vector<int> point_markers;
+    for (Index i = 0; i < num_points; i++) {
+        points[i * 2] = m_in->pointlist[order[i] * 2];
+        points[i * 2 + 1] = m_in->pointlist[order[i] * 2 + 1];
+    }
+    if (m_in->pointmarkerlist != nullptr) {
+        point_markers.resize(num_points);
+        for (Index i = 0; i < num_points; i++) point_markers[i] = m_in->pointmarkerlist[order[i]];
+    }
+    std::vector<Index> segments(m_in->segmentlist,
+        m_in->segmentlist + static_cast<size_t>(m_in->numberofsegments) * 2);
+    std::vector<Index> triangles(m_in->trianglelist,
+        m_in->trianglelist + static_cast<size_t>(m_in->numberoftriangles) * m_in->numberofcorners);
+    remap_indices(segments.data(), segments.size(), rank);
+    remap_indices(triangles.data(), triangles.size(), rank);
+
+    // Curve order of the output needs the output points, even if they are not requested.
+    Config sorted_config = config;
+    sorted_config.spatial_sort = false;
+    if (config.keep_spatial_order) sorted_config.output_flags |= OUTPUT_POINTS;
+
+    const triangulateio user_in = *m_in;
+    m_in->pointlist = points.data();
+    if (!point_markers.empty()) m_in->pointmarkerlist = point_markers.data();
+    if (!segments.empty()) m_in->segmentlist = segments.data();
+    if (!triangles.empty()) m_in->trianglelist = triangles.data();
+    try {
+        run(sorted_config, nullptr);
+    } catch (...) {
+        *m_in = user_in;
+        throw;
+    }
+    *m_in = user_in;
+
+    if (!config.keep_spatial_order) {
+        // Input points go back to their original index, Steiner points stay after them.
+        std::vector<Index> new_index(std::max(m_out->numberofpoints, num_points));
+        std::copy(order.begin(), order.end(), new_index.begin());
+        std::iota(new_index.begin() + num_points, new_index.end(), num_points);
+        permute_out_points(new_index);
+    } else {
+        reorder_output(OutputOrder::HILBERT, config.num_threads);
+        release_unrequested_output(config.output_flags);
+    }
+    write_output(sink);
+}
+
+void Engine::run_reordered(const Config& config, OutputSink* sink)
+{
+    // Orderings need the output points and triangles, even if they are not requested.
+    Config inner_config = config;
+    inner_config.output_order = OutputOrder::DEFAULT;
+    inner_config.output_flags |= OUTPUT_POINTS | OUTPUT_TRIANGLES;
+    run(inner_config, nullptr);
+
+    reorder_output(config.output_order, config.num_threads);
+    release_unrequested_output(config.output_flags);
+    write_output(sink);
+}
+
+void Engine::reorder_output(OutputOrder order, Index num_threads)
+{
+    const Scalar* points = m_out->pointlist;
+    const Index* triangles = m_out->trianglelist;
+    const Index num_points = m_out->numberofpoints;
+    const Index num_triangles = num_rows(triangles, m_out->numberoftriangles);
+
+    std::vector<Index> point_order, triangle_order;
+    switch (order) {
+    case OutputOrder::DEFAULT: return;
+    case OutputOrder::HILBERT:
+        if (points == nullptr) return;
+        point_order = compute_hilbert_order(points, num_points, num_threads);
+        triangle_order =
+            compute_hilbert_triangle_order(points, triangles, num_triangles, num_threads);
+        break;
+    case OutputOrder::REVERSE_CUTHILL_MCKEE:
+        point_order = compute_rcm_point_order(triangles, num_triangles, num_points);
+        triangle_order = compute_triangle_order_from_points(
+            triangles, num_triangles, point_order, num_threads);
+        break;
+    case OutputOrder::STRIP:
+        triangle_order = compute_strip_triangle_order(triangles, num_triangles, num_points);
+        point_order = compute_point_order_from_triangles(triangles, num_points, triangle_order);
+        break;
+    }
+
+    // Both orders refer to the current numbering, which permuting the triangles does not change.
+    if (num_triangles > 0) permute_out_triangles(invert_order(triangle_order));
+    permute_out_points(invert_order(point_order));
+}
+
+void Engine::release_unrequested_output(int output_flags)
+{
+    if (!(output_flags & OUTPUT_POINTS) && m_out->pointlist != nullptr) {
+        m_buffers->release(m_out->pointlist);
+        m_out->pointlist = nullptr;
+    }
+    if (!(output_flags & OUTPUT_TRIANGLES) && m_out->trianglelist != nullptr) {
+        m_buffers->release(m_out->trianglelist);
+        m_out->trianglelist = nullptr;
+    }
+}
+
+void Engine::permute_out_points(const std::vector<Index>& new_index)
+{
+    triangulateio& out = *m_out;
+    const Index num_points = out.numberofpoints;
+    permute_rows(out.pointlist, num_points, 2, new_index);
+    permute_rows(out.pointmarkerlist, num_points, 1, new_index);
+    permute_rows(out.pointattributelist, num_points, out.numberofpointattributes, new_index);
+    remap_indices(out.trianglelist,
+        static_cast<size_t>(num_rows(out.trianglelist, out.numberoftriangles)) *
+            out.numberofcorners,
+        new_index);
+    remap_indices(out.segmentlist,
+        static_cast<size_t>(num_rows(out.segmentlist, out.numberofsegments)) * 2,
+        new_index);
+    remap_indices(out.edgelist,
+        static_cast<size_t>(num_rows(out.edgelist, out.numberofedges)) * 2,
+        new_index);
+}
+
+void Engine::permute_out_triangles(const std::vector<Index>& new_index)
+{
+    triangulateio& out = *m_out;
+    const Index num_triangles = out.numberoftriangles;
+    permute_rows(out.trianglelist, num_triangles, out.numberofcorners, new_index);
+    permute_rows(out.trianglearealist, num_triangles, 1, new_index);
+    permute_rows(
+        out.triangleattributelist, num_triangles, out.numberoftriangleattributes, new_index);
+    permute_rows(out.neighborlist, num_triangles, 3, new_index);
+    remap_indices(out.neighborlist,
+        static_cast<size_t>(num_rows(out.neighborlist, num_triangles)) * 3,
+        new_index);
+
+    // Voronoi vertices are the circumcenters of the triangles.
+    triangulateio& vorout = *m_vorout;
+    if (vorout.pointlist != nullptr && vorout.numberofpoints == num_triangles) {
+        permute_rows(vorout.pointlist, num_triangles, 2, new_index);
+        permute_rows(
+            vorout.pointattributelist, num_triangles, vorout.numberofpointattributes, new_index);
+        remap_indices(vorout.edgelist,
+            static_cast<size_t>(num_rows(vorout.edgelist, vorout.numberofedges)) * 2,
+            new_index);
+    }
+}
+
+void Engine::write_output(OutputSink* sink)
+{
+    if (sink == nullptr) return;
+    OutputSinkScope sink_scope(sink);
+    if (m_out->pointlist != nullptr) {
+        const size_t size = static_cast<size_t>(m_out->numberofpoints) * 2;
+        void* list = nullptr;
+        sink_scope.provide(OutputSinkScope::POINTS, m_out->numberofpoints, &list);
+        if (list != nullptr) {
+            std::copy(m_out->pointlist, m_out->pointlist + size, static_cast<Scalar*>(list));
+            m_buffers->release(m_out->pointlist);
+            m_out->pointlist = static_cast<Scalar*>(list);
+        }
+    }
+    if (m_out->trianglelist != nullptr) {
+        const size_t size = static_cast<size_t>(m_out->numberoftriangles) * 3;
+        void* list = nullptr;
+        sink_scope.provide(OutputSinkScope::TRIANGLES, m_out->numberoftriangles, &list);
+        if (list != nullptr) {
+            std::copy(m_out->trianglelist, m_out->trianglelist + size, static_cast<Index*>(list));
+            m_buffers->release(m_out->trianglelist);
+            m_out->trianglelist = static_cast<Index*>(list);
+        }
+    }
+    sink_scope.finalize(m_out->pointlist,
+        m_out->numberofpoints,
+        m_out->trianglelist,
+        m_out->numberoftriangles);
+}
+
+bool Engine::run_parallel_delaunay(const Config& config, OutputSink* sink)
+{
+    const Index num_points = m_in->numberofpoints;
+    std::vector<Index> triangles;
+    const Index num_strips =
+        parallel_delaunay(m_in->pointlist, num_points, config.num_threads, triangles);
+    if (num_strips == 0) return false;
+    m_stats.num_subdomains = num_strips;
+    const Index num_triangles = static_cast<Index>(triangles.size() / 3);
+
+    // Anything beyond points and triangles is left to triangle, which refines (`r`) the
+    // triangulation instead of computing it again.
+    const bool is_plain = (config.output_flags & ~(OUTPUT_POINTS | OUTPUT_TRIANGLES)) == 0 &&
+                          config.min_angle <= 0 && config.max_area <= 0 && !config.voronoi;
+    if (!is_plain) {
+        const triangulateio user_in = *m_in;
+        m_in->trianglelist = triangles.data();
+        m_in->numberoftriangles = num_triangles;
+        m_in->numberofcorners = 3;
+        m_in->trianglearealist = nullptr;
+        m_in->triangleattributelist = nullptr;
+        m_in->numberoftriangleattributes = 0;
+        try {
+            run_triangle(generate_command_line_options(*m_in, config), sink);
+        } catch (...) {
+            *m_in = user_in;
+            throw;
+        }
+        *m_in = user_in;
+        return true;
+    }
+
+    // Write the output directly, the same way triangle would.
+    BufferCache::Scope scope(*m_buffers);
+    OutputSinkScope sink_scope(sink);
+    reset_output();
+    m_out->numberofpoints = num_points;
+    m_out->numberoftriangles = num_triangles;
+    m_out->numberofcorners = 3;
+    if (config.output_flags & OUTPUT_POINTS) {
+        void* list = nullptr;
+        sink_scope.provide(OutputSinkScope::POINTS, num_points, &list);
+        if (list == nullptr) list = m_buffers->allocate(size_t(num_points) * 2 * sizeof(Scalar));
+        m_out->pointlist = static_cast<Scalar*>(list);
+        std::copy(m_in->pointlist, m_in->pointlist + num_points * 2, m_out->pointlist);
+    }
+    if (config.output_flags & OUTPUT_TRIANGLES) {
+        void* list = nullptr;
+        sink_scope.provide(OutputSinkScope::TRIANGLES, num_triangles, &list);
+        if (list == nullptr) list = m_buffers->allocate(size_t(num_triangles) * 3 * sizeof(Index));
+        m_out->trianglelist = static_cast<Index*>(list);
+        std::copy(triangles.begin(), triangles.end(), m_out->trianglelist);
+    }
+    sink_scope.finalize(m_out->pointlist,
+        m_out->numberofpoints,
+        m_out->trianglelist,
+        m_out->numberoftriangles);
+    return true;
+}
+
+std::vector<Scalar> Engine::run_auto_hole_detection(AutoHoleMesh* mesh)
 {
     using Point = Eigen::Matrix<Scalar, 2, 1>;
 
@@ -492,11 +1050,18 @@ std::vector<Scalar> Engine::run_auto_hole_detection()
     config.auto_hole_detection = false; // To avoid recursion.
     config.verbose_level = 0;
     config.max_num_steiner = 0;
-
-    std::vector<int> seg_markers(m_in->numberofsegments, 1);
-    set_in_segment_markers(seg_markers.data(), m_in->numberofsegments);
+    config.reuse_buffers = m_buffers->is_enabled();
+
+    // Mark the segments so that output edge markers identify the input segment.
+    const int num_in_segments = m_in->numberofsegments;
+    std::vector<int> seg_markers(num_in_segments);
+    for (int i = 0; i < num_in_segments; i++) seg_markers[i] = segment_marker(i);
+    int* user_seg_markers = m_in->segmentmarkerlist;
+    set_in_segment_markers(seg_markers.data(), num_in_segments);
+    PhaseTimer timer;
     run(config);
-    unset_in_segment_markers();
+    m_in->segmentmarkerlist = user_seg_markers;
+    timer.lap(m_stats.auto_hole_triangulation_time);
 
     // Extract result.
     auto points = get_out_points();
@@ -504,68 +1069,46 @@ std::vector<Scalar> Engine::run_auto_hole_detection()
     auto edges = get_out_edges();
     auto edge_markers = get_out_edge_markers();
     auto neighbors = get_out_triangle_neighbors();
+    const auto in_points = get_in_points();
+    const auto in_segments = get_in_segments();
 
-    // Initialize states.
     const int num_triangles = static_cast<int>(triangles.rows());
-    std::vector<std::vector<int>> regions;
-    regions.reserve(num_triangles / 2);
-    std::vector<bool> visited(num_triangles, false);
-
-    // Initialize seg_edge_set to check if an edge comes from an input segment.
+    const int num_points = static_cast<int>(points.rows());
     const int num_edges = static_cast<int>(edges.rows());
-    std::set<std::array<int, 2>> seg_edge_set;
     assert(edge_markers.size() == num_edges);
+
+    // Index edges by their smaller vertex (CSR) so that the input segment of each triangle edge
+    // can be found by scanning a handful of entries instead of hashing.
+    std::vector<int> edge_offsets(num_points + 1, 0);
     for (int i = 0; i < num_edges; i++) {
-        if (edge_markers[i] != 0) {
-            // This edge maps to an input boundary.
-            if (edges(i, 0) < edges(i, 1)) {
-                seg_edge_set.insert({edges(i, 0), edges(i, 1)});
-            } else {
-                seg_edge_set.insert({edges(i, 1), edges(i, 0)});
-            }
-        }
+        edge_offsets[std::min(edges(i, 0), edges(i, 1)) + 1]++;
     }
-
-    // Extract the shared edge between 2 triangles.
-    auto shared_edge = [&](int ti, int tj) -> std::array<int, 2> {
-        for (int i = 0; i < 3; i++) {
-            bool found = true;
-            for (int j = 0; j < 3; j++) {
-                if (triangles(ti, i) == triangles(tj, j)) {
-                    found = false;
-                    break;
-                }
-            }
-            if (found) {
-                int v0 = triangles(ti, (i + 1) % 3);
-                int v1 = triangles(ti, (i + 2) % 3);
-                if (v0 < v1) {
-                    return {v0, v1};
-                } else {
-                    return {v1, v0};
-                }
-            }
+    std::partial_sum(edge_offsets.begin(), edge_offsets.end(), edge_offsets.begin());
+    std::vector<int> edge_ids(num_edges);
+    {
+        std::vector<int> cursor(edge_offsets.begin(), edge_offsets.end() - 1);
+        for (int i = 0; i < num_edges; i++) {
+            edge_ids[cursor[std::min(edges(i, 0), edges(i, 1))]++] = i;
         }
-        throw std::runtime_error("Triangles are not adjcent!");
-    };
-
-    // Flood fill from a seed triangle.
-    std::function<void(int, std::vector<int>&)> flood_region;
-    flood_region = [&](int seed_tri, std::vector<int>& region) {
-        region.push_back(seed_tri);
-        visited[seed_tri] = true;
+    }
 
+    // tri_segments[t * 3 + i] is the input segment that the edge of triangle t opposite to its
+    // vertex i (i.e. the edge shared with neighbor i) belongs to, or -1.
+    std::vector<int> tri_segments(num_triangles * 3, -1);
+    for (int t = 0; t < num_triangles; t++) {
         for (int i = 0; i < 3; i++) {
-            const auto t = neighbors(seed_tri, i);
-            if (t < 0) continue; // No neighbor, boundary triangle.
-            if (visited[t]) continue;
-
-            const auto e = shared_edge(seed_tri, t);
-            if (seg_edge_set.find(e) == seg_edge_set.end()) {
-                flood_region(t, region);
+            const int v0 = triangles(t, (i + 1) % 3);
+            const int v1 = triangles(t, (i + 2) % 3);
+            const int v_min = std::min(v0, v1);
+            const int v_max = std::max(v0, v1);
+            for (int k = edge_offsets[v_min]; k < edge_offsets[v_min + 1]; k++) {
+                const int e = edge_ids[k];
+                if (std::max(edges(e, 0), edges(e, 1)) != v_max) continue;
+                tri_segments[t * 3 + i] = marked_segment(edge_markers[e], num_in_segments);
+                break;
             }
         }
-    };
+    }
 
     // Clsoed form of 2D signed triangle area (x2) from vertex coordinates.
     auto compute_area = [](const Point& v0, const Point& v1, const Point& v2) {
@@ -573,75 +1116,405 @@ std::vector<Scalar> Engine::run_auto_hole_detection()
                v0[0] * v2[1];
     };
 
-    // Compute signed angle formed by triangle (v0, v1, v2) at v0.
-    auto compute_angle = [&](const Point& v0, const Point& v1, const Point& v2) {
-        return std::atan2(compute_area(v0, v1, v2), (v1 - v0).dot(v2 - v0));
+    // Change of winding number when crossing the edge of triangle t opposite to its vertex i, from
+    // t (on the left since triangles are counterclockwise) to the other side.
+    auto compute_winding_change = [&](int t, int i) -> int {
+        const int seg_id = tri_segments[t * 3 + i];
+        if (seg_id < 0) return 0;
+
+        // Output edge may be a sub-segment of the input segment (e.g. split at intersections).
+        const Point seg_dir =
+            in_points.row(in_segments(seg_id, 1)) - in_points.row(in_segments(seg_id, 0));
+        const Point edge_dir =
+            points.row(triangles(t, (i + 2) % 3)) - points.row(triangles(t, (i + 1) % 3));
+        return seg_dir.dot(edge_dir) > 0 ? -1 : 1;
     };
 
-    // Compute winding number of a point with respect to the input segments.
-    auto compute_winding_number = [&](const Point& p) {
-        const auto in_points = get_in_points();
-        const auto in_segments = get_in_segments();
-        const int num_in_segments = static_cast<int>(in_segments.rows());
-        Scalar theta = 0;
-        for (int i = 0; i < num_in_segments; i++) {
-            const Point v0 = in_points.row(in_segments(i, 0));
-            const Point v1 = in_points.row(in_segments(i, 1));
-            theta += compute_angle(p, v0, v1);
+    // Compute regions by iterative flood fill.  Regions are separated by input segments.
+    std::vector<int> region_ids(num_triangles, -1);
+    std::vector<int> stack;
+    stack.reserve(num_triangles);
+    int num_regions = 0;
+    for (int seed = 0; seed < num_triangles; seed++) {
+        if (region_ids[seed] >= 0) continue;
+
+        region_ids[seed] = num_regions;
+        stack.push_back(seed);
+        while (!stack.empty()) {
+            const int t = stack.back();
+            stack.pop_back();
+            for (int i = 0; i < 3; i++) {
+                const int n = neighbors(t, i);
+                if (n < 0) continue; // No neighbor, boundary triangle.
+                if (region_ids[n] >= 0) continue;
+                if (tri_segments[t * 3 + i] >= 0) continue; // Crossing a segment.
+                region_ids[n] = num_regions;
+                stack.push_back(n);
+            }
         }
-
-        return theta / (2 * M_PI);
-    };
-
-    // Compute regions by flood fill.
-    for (int i = 0; i < num_triangles; i++) {
-        if (visited[i]) continue;
-
-        regions.emplace_back();
-        regions.back().reserve(num_triangles);
-        flood_region(i, regions.back());
+        num_regions++;
     }
+    timer.lap(m_stats.auto_hole_region_time);
 
 #ifdef WITH_MSHIO
     {
-        std::vector<int> region_ids(num_triangles, 0);
-        int region_count = 0;
-        for (auto& region : regions) {
-            for (auto fid : region) {
-                region_ids[fid] = region_count + 1;
-            }
-            region_count++;
+        std::vector<int> debug_region_ids(num_triangles);
+        for (int i = 0; i < num_triangles; i++) {
+            debug_region_ids[i] = region_ids[i] + 1;
         }
-        debug_save("auto_hole_detection_debug.msh", *this, region_ids);
+        debug_save("auto_hole_detection_debug.msh", *this, debug_region_ids);
     }
 #endif
 
+    // Propagate winding numbers across the triangle adjacency starting from the outside of the
+    // triangulation, where winding number is 0.  Returns false if the propagated winding numbers
+    // are not consistent, i.e. the input segments do not form closed loops.
+    constexpr int unknown_winding = std::numeric_limits<int>::min();
+    std::vector<int> windings(num_triangles, unknown_winding);
+    auto propagate_winding_numbers = [&]() -> bool {
+        stack.clear();
+        auto assign = [&](int t, int w) -> bool {
+            if (windings[t] == unknown_winding) {
+                windings[t] = w;
+                stack.push_back(t);
+                return true;
+            }
+            return windings[t] == w;
+        };
+
+        for (int t = 0; t < num_triangles; t++) {
+            for (int i = 0; i < 3; i++) {
+                if (neighbors(t, i) >= 0) continue;
+                // Crossing from the outside into t.
+                if (!assign(t, -compute_winding_change(t, i))) return false;
+            }
+        }
+
+        while (!stack.empty()) {
+            const int t = stack.back();
+            stack.pop_back();
+            for (int i = 0; i < 3; i++) {
+                const int n = neighbors(t, i);
+                if (n < 0) continue;
+                if (!assign(n, windings[t] + compute_winding_change(t, i))) return false;
+            }
+        }
+
+        return std::find(windings.begin(), windings.end(), unknown_winding) == windings.end();
+    };
+
+    // Winding numbers are propagated through the triangulation by default.  If the input is not
+    // made of closed loops, fall back to evaluating winding numbers at a point of each region
+    // against the input segments using a spatial index.
+    const bool propagated = propagate_winding_numbers();
+    std::unique_ptr<SegmentGrid> segment_grid;
+    if (!propagated) {
+        segment_grid = std::make_unique<SegmentGrid>(
+            m_in->pointlist, m_in->segmentlist, m_in->numberofsegments);
+    }
+    timer.lap(m_stats.auto_hole_winding_time);
+
+    // The centroid of the largest triangle of each region serves as its representative point.
+    std::vector<Scalar> region_max_areas(num_regions, 0);
+    std::vector<Scalar> region_centers(num_regions * 2, 0);
+    std::vector<int> region_windings(num_regions, 0);
+    Point v0, v1, v2;
+    for (int t = 0; t < num_triangles; t++) {
+        const int r = region_ids[t];
+        if (propagated) region_windings[r] = windings[t];
+
+        v0 = points.row(triangles(t, 0));
+        v1 = points.row(triangles(t, 1));
+        v2 = points.row(triangles(t, 2));
+        const auto area = compute_area(v0, v1, v2);
+        if (area > region_max_areas[r]) {
+            region_max_areas[r] = area;
+            region_centers[r * 2] = (v0[0] + v1[0] + v2[0]) / 3;
+            region_centers[r * 2 + 1] = (v0[1] + v1[1] + v2[1]) / 3;
+        }
+    }
+
     // Extract hole points from regions.
-    const int num_regions = static_cast<int>(regions.size());
     std::vector<Scalar> holes;
     holes.reserve(num_regions * 2);
-    Point v0, v1, v2, center;
-    for (int i = 0; i < num_regions; i++) {
-        Scalar max_area = 0;
-        for (auto fid : regions[i]) {
-            v0 = points.row(triangles(fid, 0));
-            v1 = points.row(triangles(fid, 1));
-            v2 = points.row(triangles(fid, 2));
-            const auto area = compute_area(v0, v1, v2);
-
-            if (area > max_area) {
-                max_area = area;
-                center = (v0 + v1 + v2) / 3;
-            }
+    for (int r = 0; r < num_regions; r++) {
+        const Scalar* center = region_centers.data() + r * 2;
+        if (!propagated) {
+            region_windings[r] = segment_grid->winding_number(center);
         }
-
-        const auto winding_number = compute_winding_number(center);
-        if (winding_number < 0.5f) {
+        if (region_windings[r] <= 0) {
             holes.push_back(center[0]);
             holes.push_back(center[1]);
         }
     }
 
+    // Extract the triangles outside of holes, and the segments bounding or inside them.
+    if (mesh != nullptr) {
+        auto is_kept = [&](int t) { return region_windings[region_ids[t]] > 0; };
+        mesh->triangles.clear();
+        mesh->segments.clear();
+        mesh->segment_ids.clear();
+        for (int t = 0; t < num_triangles; t++) {
+            if (!is_kept(t)) continue;
+            mesh->triangles.insert(mesh->triangles.end(),
+                {triangles(t, 0), triangles(t, 1), triangles(t, 2)});
+            for (int i = 0; i < 3; i++) {
+                const int seg_id = tri_segments[t * 3 + i];
+                if (seg_id < 0) continue;
+                const int n = neighbors(t, i);
+                if (n >= 0 && is_kept(n) && n < t) continue; // Already extracted from n.
+                mesh->segments.push_back(triangles(t, (i + 1) % 3));
+                mesh->segments.push_back(triangles(t, (i + 2) % 3));
+                mesh->segment_ids.push_back(seg_id);
+            }
+        }
+    }
+    timer.lap(m_stats.auto_hole_extraction_time);
+
     return holes;
 }
 
+bool Engine::refine_auto_hole_mesh(
+    const Config& config, const AutoHoleMesh& mesh, OutputSink* sink)
+{
+    // The hole detection mesh can only be reused as is if no vertex has been inserted (e.g. at
+    // segment intersections), so that its vertices are exactly the input points.
+    if (m_out->numberofpoints != m_in->numberofpoints) return false;
+    if (mesh.triangles.empty()) return false;
+
+    const int num_segments = static_cast<int>(mesh.segment_ids.size());
+    std::vector<int> segment_markers;
+    if (m_in->segmentmarkerlist != nullptr) {
+        segment_markers.resize(num_segments);
+        for (int i = 0; i < num_segments; i++) {
+            segment_markers[i] = m_in->segmentmarkerlist[mesh.segment_ids[i]];
+        }
+    }
+
+    // Swap in the hole-free mesh as input and refine it.
+    const triangulateio user_in = *m_in;
+    m_in->trianglelist = const_cast<Index*>(mesh.triangles.data());
+    m_in->numberoftriangles = static_cast<Index>(mesh.triangles.size() / 3);
+    m_in->numberofcorners = 3;
+    m_in->trianglearealist = nullptr;
+    m_in->triangleattributelist = nullptr;
+    m_in->numberoftriangleattributes = 0;
+    m_in->segmentlist = const_cast<Index*>(mesh.segments.data());
+    m_in->segmentmarkerlist = segment_markers.empty() ? nullptr : segment_markers.data();
+    m_in->numberofsegments = num_segments;
+    m_in->holelist = nullptr;
+    m_in->numberofholes = 0;
+
+    try {
+        run_triangle(generate_command_line_options(*m_in, config, true), sink);
+    } catch (...) {
+        *m_in = user_in;
+        throw;
+    }
+    *m_in = user_in;
+    return true;
+}
+
+bool Engine::run_parallel_refinement(const Config& config, OutputSink* sink)
+{
+    const Index num_threads = resolve_num_threads(config.num_threads);
+    if (num_threads < 2) return false;
+
+    // Constrained Delaunay triangulation of the input, holes removed.
+    Engine coarse;
+    coarse.set_in_points(m_in->pointlist, m_in->numberofpoints);
+    coarse.set_in_segments(m_in->segmentlist, m_in->numberofsegments);
+    coarse.set_in_holes(m_in->holelist, m_in->numberofholes);
+    if (m_in->pointmarkerlist != nullptr) {
+        coarse.set_in_point_markers(m_in->pointmarkerlist, m_in->numberofpoints);
+    }
+    if (m_in->segmentmarkerlist != nullptr) {
+        coarse.set_in_segment_markers(m_in->segmentmarkerlist, m_in->numberofsegments);
+    }
+
+    Config coarse_config;
+    coarse_config.min_angle = 0;
+    coarse_config.verbose_level = 0;
+    coarse_config.exact = config.exact;
+    coarse_config.convex_hull = config.convex_hull;
+    coarse_config.split_boundary = config.split_boundary;
+    coarse_config.auto_hole_detection = config.auto_hole_detection;
+    coarse_config.auto_hole_reuse_mesh = config.auto_hole_reuse_mesh;
+    coarse_config.output_flags =
+        OUTPUT_POINTS | OUTPUT_TRIANGLES | OUTPUT_SEGMENTS | OUTPUT_NEIGHBORS | OUTPUT_MARKERS;
+    coarse.run(coarse_config);
+
+    // Subdomains need enough coarse triangles to be balanced, and under an area constraint, no
+    // coarse triangle may hold a large share of the area (e.g. next to clustered points).
+    const Index min_coarse_triangles = num_threads * coarse_triangles_per_subdomain;
+    {
+        const auto points = coarse.get_out_points();
+        const auto triangles = coarse.get_out_triangles();
+        double area = 0;
+        double max_triangle_area = 0;
+        for (Index t = 0; t < triangles.rows(); t++) {
+            const auto e0 = points.row(triangles(t, 1)) - points.row(triangles(t, 0));
+            const auto e1 = points.row(triangles(t, 2)) - points.row(triangles(t, 0));
+            const double triangle_area = (double(e0[0]) * e1[1] - double(e0[1]) * e1[0]) / 2;
+            area += triangle_area;
+            max_triangle_area = std::max(max_triangle_area, triangle_area);
+        }
+        const double max_coarse_area = area / min_coarse_triangles;
+        if (triangles.rows() < min_coarse_triangles ||
+            (config.max_area > 0 && max_triangle_area > max_coarse_area)) {
+            coarse_config.max_area = static_cast<Scalar>(max_coarse_area);
+            coarse.run(coarse_config);
+        }
+    }
+    if (coarse.get_out_triangles().rows() < num_threads) return false;
+
+    SegmentMesh mesh;
+    {
+        const auto points = coarse.get_out_points();
+        const auto point_markers = coarse.get_out_point_markers();
+        const auto triangles = coarse.get_out_triangles();
+        const auto segments = coarse.get_out_segments();
+        const auto segment_markers = coarse.get_out_segment_markers();
+        mesh.points.assign(points.data(), points.data() + points.size());
+        mesh.point_markers.assign(
+            point_markers.data(), point_markers.data() + point_markers.size());
+        mesh.triangles.assign(triangles.data(), triangles.data() + triangles.size());
+        mesh.segments.assign(segments.data(), segments.data() + segments.size());
+        mesh.segment_markers.assign(
+            segment_markers.data(), segment_markers.data() + segment_markers.size());
+    }
+    const auto coarse_neighbors = coarse.get_out_triangle_neighbors();
+    const std::vector<Index> neighbors(
+        coarse_neighbors.data(), coarse_neighbors.data() + coarse_neighbors.size());
+    const Partition partition = partition_mesh(mesh, neighbors, config, num_threads);
+
+    // Refine the subdomains concurrently without touching their boundaries.
+    Config subdomain_config = config;
+    subdomain_config.verbose_level = 0;
+    subdomain_config.split_boundary = false;
+    subdomain_config.voronoi = false;
+    subdomain_config.reuse_buffers = false;
+    subdomain_config.output_flags =
+        OUTPUT_POINTS | OUTPUT_TRIANGLES | OUTPUT_SEGMENTS | OUTPUT_MARKERS;
+    const Index num_subdomains = static_cast<Index>(partition.subdomains.size());
+    std::vector<Engine> engines(num_subdomains);
+    parallel_for(num_subdomains, num_threads, [&](Index i) {
+        engines[i].refine_mesh(subdomain_config, partition.subdomains[i]);
+    });
+
+    m_stats.num_subdomains = num_subdomains;
+
+    // Weld the subdomains, and let triangle refine the result around the interfaces.  The
+    // Voronoi diagram is left to triangle, which then only reads and writes the mesh.
+    SegmentMesh merged = merge_subdomains(partition, engines.data());
+    engines.clear();
+    std::vector<Index> merged_neighbors;
+    if (!refine_interfaces(config, partition, merged, merged_neighbors) || config.voronoi) {
+        refine_mesh(config, merged, sink);
+        return true;
+    }
+    write_mesh(config, merged, merged_neighbors, sink);
+    return true;
+}
+
+bool Engine::refine_interfaces(const Config& config,
+    const Partition& partition,
+    SegmentMesh& mesh,
+    std::vector<Index>& neighbors)
+{
+    // Triangles around interfaces were shaped by segments that are gone, and the subdomains may
+    // have left bad triangles along the pieces of their boundary.  Once refined, the band may
+    // itself leave bad triangles along its own boundary, which the next rounds take care of.
+    Config band_config = config;
+    band_config.verbose_level = 0;
+    band_config.split_boundary = false;
+    band_config.convex_hull = false;
+    band_config.voronoi = false;
+    band_config.reuse_buffers = false;
+    band_config.output_flags = OUTPUT_POINTS | OUTPUT_TRIANGLES | OUTPUT_SEGMENTS | OUTPUT_MARKERS;
+
+    std::vector<uint8_t> is_seed = partition.is_interface;
+    is_seed.resize(mesh.num_points(), 0);
+    neighbors = compute_neighbors(mesh, config.num_threads);
+    for (Index round = 0;; round++) {
+        const std::vector<Index> triangles =
+            select_band(mesh, neighbors, is_seed, config, band_rings, config.num_threads);
+        if (triangles.empty()) return true;
+        if (round == max_band_rounds) return false;
+
+        const Band band = extract_band(mesh, neighbors, triangles);
+        Engine refined;
+        refined.refine_mesh(band_config, band.mesh);
+        if (!splice_band(mesh, band, refined)) return false;
+        neighbors = compute_neighbors(mesh, config.num_threads);
+        is_seed.clear();
+    }
+}
+
+void Engine::write_mesh(const Config& config,
+    const SegmentMesh& mesh,
+    const std::vector<Index>& neighbors,
+    OutputSink* sink)
+{
+    BufferCache::Scope scope(*m_buffers);
+    reset_output();
+    auto copy = [this](const auto& data) {
+        using T = typename std::decay_t<decltype(data)>::value_type;
+        T* result = static_cast<T*>(m_buffers->allocate(data.size() * sizeof(T)));
+        std::copy(data.begin(), data.end(), result);
+        return result;
+    };
+
+    const int flags = config.output_flags;
+    const bool with_markers = (flags & OUTPUT_MARKERS) != 0;
+    m_out->numberofpoints = mesh.num_points();
+    m_out->numberoftriangles = mesh.num_triangles();
+    m_out->numberofcorners = 3;
+    if (flags & OUTPUT_POINTS) {
+        m_out->pointlist = copy(mesh.points);
+        if (with_markers) m_out->pointmarkerlist = copy(mesh.point_markers);
+    }
+    if (flags & OUTPUT_TRIANGLES) m_out->trianglelist = copy(mesh.triangles);
+    if (flags & OUTPUT_NEIGHBORS) m_out->neighborlist = copy(neighbors);
+    if (flags & OUTPUT_SEGMENTS) {
+        m_out->numberofsegments = mesh.num_segments();
+        m_out->segmentlist = copy(mesh.segments);
+        if (with_markers) m_out->segmentmarkerlist = copy(mesh.segment_markers);
+    }
+    if (flags & OUTPUT_EDGES) {
+        std::vector<Index> edges;
+        std::vector<int> edge_markers;
+        extract_edges(mesh, neighbors, edges, edge_markers);
+        m_out->numberofedges = static_cast<Index>(edge_markers.size());
+        m_out->edgelist = copy(edges);
+        if (with_markers) m_out->edgemarkerlist = copy(edge_markers);
+    }
+    write_output(sink);
+}
+
+void Engine::refine_mesh(const Config& config, const SegmentMesh& mesh, OutputSink* sink)
+{
+    const triangulateio user_in = *m_in;
+    initialize_triangulateio(*m_in);
+    m_in->pointlist = const_cast<Scalar*>(mesh.points.data());
+    m_in->numberofpoints = mesh.num_points();
+    if (!mesh.point_markers.empty()) {
+        m_in->pointmarkerlist = const_cast<int*>(mesh.point_markers.data());
+    }
+    m_in->trianglelist = const_cast<Index*>(mesh.triangles.data());
+    m_in->numberoftriangles = mesh.num_triangles();
+    m_in->numberofcorners = 3;
+    m_in->segmentlist = const_cast<Index*>(mesh.segments.data());
+    m_in->numberofsegments = mesh.num_segments();
+    if (!mesh.segment_markers.empty()) {
+        m_in->segmentmarkerlist = const_cast<int*>(mesh.segment_markers.data());
+    }
+
+    try {
+        run_triangle(generate_command_line_options(*m_in, config, true), sink);
+    } catch (...) {
+        *m_in = user_in;
+        throw;
+    }
+    *m_in = user_in;
+}
@@ -0,0 +1,714 @@
+#include "LiveMesh.h"
+#include "BufferCache.h"
+#include "SegmentMarkers.h"
+#include "predicates.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+#define VOID void
+#define ANSI_DECLARATORS
+#include <triangle.h>
+
+namespace trianglelite {
+
+namespace {
+
+uint64_t directed_edge_key(Index a, Index b)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+}
+
+uint64_t edge_key(Index a, Index b)
+{
+    return a < b ? directed_edge_key(a, b) : directed_edge_key(b, a);
+}
+
+/**
+ * Make room for `count` elements in `data`, which holds `size` elements, growing it
+ * geometrically.  Null arrays (i.e. not generated) are left alone.
+ */
+template <typename T>
+void reserve_array(T*& data, size_t size, size_t count, BufferCache& buffers)
+{
+    if (data == nullptr || BufferCache::get_capacity(data) >= count * sizeof(T)) return;
+    const size_t capacity = std::max(count, size * 2);
+    T* grown = static_cast<T*>(buffers.allocate(capacity * sizeof(T)));
+    std::copy(data, data + size, grown);
+    buffers.release(data);
+    data = grown;
+}
+
+template <typename T>
+void release_array(T*& data, BufferCache& buffers)
+{
+    buffers.release(data);
+    data = nullptr;
+}
+
+/**
+ * Whether `p`, collinear with `a` and `b`, lies strictly between them.
+ */
+bool is_between(const Scalar* a, const Scalar* b, const Scalar* p)
+{
+    const int k = a[0] != b[0] ? 0 : 1;
+    return (a[k] < p[k] && p[k] < b[k]) || (b[k] < p[k] && p[k] < a[k]);
+}
+
+} // namespace
+
+LiveMesh::LiveMesh(triangulateio& out, BufferCache& buffers)
+    : m_out(&out)
+    , m_buffers(&buffers)
+{
+    // Not maintained.
+    release_array(m_out->edgelist, buffers);
+    release_array(m_out->edgemarkerlist, buffers);
+    m_out->numberofedges = 0;
+    release_array(m_out->triangleattributelist, buffers);
+    release_array(m_out->trianglearealist, buffers);
+    m_out->numberoftriangleattributes = 0;
+    release_array(m_out->pointattributelist, buffers);
+    m_out->numberofpointattributes = 0;
+
+    m_point_triangles.assign(m_out->numberofpoints, -1);
+    for (Index t = 0; t < m_out->numberoftriangles; t++) {
+        for (Index j = 0; j < 3; j++) m_point_triangles[triangle(t)[j]] = t;
+    }
+    if (m_out->segmentlist != nullptr) {
+        for (Index s = 0; s < m_out->numberofsegments; s++) {
+            m_segments[edge_key(m_out->segmentlist[s * 2], m_out->segmentlist[s * 2 + 1])] = s;
+        }
+    }
+    m_marks.assign(m_out->numberoftriangles, 0);
+}
+
+const Scalar* LiveMesh::point(Index v) const
+{
+    return m_out->pointlist + static_cast<size_t>(v) * 2;
+}
+
+Index* LiveMesh::triangle(Index t) const
+{
+    return m_out->trianglelist + static_cast<size_t>(t) * 3;
+}
+
+Index* LiveMesh::neighbors(Index t) const
+{
+    return m_out->neighborlist + static_cast<size_t>(t) * 3;
+}
+
+Index LiveMesh::find_segment(Index a, Index b) const
+{
+    const auto itr = m_segments.find(edge_key(a, b));
+    return itr == m_segments.end() ? -1 : itr->second;
+}
+
+Index LiveMesh::locate(const Scalar* p)
+{
+    const Index num_triangles = m_out->numberoftriangles;
+    if (num_triangles == 0) return -1;
+
+    // Visibility walk, starting from a random edge of each triangle so that it cannot cycle.
+    Index t = m_hint < num_triangles ? m_hint : 0;
+    for (Index step = 0; step < num_triangles; step++) {
+        m_seed = m_seed * 1103515245u + 12345u;
+        const Index start = static_cast<Index>((m_seed >> 16) % 3);
+        Index next = t;
+        for (Index k = 0; k < 3 && next == t; k++) {
+            const Index j = (start + k) % 3;
+            const Index* v = triangle(t);
+            if (predicates::orient2d(point(v[(j + 1) % 3]), point(v[(j + 2) % 3]), p) < 0) {
+                next = neighbors(t)[j];
+            }
+        }
+        if (next == t) return t;
+        if (next < 0) break; // Beyond the boundary, or a hole in the way.
+        t = next;
+    }
+
+    for (t = 0; t < num_triangles; t++) {
+        const Index* v = triangle(t);
+        if (predicates::orient2d(point(v[0]), point(v[1]), p) >= 0 &&
+            predicates::orient2d(point(v[1]), point(v[2]), p) >= 0 &&
+            predicates::orient2d(point(v[2]), point(v[0]), p) >= 0) {
+            return t;
+        }
+    }
+    return -1;
+}
+
+bool LiveMesh::collect_star(Index v, std::vector<Index>& star) const
+{
+    star.clear();
+    const Index t0 = m_point_triangles[v];
+    if (t0 < 0) return false;
+
+    // Neighbor across the edge leaving (entering) `v` counterclockwise.
+    auto corner = [&](Index t) {
+        return static_cast<Index>(std::find(triangle(t), triangle(t) + 3, v) - triangle(t));
+    };
+    auto next = [&](Index t) { return neighbors(t)[(corner(t) + 1) % 3]; };
+    auto previous = [&](Index t) { return neighbors(t)[(corner(t) + 2) % 3]; };
+
+    Index t = t0;
+    do {
+        star.push_back(t);
+        t = next(t);
+    } while (t >= 0 && t != t0);
+    if (t == t0) return true;
+
+    // On the boundary: restart from the clockwise end.
+    star.clear();
+    t = t0;
+    while (previous(t) >= 0) t = previous(t);
+    for (; t >= 0; t = next(t)) star.push_back(t);
+    return false;
+}
+
+void LiveMesh::reserve_points(Index num_points)
+{
+    const size_t size = m_out->numberofpoints;
+    reserve_array(m_out->pointlist, size * 2, static_cast<size_t>(num_points) * 2, *m_buffers);
+    reserve_array(m_out->pointmarkerlist, size, num_points, *m_buffers);
+}
+
+void LiveMesh::reserve_triangles(Index num_triangles)
+{
+    const size_t size = m_out->numberoftriangles;
+    const size_t count = static_cast<size_t>(num_triangles) * 3;
+    reserve_array(m_out->trianglelist, size * 3, count, *m_buffers);
+    reserve_array(m_out->neighborlist, size * 3, count, *m_buffers);
+    if (static_cast<Index>(m_marks.size()) < num_triangles) m_marks.resize(num_triangles, 0);
+}
+
+void LiveMesh::reserve_segments(Index num_segments)
+{
+    const size_t size = m_out->numberofsegments;
+    const size_t count = static_cast<size_t>(num_segments) * 2;
+    reserve_array(m_out->segmentlist, size * 2, count, *m_buffers);
+    reserve_array(m_out->segmentmarkerlist, size, num_segments, *m_buffers);
+}
+
+void LiveMesh::set_neighbor(Index t, Index a, Index b, Index n)
+{
+    const Index* v = triangle(t);
+    for (Index j = 0; j < 3; j++) {
+        if (v[j] != a && v[j] != b) {
+            neighbors(t)[j] = n;
+            return;
+        }
+    }
+}
+
+void LiveMesh::move_triangle(Index from, Index to)
+{
+    std::copy(triangle(from), triangle(from) + 3, triangle(to));
+    std::copy(neighbors(from), neighbors(from) + 3, neighbors(to));
+    for (Index j = 0; j < 3; j++) {
+        m_point_triangles[triangle(to)[j]] = to;
+        const Index n = neighbors(to)[j];
+        if (n < 0) continue;
+        Index* nn = neighbors(n);
+        std::replace(nn, nn + 3, from, to);
+    }
+    if (m_hint == from) m_hint = to;
+}
+
+void LiveMesh::move_point(Index from, Index to)
+{
+    std::copy(point(from), point(from) + 2, m_out->pointlist + static_cast<size_t>(to) * 2);
+    if (m_out->pointmarkerlist != nullptr) {
+        m_out->pointmarkerlist[to] = m_out->pointmarkerlist[from];
+    }
+
+    std::vector<Index> star;
+    collect_star(from, star);
+    for (Index t : star) {
+        Index* v = triangle(t);
+        const Index j = static_cast<Index>(std::find(v, v + 3, from) - v);
+        // Segments along the edges leaving `from`.
+        for (Index other : {v[(j + 1) % 3], v[(j + 2) % 3]}) {
+            const Index s = find_segment(from, other);
+            if (s < 0) continue;
+            Index* segment = m_out->segmentlist + static_cast<size_t>(s) * 2;
+            if (segment[0] != from && segment[1] != from) continue; // Already moved.
+            std::replace(segment, segment + 2, from, to);
+            m_segments.erase(edge_key(from, other));
+            m_segments[edge_key(to, other)] = s;
+        }
+    }
+    for (Index t : star) std::replace(triangle(t), triangle(t) + 3, from, to);
+    m_point_triangles[to] = m_point_triangles[from];
+}
+
+Index LiveMesh::append_point(const Scalar* p)
+{
+    const Index v = m_out->numberofpoints;
+    reserve_points(v + 1);
+    m_out->pointlist[v * 2] = p[0];
+    m_out->pointlist[v * 2 + 1] = p[1];
+    if (m_out->pointmarkerlist != nullptr) m_out->pointmarkerlist[v] = 0;
+    m_point_triangles.push_back(-1);
+    m_out->numberofpoints++;
+    return v;
+}
+
+void LiveMesh::insert_point(const Scalar* p)
+{
+    const Index t0 = locate(p);
+    if (t0 < 0) throw std::runtime_error("Cannot insert a point outside of the triangulation");
+
+    const Index* corners = triangle(t0);
+    for (Index j = 0; j < 3; j++) {
+        const Scalar* q = point(corners[j]);
+        if (q[0] == p[0] && q[1] == p[1]) {
+            append_point(p); // Duplicate, left isolated.
+            return;
+        }
+    }
+
+    // Cavity: triangles whose circumcircle contains p, grown from t0 without crossing segments,
+    // unless p splits the segment.
+    Index split_segment = -1;
+    m_stamp++;
+    m_cavity.assign(1, t0);
+    m_marks[t0] = m_stamp;
+    for (size_t i = 0; i < m_cavity.size(); i++) {
+        const Index t = m_cavity[i];
+        for (Index j = 0; j < 3; j++) {
+            const Index n = neighbors(t)[j];
+            if (n < 0 || m_marks[n] == m_stamp) continue;
+            const Index a = triangle(t)[(j + 1) % 3];
+            const Index b = triangle(t)[(j + 2) % 3];
+            const Index s = find_segment(a, b);
+            if (s >= 0) {
+                if (predicates::orient2d(point(a), point(b), p) != 0 ||
+                    !is_between(point(a), point(b), p)) {
+                    continue;
+                }
+                split_segment = s;
+            } else {
+                const Index* w = triangle(n);
+                if (predicates::incircle(point(w[0]), point(w[1]), point(w[2]), p) <= 0) continue;
+            }
+            m_marks[n] = m_stamp;
+            m_cavity.push_back(n);
+        }
+    }
+    if (split_segment < 0) {
+        // p may also split a segment on the boundary.
+        for (Index t : m_cavity) {
+            for (Index j = 0; j < 3 && split_segment < 0; j++) {
+                if (neighbors(t)[j] >= 0) continue;
+                const Index a = triangle(t)[(j + 1) % 3];
+                const Index b = triangle(t)[(j + 2) % 3];
+                const Index s = find_segment(a, b);
+                if (s >= 0 && predicates::orient2d(point(a), point(b), p) == 0 &&
+                    is_between(point(a), point(b), p)) {
+                    split_segment = s;
+                }
+            }
+        }
+    }
+
+    // Boundary of the cavity, seen from the inside, and the triangle outside of each edge.  Edges
+    // through p (i.e. split boundary edges) get no triangle.
+    struct Edge
+    {
+        Index a, b, outside, inside;
+    };
+    std::vector<Edge> boundary;
+    for (Index t : m_cavity) {
+        for (Index j = 0; j < 3; j++) {
+            const Index n = neighbors(t)[j];
+            if (n >= 0 && m_marks[n] == m_stamp) continue;
+            const Index a = triangle(t)[(j + 1) % 3];
+            const Index b = triangle(t)[(j + 2) % 3];
+            const int orientation = predicates::orient2d(point(a), point(b), p);
+            if (orientation < 0) {
+                throw std::runtime_error("Point insertion failed: cavity is not star-shaped");
+            }
+            if (orientation > 0) boundary.push_back({a, b, n, t});
+        }
+    }
+
+    // Fan of new triangles, reusing the cavity slots first.
+    const Index v = append_point(p);
+    const Index num_cavity = static_cast<Index>(m_cavity.size());
+    const Index num_new = static_cast<Index>(boundary.size());
+    const Index first_slot = m_out->numberoftriangles;
+    reserve_triangles(first_slot + num_new - num_cavity);
+    m_out->numberoftriangles += num_new - num_cavity;
+    auto slot = [&](Index i) {
+        return i < num_cavity ? m_cavity[i] : first_slot + i - num_cavity;
+    };
+
+    std::unordered_map<Index, Index> from, to; // New triangle by first (second) boundary vertex.
+    for (Index i = 0; i < num_new; i++) {
+        from[boundary[i].a] = slot(i);
+        to[boundary[i].b] = slot(i);
+    }
+    for (Index i = 0; i < num_new; i++) {
+        const Edge& e = boundary[i];
+        const Index t = slot(i);
+        Index* w = triangle(t);
+        w[0] = e.a;
+        w[1] = e.b;
+        w[2] = v;
+        const auto after = from.find(e.b);
+        const auto before = to.find(e.a);
+        neighbors(t)[0] = after == from.end() ? -1 : after->second;
+        neighbors(t)[1] = before == to.end() ? -1 : before->second;
+        neighbors(t)[2] = e.outside;
+        m_point_triangles[e.a] = t;
+        m_point_triangles[e.b] = t;
+        m_point_triangles[v] = t;
+        m_marks[t] = 0;
+    }
+    for (Index i = 0; i < num_new; i++) {
+        const Edge& e = boundary[i];
+        if (e.outside >= 0) set_neighbor(e.outside, e.a, e.b, slot(i));
+    }
+    m_hint = slot(0);
+
+    if (split_segment >= 0) {
+        const Index s = m_out->numberofsegments;
+        reserve_segments(s + 1);
+        Index* segment = m_out->segmentlist + static_cast<size_t>(split_segment) * 2;
+        const Index a = segment[0];
+        const Index b = segment[1];
+        m_segments.erase(edge_key(a, b));
+        segment[1] = v;
+        m_out->segmentlist[s * 2] = v;
+        m_out->segmentlist[s * 2 + 1] = b;
+        m_segments[edge_key(a, v)] = split_segment;
+        m_segments[edge_key(v, b)] = s;
+        if (m_out->segmentmarkerlist != nullptr) {
+            const int marker = m_out->segmentmarkerlist[split_segment];
+            m_out->segmentmarkerlist[s] = marker;
+            if (m_out->pointmarkerlist != nullptr) m_out->pointmarkerlist[v] = marker;
+        }
+        m_out->numberofsegments++;
+    }
+}
+
+void LiveMesh::remove_point(Index v)
+{
+    if (v < 0 || v >= m_out->numberofpoints) {
+        throw std::runtime_error("Invalid point index " + std::to_string(v));
+    }
+
+    std::vector<Index> star;
+    if (m_point_triangles[v] >= 0) {
+        if (!collect_star(v, star)) {
+            throw std::runtime_error("Cannot remove a point on the boundary");
+        }
+
+        // Link polygon, counterclockwise, and the triangle outside of each of its edges.
+        const Index k = static_cast<Index>(star.size());
+        std::vector<Index> link(k), outside(k);
+        for (Index i = 0; i < k; i++) {
+            const Index* w = triangle(star[i]);
+            const Index j = static_cast<Index>(std::find(w, w + 3, v) - w);
+            link[i] = w[(j + 1) % 3];
+            outside[i] = neighbors(star[i])[j];
+            if (find_segment(v, link[i]) >= 0) {
+                throw std::runtime_error("Cannot remove an endpoint of a segment");
+            }
+        }
+
+        // Clip ears whose circumcircle contains no other vertex of the remaining polygon.
+        std::vector<Index> polygon = link;
+        std::vector<std::array<Index, 3>> fill;
+        while (polygon.size() > 3) {
+            const Index m = static_cast<Index>(polygon.size());
+            bool clipped = false;
+            for (Index i = 0; i < m && !clipped; i++) {
+                const Index a = polygon[i];
+                const Index b = polygon[(i + 1) % m];
+                const Index c = polygon[(i + 2) % m];
+                if (predicates::orient2d(point(a), point(b), point(c)) <= 0) continue;
+                bool is_delaunay = true;
+                for (Index l = 3; l < m && is_delaunay; l++) {
+                    const Index d = polygon[(i + l) % m];
+                    is_delaunay =
+                        predicates::incircle(point(a), point(b), point(c), point(d)) <= 0;
+                }
+                if (!is_delaunay) continue;
+                fill.push_back({a, b, c});
+                polygon.erase(polygon.begin() + (i + 1) % m);
+                clipped = true;
+            }
+            if (!clipped) throw std::runtime_error("Point removal failed: no Delaunay ear");
+        }
+        fill.push_back({polygon[0], polygon[1], polygon[2]});
+
+        // Write the fill into the first k - 2 star slots.
+        std::unordered_map<uint64_t, Index> edges; // Directed edge (a, b) -> fill triangle.
+        for (size_t i = 0; i < fill.size(); i++) {
+            for (Index j = 0; j < 3; j++) {
+                const Index a = fill[i][j];
+                const Index b = fill[i][(j + 1) % 3];
+                edges[directed_edge_key(a, b)] = star[i];
+            }
+        }
+        for (size_t i = 0; i < fill.size(); i++) {
+            const Index t = star[i];
+            std::copy(fill[i].begin(), fill[i].end(), triangle(t));
+            for (Index j = 0; j < 3; j++) {
+                // Across the edge opposite corner j, i.e. from (j + 2) to (j + 1).
+                const Index a = fill[i][(j + 2) % 3];
+                const Index b = fill[i][(j + 1) % 3];
+                const auto itr = edges.find(directed_edge_key(a, b));
+                neighbors(t)[j] = itr == edges.end() ? -2 : itr->second;
+                m_point_triangles[fill[i][j]] = t;
+            }
+        }
+        for (Index i = 0; i < k; i++) {
+            // Link edge (link[i], link[i + 1]) belongs to the fill triangle recorded for it.
+            const Index a = link[i];
+            const Index b = link[(i + 1) % k];
+            const Index t = edges[directed_edge_key(a, b)];
+            set_neighbor(t, a, b, outside[i]);
+            if (outside[i] >= 0) set_neighbor(outside[i], a, b, t);
+        }
+
+        // Release the two remaining star slots, highest first.
+        std::vector<Index> freed{star[k - 2], star[k - 1]};
+        std::sort(freed.rbegin(), freed.rend());
+        for (Index t : freed) {
+            const Index last = m_out->numberoftriangles - 1;
+            if (t != last) move_triangle(last, t);
+            m_out->numberoftriangles--;
+        }
+        if (m_hint >= m_out->numberoftriangles) m_hint = 0;
+    }
+
+    const Index last = m_out->numberofpoints - 1;
+    if (v != last) move_point(last, v);
+    m_point_triangles.pop_back();
+    m_out->numberofpoints--;
+}
+
+std::vector<Index> LiveMesh::select_triangles(const Scalar* polygon, Index num_vertices) const
+{
+    std::vector<Index> selected;
+    for (Index t = 0; t < m_out->numberoftriangles; t++) {
+        const Index* v = triangle(t);
+        const Scalar x = (point(v[0])[0] + point(v[1])[0] + point(v[2])[0]) / 3;
+        const Scalar y = (point(v[0])[1] + point(v[1])[1] + point(v[2])[1]) / 3;
+        bool inside = false;
+        for (Index i = 0, k = num_vertices - 1; i < num_vertices; k = i++) {
+            const Scalar* p = polygon + static_cast<size_t>(i) * 2;
+            const Scalar* q = polygon + static_cast<size_t>(k) * 2;
+            if ((p[1] > y) != (q[1] > y) &&
+                x < (q[0] - p[0]) * (y - p[1]) / (q[1] - p[1]) + p[0]) {
+                inside = !inside;
+            }
+        }
+        if (inside) selected.push_back(t);
+    }
+    return selected;
+}
+
+Region LiveMesh::extract_region(const Index* triangles, Index num_triangles) const
+{
+    Region region;
+    std::unordered_map<Index, Index> local_triangles;
+    for (Index i = 0; i < num_triangles; i++) {
+        const Index t = triangles[i];
+        if (t < 0 || t >= m_out->numberoftriangles) {
+            throw std::runtime_error("Invalid triangle index " + std::to_string(t));
+        }
+        const Index local = static_cast<Index>(region.triangle_ids.size());
+        if (local_triangles.emplace(t, local).second) region.triangle_ids.push_back(t);
+    }
+
+    std::unordered_map<Index, Index> local_points;
+    auto local_point = [&](Index v) {
+        const auto itr = local_points.emplace(v, static_cast<Index>(region.vertex_ids.size()));
+        if (itr.second) {
+            region.vertex_ids.push_back(v);
+            region.mesh.points.insert(region.mesh.points.end(), point(v), point(v) + 2);
+        }
+        return itr.first->second;
+    };
+
+    // Boundary edges that are not segments are marked past all segments.
+    const int interface_marker = boundary_segment_marker(m_out->numberofsegments);
+    for (Index t : region.triangle_ids) {
+        const Index* v = triangle(t);
+        for (Index j = 0; j < 3; j++) region.mesh.triangles.push_back(local_point(v[j]));
+        for (Index j = 0; j < 3; j++) {
+            const Index a = v[(j + 1) % 3];
+            const Index b = v[(j + 2) % 3];
+            const Index n = neighbors(t)[j];
+            const bool is_boundary = n < 0 || local_triangles.count(n) == 0;
+            if (!is_boundary && n < t) continue; // Inner edge, seen from both sides.
+            const Index s = find_segment(a, b);
+            if (is_boundary) {
+                region.outside[edge_key(a, b)] = n;
+            } else if (s < 0) {
+                continue;
+            }
+            region.mesh.segments.push_back(local_point(a));
+            region.mesh.segments.push_back(local_point(b));
+            region.mesh.segment_markers.push_back(s >= 0 ? segment_marker(s) : interface_marker);
+        }
+    }
+    return region;
+}
+
+RefinementDelta LiveMesh::splice_region(const Region& region, const Engine& refined)
+{
+    const auto points = refined.get_out_points();
+    const auto point_markers = refined.get_out_point_markers();
+    const auto triangles = refined.get_out_triangles();
+    const auto refined_neighbors = refined.get_out_triangle_neighbors();
+    const auto segments = refined.get_out_segments();
+    const auto segment_markers = refined.get_out_segment_markers();
+
+    // Region points come first in the refined output, new points are appended.
+    const Index num_points = m_out->numberofpoints;
+    const Index num_region_points = static_cast<Index>(region.vertex_ids.size());
+    const Index num_new_points = static_cast<Index>(points.rows()) - num_region_points;
+    auto vertex = [&](Index v) {
+        return v < num_region_points ? region.vertex_ids[v] : num_points + v - num_region_points;
+    };
+
+    // Refined triangles take the slots of the region first, then are appended.
+    const Index num_triangles = m_out->numberoftriangles;
+    const Index num_removed = static_cast<Index>(region.triangle_ids.size());
+    const Index num_added = static_cast<Index>(triangles.rows());
+    auto slot = [&](Index t) {
+        return t < num_removed ? region.triangle_ids[t] : num_triangles + t - num_removed;
+    };
+
+    // Resolve all neighbors before editing anything.
+    std::vector<Index> adjacent(static_cast<size_t>(num_added) * 3);
+    for (Index t = 0; t < num_added; t++) {
+        for (Index j = 0; j < 3; j++) {
+            const Index n = refined_neighbors(t, j);
+            if (n >= 0) {
+                adjacent[t * 3 + j] = slot(n);
+                continue;
+            }
+            const Index a = vertex(triangles(t, (j + 1) % 3));
+            const Index b = vertex(triangles(t, (j + 2) % 3));
+            const auto itr = region.outside.find(edge_key(a, b));
+            if (itr == region.outside.end()) {
+                throw std::runtime_error("Refinement split the boundary of the region");
+            }
+            adjacent[t * 3 + j] = itr->second;
+        }
+    }
+
+    RefinementDelta delta;
+    delta.removed_triangles = region.triangle_ids;
+
+    // Points.  Points on a segment take its marker, as triangle does.
+    reserve_points(num_points + num_new_points);
+    std::copy(points.data() + static_cast<size_t>(num_region_points) * 2,
+        points.data() + points.size(),
+        m_out->pointlist + static_cast<size_t>(num_points) * 2);
+    for (Index i = 0; i < num_new_points; i++) {
+        const Index v = num_points + i;
+        if (m_out->pointmarkerlist != nullptr) {
+            const Index s = point_markers.size() > 0
+                                ? marked_segment(point_markers[num_region_points + i],
+                                      m_out->numberofsegments)
+                                : -1;
+            m_out->pointmarkerlist[v] =
+                s >= 0 && m_out->segmentmarkerlist != nullptr ? m_out->segmentmarkerlist[s] : 0;
+        }
+        delta.added_points.push_back(v);
+    }
+    m_out->numberofpoints += num_new_points;
+    m_point_triangles.resize(m_out->numberofpoints, -1);
+
+    // Triangles.
+    reserve_triangles(num_triangles + std::max<Index>(num_added - num_removed, 0));
+    m_out->numberoftriangles = num_triangles + std::max<Index>(num_added - num_removed, 0);
+    for (Index t = 0; t < num_added; t++) {
+        const Index s = slot(t);
+        for (Index j = 0; j < 3; j++) {
+            triangle(s)[j] = vertex(triangles(t, j));
+            neighbors(s)[j] = adjacent[t * 3 + j];
+            m_point_triangles[triangle(s)[j]] = s;
+        }
+        delta.added_triangles.push_back(s);
+    }
+    for (Index t = 0; t < num_added; t++) {
+        const Index* v = triangle(slot(t));
+        for (Index j = 0; j < 3; j++) {
+            const Index n = adjacent[t * 3 + j];
+            if (refined_neighbors(t, j) >= 0 || n < 0) continue;
+            set_neighbor(n, v[(j + 1) % 3], v[(j + 2) % 3], slot(t));
+        }
+    }
+
+    // Fewer triangles than before: fill the unused slots with the last triangles, highest first.
+    if (num_added < num_removed) {
+        std::vector<Index> freed(
+            region.triangle_ids.begin() + num_added, region.triangle_ids.end());
+        std::sort(freed.rbegin(), freed.rend());
+        for (Index t : freed) {
+            const Index last = m_out->numberoftriangles - 1;
+            if (t != last) {
+                move_triangle(last, t);
+                auto& added = delta.added_triangles;
+                const auto itr = std::find(added.begin(), added.end(), last);
+                if (itr != added.end()) {
+                    *itr = t;
+                } else {
+                    delta.removed_triangles.push_back(last);
+                    added.push_back(t);
+                }
+            }
+            m_out->numberoftriangles--;
+        }
+    }
+    m_hint = delta.added_triangles.empty() ? 0 : delta.added_triangles.front();
+
+    // Segments split inside of the region: the first piece keeps the index of the segment, the
+    // others are appended with its marker.
+    if (m_out->segmentlist != nullptr && segment_markers.size() > 0) {
+        const Index num_segments = m_out->numberofsegments;
+        auto origin = [&](Index s) { return marked_segment(segment_markers[s], num_segments); };
+        std::unordered_map<Index, Index> num_pieces;
+        for (Index s = 0; s < segments.rows(); s++) {
+            if (origin(s) >= 0) num_pieces[origin(s)]++;
+        }
+        Index num_appended = 0;
+        for (const auto& entry : num_pieces) num_appended += entry.second - 1;
+        reserve_segments(num_segments + num_appended);
+
+        std::unordered_set<Index> replaced;
+        for (Index s = 0; s < segments.rows(); s++) {
+            const Index o = origin(s);
+            if (o < 0 || num_pieces[o] < 2) continue;
+            Index target = o;
+            if (replaced.insert(o).second) {
+                const Index* segment = m_out->segmentlist + static_cast<size_t>(o) * 2;
+                m_segments.erase(edge_key(segment[0], segment[1]));
+            } else {
+                target = m_out->numberofsegments++;
+                if (m_out->segmentmarkerlist != nullptr) {
+                    m_out->segmentmarkerlist[target] = m_out->segmentmarkerlist[o];
+                }
+            }
+            const Index a = vertex(segments(s, 0));
+            const Index b = vertex(segments(s, 1));
+            m_out->segmentlist[target * 2] = a;
+            m_out->segmentlist[target * 2 + 1] = b;
+            m_segments[edge_key(a, b)] = target;
+        }
+    }
+    return delta;
+}
+
+} // namespace trianglelite
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <trianglelite/Engine.h>
+#include <trianglelite/common.h>
+#include "ParallelRefinement.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct triangulateio; // Data structure defined by triangle.
+
+namespace trianglelite {
+
+class BufferCache;
+
+/**
+ * Patch of triangles extracted from a `LiveMesh` as a mesh whose boundary edges, as well as the
+ * segments inside of it, are segments (see `Engine::refine_triangles`).
+ */
+struct Region
+{
+    SegmentMesh mesh; // Segments are marked with the index of their segment plus 2, if any.
+    std::vector<Index> triangle_ids; // Triangle of each mesh triangle.
+    std::vector<Index> vertex_ids; // Point of each mesh point.
+    std::unordered_map<uint64_t, Index> outside; // Triangle across each boundary edge, or -1.
+};
+
+/**
+ * Local edits of a (constrained) Delaunay triangulation held in triangle's output arrays, without
+ * running triangle again (see `Engine::insert_points`).
+ *
+ * The arrays of `out` are updated in place, and grown geometrically through `buffers` when needed,
+ * so the cost of an edit is proportional to the number of triangles it changes (plus point
+ * location).  Points, triangles and neighbors are required.  Segments and markers are updated if
+ * present.  Edges and triangle attributes cannot be maintained and are released.
+ */
+class LiveMesh
+{
+public:
+    LiveMesh(triangulateio& out, BufferCache& buffers);
+
+    /**
+     * Insert a point with the Bowyer-Watson algorithm: the triangles whose circumcircle contains
+     * the point, without crossing segments, are replaced by a fan around it.  A point on a
+     * segment splits it.  The point is appended to the output points, and a duplicate of an
+     * existing point is appended without being triangulated, as triangle does.
+     *
+     * @throws std::runtime_error if the point is outside of the triangulation.
+     */
+    void insert_point(const Scalar* p);
+
+    /**
+     * Remove an interior point that is not on a segment, and fill its star with Delaunay ears.
+     * The last point is moved to index `v`.
+     *
+     * @throws std::runtime_error if the point cannot be removed.
+     */
+    void remove_point(Index v);
+
+    /**
+     * Triangles whose centroid is inside of `polygon` (even-odd rule).
+     */
+    std::vector<Index> select_triangles(const Scalar* polygon, Index num_vertices) const;
+
+    /**
+     * Extract the given triangles (duplicates are ignored) as a region to be refined.
+     *
+     * @throws std::runtime_error if a triangle index is invalid.
+     */
+    Region extract_region(const Index* triangles, Index num_triangles) const;
+
+    /**
+     * Replace the triangles of `region` by the output of `refined`, a refinement of `region.mesh`
+     * that did not split its boundary.  The triangles reuse the slots of the region first, new
+     * points are appended, and the segments split inside of the region are updated.
+     *
+     * @throws std::runtime_error if the boundary of the region was split.
+     */
+    RefinementDelta splice_region(const Region& region, const Engine& refined);
+
+private:
+    const Scalar* point(Index v) const;
+    Index* triangle(Index t) const;
+    Index* neighbors(Index t) const;
+    Index find_segment(Index a, Index b) const;
+
+    /**
+     * Triangle containing `p` (possibly on its boundary), or -1.
+     */
+    Index locate(const Scalar* p);
+
+    /**
+     * Triangles around `v`, counterclockwise.  The first one starts at the boundary if `v` is on
+     * the boundary.
+     *
+     * @returns false if `v` is on the boundary.
+     */
+    bool collect_star(Index v, std::vector<Index>& star) const;
+
+    /**
+     * Append an isolated point.
+     */
+    Index append_point(const Scalar* p);
+
+    void reserve_points(Index num_points);
+    void reserve_triangles(Index num_triangles);
+    void reserve_segments(Index num_segments);
+
+    /**
+     * Set the neighbor of `t` across edge (a, b) to `n`.
+     */
+    void set_neighbor(Index t, Index a, Index b, Index n);
+
+    /**
+     * Move triangle `from` to slot `to` (free), updating everything that refers to it.
+     */
+    void move_triangle(Index from, Index to);
+
+    /**
+     * Move point `from` to index `to` (free), updating everything that refers to it.
+     */
+    void move_point(Index from, Index to);
+
+private:
+    triangulateio* m_out;
+    BufferCache* m_buffers;
+    std::vector<Index> m_point_triangles; // One triangle per point, -1 if none.
+    std::unordered_map<uint64_t, Index> m_segments; // Segment of each constrained edge.
+    Index m_hint = 0; // Starting triangle of point location.
+    uint32_t m_seed = 1; // Random state of point location.
+
+    // Scratch space.
+    std::vector<Index> m_marks;
+    Index m_stamp = 0;
+    std::vector<Index> m_cavity;
+};
+
+} // namespace trianglelite
@@ -0,0 +1,276 @@
+#include "MeshOrdering.h"
+#include "SpatialSort.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace trianglelite {
+
+namespace {
+
+// Pseudo-peripheral point searches rarely need more than a few iterations.
+constexpr int max_peripheral_iterations = 8;
+
+/**
+ * Compressed rows: the elements of row `i` are `values[offsets[i]]` to `values[offsets[i + 1]]`.
+ */
+struct Csr
+{
+    std::vector<Index> offsets;
+    std::vector<Index> values;
+
+    Index size(Index i) const { return offsets[i + 1] - offsets[i]; }
+    const Index* begin(Index i) const { return values.data() + offsets[i]; }
+    const Index* end(Index i) const { return values.data() + offsets[i + 1]; }
+};
+
+/**
+ * Triangles incident to each point.
+ */
+Csr compute_point_triangles(const Index* triangles, Index num_triangles, Index num_points)
+{
+    Csr result;
+    result.offsets.assign(num_points + 1, 0);
+    for (Index i = 0; i < num_triangles * 3; i++) result.offsets[triangles[i] + 1]++;
+    for (Index v = 0; v < num_points; v++) result.offsets[v + 1] += result.offsets[v];
+    result.values.resize(result.offsets.back());
+    std::vector<Index> cursor(result.offsets.begin(), result.offsets.end() - 1);
+    for (Index i = 0; i < num_triangles * 3; i++) result.values[cursor[triangles[i]]++] = i / 3;
+    return result;
+}
+
+/**
+ * Points sharing an edge with each point, by increasing index.
+ */
+Csr compute_point_adjacency(const Index* triangles, Index num_triangles, Index num_points)
+{
+    Csr result;
+    result.offsets.assign(num_points + 1, 0);
+    for (Index i = 0; i < num_triangles * 3; i++) result.offsets[triangles[i] + 1] += 2;
+    for (Index v = 0; v < num_points; v++) result.offsets[v + 1] += result.offsets[v];
+    result.values.resize(result.offsets.back());
+    std::vector<Index> cursor(result.offsets.begin(), result.offsets.end() - 1);
+    for (Index t = 0; t < num_triangles; t++) {
+        const Index* triangle = triangles + t * 3;
+        for (Index j = 0; j < 3; j++) {
+            result.values[cursor[triangle[j]]++] = triangle[(j + 1) % 3];
+            result.values[cursor[triangle[j]]++] = triangle[(j + 2) % 3];
+        }
+    }
+
+    // Remove duplicates (interior edges are seen from both of their triangles) in place.
+    Index size = 0;
+    for (Index v = 0; v < num_points; v++) {
+        Index* row = result.values.data() + result.offsets[v];
+        const Index row_size = result.offsets[v + 1] - result.offsets[v];
+        std::sort(row, row + row_size);
+        const Index unique_size = static_cast<Index>(std::unique(row, row + row_size) - row);
+        std::copy(row, row + unique_size, result.values.data() + size);
+        result.offsets[v] = size;
+        size += unique_size;
+    }
+    result.offsets[num_points] = size;
+    result.values.resize(size);
+    return result;
+}
+
+} // namespace
+
+std::vector<Index> compute_rcm_point_order(
+    const Index* triangles, Index num_triangles, Index num_points)
+{
+    const Csr adjacency = compute_point_adjacency(triangles, num_triangles, num_points);
+    auto by_degree = [&](Index a, Index b) {
+        const Index da = adjacency.size(a);
+        const Index db = adjacency.size(b);
+        return da < db || (da == db && a < b);
+    };
+
+    std::vector<uint32_t> degrees(num_points);
+    for (Index v = 0; v < num_points; v++) degrees[v] = static_cast<uint32_t>(adjacency.size(v));
+    const std::vector<Index> starts = sort_by_keys(degrees, 1);
+
+    std::vector<Index> order;
+    order.reserve(num_points);
+    std::vector<char> is_ordered(num_points, false);
+    std::vector<Index> queue;
+    std::vector<Index> marks(num_points, -1);
+    Index stamp = 0;
+
+    // Breadth first search among unordered points.  Returns the beginning of the last level in
+    // `queue` and the number of levels.
+    auto search = [&](Index root, Index& last_level) {
+        queue.assign(1, root);
+        marks[root] = ++stamp;
+        Index depth = 0;
+        last_level = 0;
+        for (;;) {
+            const Index level_end = static_cast<Index>(queue.size());
+            for (Index i = last_level; i < level_end; i++) {
+                const Index u = queue[i];
+                for (const Index* v = adjacency.begin(u); v != adjacency.end(u); v++) {
+                    if (marks[*v] != stamp && !is_ordered[*v]) {
+                        marks[*v] = stamp;
+                        queue.push_back(*v);
+                    }
+                }
+            }
+            if (static_cast<Index>(queue.size()) == level_end) return depth;
+            last_level = level_end;
+            depth++;
+        }
+    };
+
+    for (Index start : starts) {
+        if (is_ordered[start]) continue;
+
+        // Pseudo-peripheral point of the component (George and Liu).
+        Index root = start;
+        Index best = start;
+        Index eccentricity = -1;
+        for (int i = 0; i < max_peripheral_iterations; i++) {
+            Index last_level = 0;
+            const Index depth = search(root, last_level);
+            if (depth <= eccentricity) break;
+            eccentricity = depth;
+            best = root;
+            root = *std::min_element(queue.begin() + last_level, queue.end(), by_degree);
+        }
+
+        // Cuthill-McKee: breadth first, visiting neighbors by increasing degree.
+        const size_t component_begin = order.size();
+        order.push_back(best);
+        is_ordered[best] = true;
+        for (size_t i = component_begin; i < order.size(); i++) {
+            const size_t neighbors_begin = order.size();
+            const Index v = order[i];
+            for (const Index* u = adjacency.begin(v); u != adjacency.end(v); u++) {
+                if (is_ordered[*u]) continue;
+                is_ordered[*u] = true;
+                order.push_back(*u);
+            }
+            std::sort(order.begin() + neighbors_begin, order.end(), by_degree);
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+std::vector<Index> compute_triangle_order_from_points(const Index* triangles,
+    Index num_triangles,
+    const std::vector<Index>& point_order,
+    Index num_threads)
+{
+    std::vector<Index> rank(point_order.size());
+    for (size_t i = 0; i < point_order.size(); i++) rank[point_order[i]] = static_cast<Index>(i);
+    std::vector<uint32_t> keys(num_triangles);
+    for (Index t = 0; t < num_triangles; t++) {
+        const Index* triangle = triangles + t * 3;
+        keys[t] = static_cast<uint32_t>(
+            std::min({rank[triangle[0]], rank[triangle[1]], rank[triangle[2]]}));
+    }
+    return sort_by_keys(keys, num_threads);
+}
+
+std::vector<Index> compute_hilbert_triangle_order(
+    const Scalar* points, const Index* triangles, Index num_triangles, Index num_threads)
+{
+    std::vector<Scalar> centroids(static_cast<size_t>(num_triangles) * 2);
+    for (Index t = 0; t < num_triangles; t++) {
+        const Index* triangle = triangles + t * 3;
+        for (Index k = 0; k < 2; k++) {
+            centroids[t * 2 + k] = (points[triangle[0] * 2 + k] + points[triangle[1] * 2 + k] +
+                                       points[triangle[2] * 2 + k]) /
+                                   3;
+        }
+    }
+    return compute_hilbert_order(centroids.data(), num_triangles, num_threads);
+}
+
+std::vector<Index> compute_strip_triangle_order(
+    const Index* triangles, Index num_triangles, Index num_points)
+{
+    // Neighbor across the edge opposite to each corner, or -1.
+    const Csr point_triangles = compute_point_triangles(triangles, num_triangles, num_points);
+    std::vector<Index> neighbors(static_cast<size_t>(num_triangles) * 3, -1);
+    std::vector<uint32_t> num_remaining(num_triangles, 0);
+    for (Index t = 0; t < num_triangles; t++) {
+        for (Index j = 0; j < 3; j++) {
+            const Index a = triangles[t * 3 + (j + 1) % 3];
+            const Index b = triangles[t * 3 + (j + 2) % 3];
+            for (const Index* u = point_triangles.begin(a); u != point_triangles.end(a); u++) {
+                const Index* other = triangles + *u * 3;
+                if (*u != t && (other[0] == b || other[1] == b || other[2] == b)) {
+                    neighbors[t * 3 + j] = *u;
+                    num_remaining[t]++;
+                    break;
+                }
+            }
+        }
+    }
+
+    const std::vector<Index> starts = sort_by_keys(num_remaining, 1);
+    std::vector<Index> order;
+    order.reserve(num_triangles);
+    std::vector<char> is_ordered(num_triangles, false);
+
+    // Least connected unordered neighbor of the triangles of `order` from `begin`, or -1.
+    auto find_next = [&](size_t begin) {
+        Index next = -1;
+        for (size_t i = begin; i < order.size(); i++) {
+            for (Index j = 0; j < 3; j++) {
+                const Index u = neighbors[order[i] * 3 + j];
+                if (u < 0 || is_ordered[u]) continue;
+                if (next < 0 || num_remaining[u] < num_remaining[next]) next = u;
+            }
+        }
+        return next;
+    };
+
+    for (Index start : starts) {
+        if (is_ordered[start]) continue;
+        // Each strip starts next to the previous one, for locality.
+        for (Index t = start; t >= 0;) {
+            const size_t strip_begin = order.size();
+            while (t >= 0) {
+                is_ordered[t] = true;
+                order.push_back(t);
+
+                // Continue towards the neighbor that is the most likely to end up isolated.
+                Index next = -1;
+                for (Index j = 0; j < 3; j++) {
+                    const Index u = neighbors[t * 3 + j];
+                    if (u < 0 || is_ordered[u]) continue;
+                    num_remaining[u]--;
+                    if (next < 0 || num_remaining[u] < num_remaining[next]) next = u;
+                }
+                t = next;
+            }
+            t = find_next(strip_begin);
+        }
+    }
+    return order;
+}
+
+std::vector<Index> compute_point_order_from_triangles(
+    const Index* triangles, Index num_points, const std::vector<Index>& triangle_order)
+{
+    std::vector<Index> order;
+    order.reserve(num_points);
+    std::vector<char> is_ordered(num_points, false);
+    for (Index t : triangle_order) {
+        for (Index j = 0; j < 3; j++) {
+            const Index v = triangles[t * 3 + j];
+            if (is_ordered[v]) continue;
+            is_ordered[v] = true;
+            order.push_back(v);
+        }
+    }
+    for (Index v = 0; v < num_points; v++) {
+        if (!is_ordered[v]) order.push_back(v);
+    }
+    return order;
+}
+
+} // namespace trianglelite
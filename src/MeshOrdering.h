@@ -0,0 +1,47 @@
+#pragma once
+
+#include <trianglelite/common.h>
+
+#include <vector>
+
+namespace trianglelite {
+
+// Orderings of the points and triangles of a triangle mesh, given as row major triangles.  Each
+// function returns the old indices in their new order, i.e. `order[i]` becomes index `i`.
+
+/**
+ * Reverse Cuthill-McKee order of the points, which keeps the vertex adjacency matrix close to its
+ * diagonal.  Each connected component starts from a pseudo-peripheral point.
+ */
+std::vector<Index> compute_rcm_point_order(
+    const Index* triangles, Index num_triangles, Index num_points);
+
+/**
+ * Order of the triangles by their first point in `point_order`.
+ */
+std::vector<Index> compute_triangle_order_from_points(const Index* triangles,
+    Index num_triangles,
+    const std::vector<Index>& point_order,
+    Index num_threads = 0);
+
+/**
+ * Order of the triangles along a Hilbert curve through their centroids.
+ */
+std::vector<Index> compute_hilbert_triangle_order(
+    const Scalar* points, const Index* triangles, Index num_triangles, Index num_threads = 0);
+
+/**
+ * Order of the triangles as long strips of adjacent triangles, i.e. consecutive triangles share an
+ * edge except between strips.  Strips are grown greedily towards the neighbor with the fewest
+ * remaining neighbors, starting from the triangles with the fewest neighbors.
+ */
+std::vector<Index> compute_strip_triangle_order(
+    const Index* triangles, Index num_triangles, Index num_points);
+
+/**
+ * Order of the points by first use in `triangle_order`.  Unused points come last.
+ */
+std::vector<Index> compute_point_order_from_triangles(
+    const Index* triangles, Index num_points, const std::vector<Index>& triangle_order);
+
+} // namespace trianglelite
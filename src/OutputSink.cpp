@@ -0,0 +1,125 @@
+#include <trianglelite/OutputSink.h>
+#include "BufferCache.h"
+#include "OutputSinkScope.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace trianglelite {
+
+FixedOutputSink::FixedOutputSink(
+    Scalar* points, Index max_points, Index* triangles, Index max_triangles)
+    : m_points(points)
+    , m_triangles(triangles)
+    , m_max_points(max_points)
+    , m_max_triangles(max_triangles)
+{}
+
+Scalar* FixedOutputSink::reserve_points(Index num_points)
+{
+    m_num_points = 0;
+    if (num_points > m_max_points) {
+        throw std::overflow_error("Output sink is too small: " + std::to_string(num_points) +
+                                  " points requested, capacity is " +
+                                  std::to_string(m_max_points) + ".");
+    }
+    m_num_points = num_points;
+    return m_points;
+}
+
+Index* FixedOutputSink::reserve_triangles(Index num_triangles)
+{
+    m_num_triangles = 0;
+    if (num_triangles > m_max_triangles) {
+        throw std::overflow_error("Output sink is too small: " + std::to_string(num_triangles) +
+                                  " triangles requested, capacity is " +
+                                  std::to_string(m_max_triangles) + ".");
+    }
+    m_num_triangles = num_triangles;
+    return m_triangles;
+}
+
+namespace {
+
+thread_local OutputSinkScope* t_current_scope = nullptr;
+
+template <typename T>
+T* copy_to_block(const T* data, size_t count)
+{
+    T* block = static_cast<T*>(BufferCache::allocate_block(count * sizeof(T)));
+    std::copy(data, data + count, block);
+    return block;
+}
+
+} // namespace
+
+OutputSinkScope::OutputSinkScope(OutputSink* sink)
+    : m_sink(sink)
+    , m_previous(t_current_scope)
+{
+    t_current_scope = this;
+}
+
+OutputSinkScope::~OutputSinkScope()
+{
+    t_current_scope = m_previous;
+}
+
+void OutputSinkScope::provide(int kind, long count, void** list)
+{
+    if (m_sink == nullptr || *list != nullptr || m_error) return;
+    try {
+        if (kind == POINTS) {
+            m_points = m_sink->reserve_points(static_cast<Index>(count));
+            *list = m_points;
+        } else if (kind == TRIANGLES) {
+            m_triangles = m_sink->reserve_triangles(static_cast<Index>(count));
+            *list = m_triangles;
+        }
+    } catch (...) {
+        m_error = std::current_exception();
+    }
+}
+
+void OutputSinkScope::finalize(Scalar*& points, Index num_points, Index*& triangles,
+    Index num_triangles)
+{
+    if (m_error) {
+        if (points != nullptr && points == m_points) {
+            points = copy_to_block(points, static_cast<size_t>(num_points) * 2);
+        }
+        if (triangles != nullptr && triangles == m_triangles) {
+            triangles = copy_to_block(triangles, static_cast<size_t>(num_triangles) * 3);
+        }
+        std::rethrow_exception(m_error);
+    }
+
+    // Caller memory is detached so that it is never released by the engine.
+    if (points != nullptr && points == m_points) {
+        points = nullptr;
+    } else if (points != nullptr && m_sink != nullptr) {
+        m_sink->append_points(points, num_points);
+    }
+    if (triangles != nullptr && triangles == m_triangles) {
+        triangles = nullptr;
+    } else if (triangles != nullptr && m_sink != nullptr) {
+        m_sink->append_triangles(triangles, num_triangles);
+    }
+}
+
+OutputSinkScope* OutputSinkScope::get_current()
+{
+    return t_current_scope;
+}
+
+} // namespace trianglelite
+
+//================== Triangle output hook ========================
+// See `triangle_prelude.h`.
+
+extern "C" void trianglelite_output_hook(int kind, long count, void** list)
+{
+    trianglelite::OutputSinkScope* scope = trianglelite::OutputSinkScope::get_current();
+    if (scope != nullptr) scope->provide(kind, count, list);
+}
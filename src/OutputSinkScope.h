@@ -0,0 +1,51 @@
+#pragma once
+
+#include <trianglelite/OutputSink.h>
+#include <trianglelite/common.h>
+
+#include <exception>
+
+namespace trianglelite {
+
+/**
+ * RAII helper that lets `sink` provide triangle's output arrays on the current thread (see
+ * `trianglelite_output_hook` in `triangle_prelude.h`).
+ *
+ * Exceptions thrown by the sink are caught before they reach triangle's C code and rethrown by
+ * `finalize`.
+ */
+class OutputSinkScope
+{
+public:
+    // Must match `TRIANGLELITE_OUTPUT_*` in `triangle_prelude.h`.
+    enum Kind { POINTS = 0, TRIANGLES = 1 };
+
+public:
+    explicit OutputSinkScope(OutputSink* sink);
+    ~OutputSinkScope();
+    OutputSinkScope(const OutputSinkScope&) = delete;
+    OutputSinkScope& operator=(const OutputSinkScope&) = delete;
+
+    /**
+     * Called by triangle right before it allocates an output array of `count` elements.
+     */
+    void provide(int kind, long count, void** list);
+
+    /**
+     * Hand the output to the sink once triangle is done.  Arrays living in sink memory are
+     * detached from the output, and the others are appended to the sink.  If the sink failed, the
+     * output is kept intact (copied out of sink memory if needed) and the error is rethrown.
+     */
+    void finalize(Scalar*& points, Index num_points, Index*& triangles, Index num_triangles);
+
+    static OutputSinkScope* get_current();
+
+private:
+    OutputSink* m_sink;
+    OutputSinkScope* m_previous;
+    Scalar* m_points = nullptr;
+    Index* m_triangles = nullptr;
+    std::exception_ptr m_error;
+};
+
+} // namespace trianglelite
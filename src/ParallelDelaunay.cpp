@@ -0,0 +1,276 @@
+#include "ParallelDelaunay.h"
+#include "Circumcircle.h"
+#include "parallel_for.h"
+
+#include <trianglelite/Engine.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace trianglelite {
+
+namespace {
+
+// Strips smaller than this are not worth the overhead of the merge.
+constexpr Index min_points_per_strip = 1 << 13;
+
+// Number of x coordinates sampled to choose the strip boundaries.
+constexpr Index max_samples = 1 << 16;
+
+/**
+ * Vertical strips [bounds[s - 1], bounds[s]), the first and last ones being unbounded.
+ */
+class Strips
+{
+public:
+    explicit Strips(std::vector<Scalar> bounds)
+        : m_bounds(std::move(bounds))
+    {}
+
+    Index size() const { return static_cast<Index>(m_bounds.size()) + 1; }
+
+    Index find(double x) const
+    {
+        return static_cast<Index>(
+            std::upper_bound(m_bounds.begin(), m_bounds.end(), x) - m_bounds.begin());
+    }
+
+    /**
+     * Whether `circle` lies strictly inside strip `s`.
+     */
+    bool contains(Index s, const Circle& circle) const
+    {
+        const double r = circle.r + circle.error;
+        const bool left = s == 0 || circle.x - r > m_bounds[s - 1];
+        const bool right = s == size() - 1 || circle.x + r < m_bounds[s];
+        return left && right;
+    }
+
+private:
+    std::vector<Scalar> m_bounds;
+};
+
+struct Strip
+{
+    std::vector<Scalar> points;
+    std::vector<Index> ids; // Input index of each point, increasing.
+    PointGrid grid;
+    std::vector<Index> triangles; // Final triangles (input indices).
+    Index num_used = 0; // Number of points used by the strip triangulation.
+    bool degenerate = false; // Too few or collinear points to be triangulated on its own.
+};
+
+} // namespace
+
+Index parallel_delaunay(
+    const Scalar* points, Index num_points, Index num_threads, std::vector<Index>& triangles)
+{
+    num_threads = resolve_num_threads(num_threads);
+    const Index max_strips = std::min(num_threads, num_points / min_points_per_strip);
+    if (max_strips < 2) return 0;
+
+    // Strip boundaries at quantiles of a sample of the x coordinates.  Points with equal x always
+    // share a strip.
+    std::vector<Scalar> samples;
+    const Index stride = std::max<Index>(1, num_points / max_samples);
+    for (Index i = 0; i < num_points; i += stride) {
+        samples.push_back(points[i * 2]);
+    }
+    std::sort(samples.begin(), samples.end());
+    std::vector<Scalar> bounds;
+    for (Index s = 1; s < max_strips; s++) {
+        const Scalar x = samples[samples.size() * s / max_strips];
+        if (x > samples.front() && (bounds.empty() || x > bounds.back())) bounds.push_back(x);
+    }
+    if (bounds.empty()) return 0;
+    const Strips strips(std::move(bounds));
+    const Index num_strips = strips.size();
+
+    // Scatter the points into strips, in parallel over contiguous chunks of the input so that each
+    // strip lists its points in input order.
+    const Index num_chunks = num_threads;
+    const Index chunk_size = (num_points + num_chunks - 1) / num_chunks;
+    std::vector<Index> cursors(static_cast<size_t>(num_chunks) * num_strips, 0);
+    parallel_for(num_chunks, num_threads, [&](Index c) {
+        const Index end = std::min(num_points, (c + 1) * chunk_size);
+        for (Index i = c * chunk_size; i < end; i++) {
+            cursors[c * num_strips + strips.find(points[i * 2])]++;
+        }
+    });
+    std::vector<Strip> strip_data(num_strips);
+    for (Index s = 0; s < num_strips; s++) {
+        Index offset = 0;
+        for (Index c = 0; c < num_chunks; c++) {
+            const Index count = cursors[c * num_strips + s];
+            cursors[c * num_strips + s] = offset;
+            offset += count;
+        }
+        strip_data[s].points.resize(static_cast<size_t>(offset) * 2);
+        strip_data[s].ids.resize(offset);
+    }
+    parallel_for(num_chunks, num_threads, [&](Index c) {
+        Index* cursor = cursors.data() + c * num_strips;
+        const Index end = std::min(num_points, (c + 1) * chunk_size);
+        for (Index i = c * chunk_size; i < end; i++) {
+            Strip& strip = strip_data[strips.find(points[i * 2])];
+            const Index j = cursor[&strip - strip_data.data()]++;
+            strip.points[j * 2] = points[i * 2];
+            strip.points[j * 2 + 1] = points[i * 2 + 1];
+            strip.ids[j] = i;
+        }
+    });
+
+    // Triangulate the strips concurrently.  Points that are not surrounded by final triangles are
+    // gathered for the merge.
+    const Config serial_config = get_serial_delaunay_config();
+    std::vector<uint8_t> is_merged(num_points, 0);
+    parallel_for(num_strips, num_threads, [&](Index s) {
+        Strip& strip = strip_data[s];
+        const Index n = static_cast<Index>(strip.ids.size());
+        strip.grid.build(strip.points.data(), n);
+        if (!has_triangle(strip.points.data(), n)) {
+            strip.degenerate = true;
+            for (Index i : strip.ids) is_merged[i] = 1;
+            return;
+        }
+
+        Engine engine;
+        engine.set_in_points(strip.points.data(), n);
+        engine.run(serial_config);
+        const auto local_triangles = engine.get_out_triangles();
+        const auto neighbors = engine.get_out_triangle_neighbors();
+        const Index num_triangles = static_cast<Index>(local_triangles.rows());
+
+        std::vector<uint8_t> is_used(n, 0);
+        for (Index t = 0; t < num_triangles; t++) {
+            Index v[3] = {local_triangles(t, 0), local_triangles(t, 1), local_triangles(t, 2)};
+            canonicalize(v);
+            for (Index i = 0; i < 3; i++) is_used[v[i]] = 1;
+
+            Circle circle;
+            const Scalar* p = strip.points.data();
+            if (compute_circumcircle(p + v[0] * 2, p + v[1] * 2, p + v[2] * 2, circle) &&
+                strips.contains(s, circle)) {
+                for (Index i = 0; i < 3; i++) strip.triangles.push_back(strip.ids[v[i]]);
+            } else {
+                for (Index i = 0; i < 3; i++) is_merged[strip.ids[v[i]]] = 1;
+            }
+            for (Index i = 0; i < 3; i++) {
+                if (neighbors(t, i) >= 0) continue;
+                is_merged[strip.ids[local_triangles(t, (i + 1) % 3)]] = 1;
+                is_merged[strip.ids[local_triangles(t, (i + 2) % 3)]] = 1;
+            }
+        }
+        strip.num_used = static_cast<Index>(std::count(is_used.begin(), is_used.end(), 1));
+        std::vector<Scalar>().swap(strip.points);
+    });
+
+    // Delaunay triangulation of the merge points.  Its boundary is the convex hull of all points.
+    std::vector<Index> merged_ids;
+    for (Index i = 0; i < num_points; i++) {
+        if (is_merged[i]) merged_ids.push_back(i);
+    }
+    std::vector<uint8_t>().swap(is_merged);
+    const Index num_merged = static_cast<Index>(merged_ids.size());
+    std::vector<Scalar> merged_points(static_cast<size_t>(num_merged) * 2);
+    for (Index i = 0; i < num_merged; i++) {
+        merged_points[i * 2] = points[merged_ids[i] * 2];
+        merged_points[i * 2 + 1] = points[merged_ids[i] * 2 + 1];
+    }
+    if (!has_triangle(merged_points.data(), num_merged)) return 0;
+
+    Engine engine;
+    engine.set_in_points(merged_points.data(), num_merged);
+    engine.run(serial_config);
+    const auto merged_triangles = engine.get_out_triangles();
+    const auto merged_neighbors = engine.get_out_triangle_neighbors();
+    const Index num_merged_triangles = static_cast<Index>(merged_triangles.rows());
+
+    Index hull_size = 0;
+    double hull_area = 0;
+    std::vector<uint8_t> is_used(num_merged, 0);
+    for (Index t = 0; t < num_merged_triangles; t++) {
+        const Scalar* p0 = merged_points.data() + merged_triangles(t, 0) * 2;
+        const Scalar* p1 = merged_points.data() + merged_triangles(t, 1) * 2;
+        const Scalar* p2 = merged_points.data() + merged_triangles(t, 2) * 2;
+        hull_area += signed_area(p0, p1, p2);
+        for (Index i = 0; i < 3; i++) {
+            if (merged_neighbors(t, i) < 0) hull_size++;
+            is_used[merged_triangles(t, i)] = 1;
+        }
+    }
+
+    // Distinct points, i.e. ignoring duplicates which triangle leaves out.
+    Index num_unique = 0;
+    for (const auto& strip : strip_data) num_unique += strip.num_used;
+    for (Index i = 0; i < num_merged; i++) {
+        if (is_used[i] && strip_data[strips.find(merged_points[i * 2])].degenerate) num_unique++;
+    }
+
+    // Keep the merge triangles whose circumcircle is empty of all points and that are not already
+    // final in their strip.
+    const Index num_blocks = std::min(num_merged_triangles, num_threads * 4);
+    const Index block_size = (num_merged_triangles + num_blocks - 1) / num_blocks;
+    std::vector<std::vector<Index>> seam_triangles(num_blocks);
+    parallel_for(num_blocks, num_threads, [&](Index b) {
+        const Index end = std::min(num_merged_triangles, (b + 1) * block_size);
+        for (Index t = b * block_size; t < end; t++) {
+            Index v[3];
+            for (Index i = 0; i < 3; i++) v[i] = merged_ids[merged_triangles(t, i)];
+            canonicalize(v);
+            const Scalar* p0 = points + v[0] * 2;
+            const Scalar* p1 = points + v[1] * 2;
+            const Scalar* p2 = points + v[2] * 2;
+
+            Circle circle;
+            if (!compute_circumcircle(p0, p1, p2, circle)) continue;
+            if (strips.contains(strips.find(p0[0]), circle)) continue;
+
+            const double r = circle.r + circle.error;
+            const Index last = strips.find(circle.x + r);
+            bool is_empty = true;
+            for (Index s = strips.find(circle.x - r); s <= last && is_empty; s++) {
+                is_empty = !strip_data[s].grid.has_point_inside(p0, p1, p2, circle);
+            }
+            if (is_empty) seam_triangles[b].insert(seam_triangles[b].end(), v, v + 3);
+        }
+    });
+
+    // Gather the final triangles.
+    std::vector<const std::vector<Index>*> parts;
+    for (const auto& strip : strip_data) parts.push_back(&strip.triangles);
+    for (const auto& part : seam_triangles) parts.push_back(&part);
+    std::vector<size_t> offsets(parts.size() + 1, 0);
+    for (size_t i = 0; i < parts.size(); i++) offsets[i + 1] = offsets[i] + parts[i]->size();
+    const Index num_triangles = static_cast<Index>(offsets.back() / 3);
+
+    // Sanity checks: Euler's formula and total area, since degeneracies (e.g. cocircular points
+    // across a strip boundary) may lead to overlapping triangles.
+    if (num_triangles != 2 * num_unique - 2 - hull_size) return 0;
+
+    triangles.resize(offsets.back());
+    std::vector<double> areas(parts.size(), 0);
+    parallel_for(static_cast<Index>(parts.size()), num_threads, [&](Index i) {
+        const std::vector<Index>& part = *parts[i];
+        std::copy(part.begin(), part.end(), triangles.begin() + offsets[i]);
+        double area = 0;
+        for (size_t t = 0; t < part.size(); t += 3) {
+            const Scalar* p0 = points + part[t] * 2;
+            const Scalar* p1 = points + part[t + 1] * 2;
+            const Scalar* p2 = points + part[t + 2] * 2;
+            area += checked_area(p0, p1, p2);
+        }
+        areas[i] = area;
+    });
+    const double area = std::accumulate(areas.begin(), areas.end(), 0.0);
+    if (!(std::abs(area - hull_area) <= 1e-8 * hull_area)) {
+        triangles.clear();
+        return 0;
+    }
+    return num_strips;
+}
+
+} // namespace trianglelite
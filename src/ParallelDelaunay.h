@@ -0,0 +1,31 @@
+#pragma once
+
+#include <trianglelite/common.h>
+
+#include <vector>
+
+namespace trianglelite {
+
+/**
+ * Delaunay triangulation of a point cloud, computed with multiple threads.
+ *
+ * Points are split into vertical strips of similar size that are triangulated concurrently, each
+ * by its own instance of triangle.  A strip triangle whose circumcircle lies strictly inside its
+ * strip cannot contain a point of another strip, so it is final.  The vertices of all other strip
+ * triangles, along with the strip hulls, form a much smaller point set whose Delaunay
+ * triangulation provides the missing triangles across strip boundaries: those whose circumcircle
+ * is empty of all input points.
+ *
+ * @param points       Row major point coordinates.
+ * @param num_points   Number of points.
+ * @param num_threads  Number of threads, non-positive means all hardware threads.
+ * @param triangles    Output row major triangles (counterclockwise, indexing into `points`).
+ *
+ * @returns the number of strips, or 0 if the point cloud is too small to benefit from multiple
+ *          threads or if the result fails its sanity checks (e.g. because of many cocircular
+ *          points), in which case the caller should use a serial triangulation instead.
+ */
+Index parallel_delaunay(
+    const Scalar* points, Index num_points, Index num_threads, std::vector<Index>& triangles);
+
+} // namespace trianglelite
@@ -0,0 +1,613 @@
+#include "ParallelRefinement.h"
+#include "Circumcircle.h"
+#include "SegmentMarkers.h"
+#include "parallel_for.h"
+
+#include <trianglelite/Engine.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace trianglelite {
+
+namespace {
+
+// Upper bound on the number of pieces an edge is pre-split into.
+constexpr Index max_edge_pieces = 1024;
+
+/**
+ * Segments of a mesh indexed by their smaller vertex (CSR), so that the segment of an edge can be
+ * found by scanning a handful of entries.
+ */
+class SegmentIndex
+{
+public:
+    explicit SegmentIndex(const SegmentMesh& mesh)
+        : m_segments(mesh.segments)
+        , m_offsets(mesh.num_points() + 1, 0)
+        , m_ids(mesh.num_segments())
+    {
+        const Index num_segments = mesh.num_segments();
+        for (Index i = 0; i < num_segments; i++) {
+            m_offsets[min_vertex(i) + 1]++;
+        }
+        std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+        std::vector<Index> cursor(m_offsets.begin(), m_offsets.end() - 1);
+        for (Index i = 0; i < num_segments; i++) {
+            m_ids[cursor[min_vertex(i)]++] = i;
+        }
+    }
+
+    /**
+     * Segment joining v0 and v1, or -1.
+     */
+    Index find(Index v0, Index v1) const
+    {
+        const Index v_min = std::min(v0, v1);
+        const Index v_max = std::max(v0, v1);
+        for (Index k = m_offsets[v_min]; k < m_offsets[v_min + 1]; k++) {
+            const Index s = m_ids[k];
+            if (std::max(m_segments[s * 2], m_segments[s * 2 + 1]) == v_max) return s;
+        }
+        return -1;
+    }
+
+private:
+    Index min_vertex(Index s) const { return std::min(m_segments[s * 2], m_segments[s * 2 + 1]); }
+
+private:
+    const std::vector<Index>& m_segments;
+    std::vector<Index> m_offsets;
+    std::vector<Index> m_ids;
+};
+
+/**
+ * Points inserted along a triangle edge, i.e. `count` consecutive points of the partition
+ * starting at `begin`, listed from the edge's second vertex to its first one if `reversed`.
+ */
+struct EdgeSplit
+{
+    Index begin = 0;
+    Index count = 0;
+    bool reversed = false;
+};
+
+} // namespace
+
+Partition partition_mesh(const SegmentMesh& mesh,
+    const std::vector<Index>& neighbors,
+    const Config& config,
+    Index num_parts)
+{
+    const Index num_triangles = mesh.num_triangles();
+    const Index num_segments = mesh.num_segments();
+    const Scalar* points = mesh.points.data();
+    auto vertex = [&](Index t, Index i) { return mesh.triangles[t * 3 + i]; };
+    auto point = [&](Index v) { return points + v * 2; };
+    auto length = [&](Index v0, Index v1) {
+        return std::hypot(
+            double(point(v1)[0]) - point(v0)[0], double(point(v1)[1]) - point(v0)[1]);
+    };
+    auto shortest_edge = [&](Index t) {
+        return std::min({length(vertex(t, 0), vertex(t, 1)),
+            length(vertex(t, 1), vertex(t, 2)),
+            length(vertex(t, 2), vertex(t, 0))});
+    };
+
+    // Assign triangles to vertical strips of similar cost.  Under an area constraint, the number
+    // of output triangles is proportional to area.  Otherwise, it is driven by local features,
+    // which coarse triangles follow.  A triangle that outweighs a strip must not leave the next
+    // ones empty, so cuts never skip a strip and leave a triangle to each of the remaining ones.
+    std::vector<double> weights(num_triangles, 1);
+    std::vector<double> centers(num_triangles);
+    for (Index t = 0; t < num_triangles; t++) {
+        const Scalar* p0 = point(vertex(t, 0));
+        const Scalar* p1 = point(vertex(t, 1));
+        const Scalar* p2 = point(vertex(t, 2));
+        centers[t] = (double(p0[0]) + p1[0] + p2[0]) / 3;
+        if (config.max_area > 0) {
+            weights[t] = signed_area(p0, p1, p2);
+        }
+    }
+    std::vector<Index> order(num_triangles);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(
+        order.begin(), order.end(), [&](Index i, Index j) { return centers[i] < centers[j]; });
+    const double total_weight = std::accumulate(weights.begin(), weights.end(), 0.0);
+    std::vector<Index> parts(num_triangles);
+    double weight = 0;
+    Index part = 0;
+    for (Index k = 0; k < num_triangles; k++) {
+        const Index t = order[k];
+        const Index cut = static_cast<Index>(weight / total_weight * num_parts);
+        part = std::max({part, std::min(cut, part + 1), num_parts - (num_triangles - k)});
+        parts[t] = std::min(part, num_parts - 1);
+        weight += weights[t];
+    }
+
+    Partition result;
+    result.points = mesh.points;
+    result.point_markers = mesh.point_markers;
+    result.point_markers.resize(mesh.num_points(), 0);
+    result.is_interface.resize(mesh.num_points(), 0);
+    result.segment_markers = mesh.segment_markers;
+    result.segment_markers.resize(num_segments, 0);
+    const SegmentIndex segment_index(mesh);
+    const int interface_marker = boundary_segment_marker(num_segments);
+
+    // Pre-split the edges that subdomains may not split: interfaces, which must match on both
+    // sides, and boundary segments unless the boundary must be kept as is.  Pieces are about the
+    // edge length of an equilateral triangle of max area, and no longer than the edges of the
+    // adjacent triangles.
+    const double max_area_length = config.max_area > 0
+                                       ? std::sqrt(4 * double(config.max_area) / std::sqrt(3.0))
+                                       : std::numeric_limits<double>::infinity();
+    std::vector<EdgeSplit> splits(num_triangles * 3);
+    for (Index t = 0; t < num_triangles; t++) {
+        for (Index j = 0; j < 3; j++) {
+            const Index n = neighbors[t * 3 + j];
+            const bool is_interface = n >= 0 && parts[n] != parts[t];
+            if (!(is_interface && t < n) && !(n < 0 && config.split_boundary)) continue;
+
+            const Index v0 = vertex(t, (j + 1) % 3);
+            const Index v1 = vertex(t, (j + 2) % 3);
+            if (is_interface) result.is_interface[v0] = result.is_interface[v1] = 1;
+            double target = std::min(max_area_length, shortest_edge(t));
+            if (n >= 0) target = std::min(target, shortest_edge(n));
+            const double edge_length = length(v0, v1);
+            const Index num_pieces = static_cast<Index>(std::min<double>(
+                max_edge_pieces, std::max(1.0, std::ceil(edge_length / target))));
+            if (num_pieces == 1) continue;
+
+            const Index s = segment_index.find(v0, v1);
+            EdgeSplit split;
+            split.begin = static_cast<Index>(result.points.size() / 2);
+            split.count = num_pieces - 1;
+            for (Index k = 1; k < num_pieces; k++) {
+                const double w = double(k) / num_pieces;
+                result.points.push_back(
+                    static_cast<Scalar>(point(v0)[0] + (double(point(v1)[0]) - point(v0)[0]) * w));
+                result.points.push_back(
+                    static_cast<Scalar>(point(v0)[1] + (double(point(v1)[1]) - point(v0)[1]) * w));
+                result.point_markers.push_back(s >= 0 ? result.segment_markers[s] : 0);
+                result.is_interface.push_back(is_interface ? 1 : 0);
+            }
+            splits[t * 3 + j] = split;
+            if (n >= 0) {
+                for (Index i = 0; i < 3; i++) {
+                    if (neighbors[n * 3 + i] != t) continue;
+                    splits[n * 3 + i] = split;
+                    splits[n * 3 + i].reversed = true;
+                }
+            }
+        }
+    }
+
+    // Triangles with a split edge are replaced by a fan around their centroid.
+    std::vector<Index> centroids(num_triangles, -1);
+    for (Index t = 0; t < num_triangles; t++) {
+        if (splits[t * 3].count + splits[t * 3 + 1].count + splits[t * 3 + 2].count == 0) continue;
+        centroids[t] = static_cast<Index>(result.points.size() / 2);
+        for (Index d = 0; d < 2; d++) {
+            result.points.push_back(static_cast<Scalar>(
+                (double(point(vertex(t, 0))[d]) + point(vertex(t, 1))[d] + point(vertex(t, 2))[d]) /
+                3));
+        }
+        result.point_markers.push_back(0);
+        result.is_interface.push_back(0);
+    }
+
+    // Extract the subdomains.
+    std::vector<Index> part_offsets(num_parts + 1, 0);
+    for (Index t = 0; t < num_triangles; t++) part_offsets[parts[t] + 1]++;
+    std::partial_sum(part_offsets.begin(), part_offsets.end(), part_offsets.begin());
+    std::vector<Index> part_triangles(num_triangles);
+    {
+        std::vector<Index> cursor(part_offsets.begin(), part_offsets.end() - 1);
+        for (Index t = 0; t < num_triangles; t++) part_triangles[cursor[parts[t]]++] = t;
+    }
+
+    result.subdomains.resize(num_parts);
+    result.vertex_ids.resize(num_parts);
+    std::vector<Index> local_ids(result.points.size() / 2, -1);
+    std::vector<Index> chain;
+    for (Index p = 0; p < num_parts; p++) {
+        SegmentMesh& subdomain = result.subdomains[p];
+        std::vector<Index>& vertex_ids = result.vertex_ids[p];
+        auto local = [&](Index v) {
+            if (local_ids[v] < 0) {
+                local_ids[v] = static_cast<Index>(vertex_ids.size());
+                vertex_ids.push_back(v);
+                subdomain.points.push_back(result.points[v * 2]);
+                subdomain.points.push_back(result.points[v * 2 + 1]);
+            }
+            return local_ids[v];
+        };
+        auto add_split_points = [&](Index t, Index j) {
+            const EdgeSplit& split = splits[t * 3 + j];
+            for (Index k = 0; k < split.count; k++) {
+                chain.push_back(
+                    split.reversed ? split.begin + split.count - 1 - k : split.begin + k);
+            }
+        };
+
+        for (Index k = part_offsets[p]; k < part_offsets[p + 1]; k++) {
+            const Index t = part_triangles[k];
+
+            // Boundary of the triangle, counterclockwise.
+            chain.clear();
+            for (Index i = 0; i < 3; i++) {
+                chain.push_back(vertex(t, i));
+                add_split_points(t, (i + 2) % 3);
+            }
+            if (centroids[t] < 0) {
+                subdomain.triangles.insert(subdomain.triangles.end(),
+                    {local(chain[0]), local(chain[1]), local(chain[2])});
+            } else {
+                const Index center = local(centroids[t]);
+                const size_t m = chain.size();
+                for (size_t i = 0; i < m; i++) {
+                    subdomain.triangles.insert(subdomain.triangles.end(),
+                        {center, local(chain[i]), local(chain[(i + 1) % m])});
+                }
+            }
+
+            // Segments: internal ones once, and all edges on the subdomain boundary.
+            for (Index j = 0; j < 3; j++) {
+                const Index n = neighbors[t * 3 + j];
+                const Index v0 = vertex(t, (j + 1) % 3);
+                const Index v1 = vertex(t, (j + 2) % 3);
+                const Index s = segment_index.find(v0, v1);
+                if (n >= 0 && parts[n] == p) {
+                    if (s >= 0 && t < n) {
+                        subdomain.segments.insert(
+                            subdomain.segments.end(), {local(v0), local(v1)});
+                        subdomain.segment_markers.push_back(segment_marker(s));
+                    }
+                    continue;
+                }
+
+                const int marker = s >= 0 ? segment_marker(s) : interface_marker;
+                chain.assign(1, v0);
+                add_split_points(t, j);
+                chain.push_back(v1);
+                for (size_t i = 0; i + 1 < chain.size(); i++) {
+                    subdomain.segments.insert(
+                        subdomain.segments.end(), {local(chain[i]), local(chain[i + 1])});
+                    subdomain.segment_markers.push_back(marker);
+                }
+            }
+        }
+
+        for (Index v : vertex_ids) local_ids[v] = -1;
+    }
+    return result;
+}
+
+SegmentMesh merge_subdomains(const Partition& partition, const Engine* engines)
+{
+    const Index num_parts = static_cast<Index>(partition.subdomains.size());
+    const Index num_shared_points = static_cast<Index>(partition.points.size() / 2);
+    const int num_segment_origins = static_cast<int>(partition.segment_markers.size());
+
+    // Segment of the partitioned mesh a subdomain marker comes from, or -1 for interfaces.
+    auto get_origin = [&](int marker) { return marked_segment(marker, num_segment_origins); };
+
+    // New points, triangles and kept segments of each subdomain are stored consecutively.
+    std::vector<Index> point_offsets(num_parts + 1, num_shared_points);
+    std::vector<Index> triangle_offsets(num_parts + 1, 0);
+    std::vector<Index> segment_offsets(num_parts + 1, 0);
+    for (Index p = 0; p < num_parts; p++) {
+        const Engine& engine = engines[p];
+        const Index num_inputs = static_cast<Index>(partition.vertex_ids[p].size());
+        const auto segment_markers = engine.get_out_segment_markers();
+        Index num_segments = 0;
+        for (Index i = 0; i < segment_markers.size(); i++) {
+            if (get_origin(segment_markers[i]) >= 0) num_segments++;
+        }
+        point_offsets[p + 1] =
+            point_offsets[p] + static_cast<Index>(engine.get_out_points().rows()) - num_inputs;
+        triangle_offsets[p + 1] =
+            triangle_offsets[p] + static_cast<Index>(engine.get_out_triangles().rows());
+        segment_offsets[p + 1] = segment_offsets[p] + num_segments;
+    }
+
+    SegmentMesh result;
+    result.points = partition.points;
+    result.points.resize(static_cast<size_t>(point_offsets.back()) * 2);
+    result.point_markers = partition.point_markers;
+    result.point_markers.resize(point_offsets.back(), 0);
+    result.triangles.resize(static_cast<size_t>(triangle_offsets.back()) * 3);
+    result.segments.resize(static_cast<size_t>(segment_offsets.back()) * 2);
+    result.segment_markers.resize(segment_offsets.back());
+
+    parallel_for(num_parts, num_parts, [&](Index p) {
+        const Engine& engine = engines[p];
+        const std::vector<Index>& vertex_ids = partition.vertex_ids[p];
+        const Index num_inputs = static_cast<Index>(vertex_ids.size());
+        auto global = [&](Index v) {
+            return v < num_inputs ? vertex_ids[v] : point_offsets[p] + v - num_inputs;
+        };
+
+        // Points inserted by triangle are either inside the subdomain or on one of its internal
+        // segments, whose marker they inherit.
+        const auto points = engine.get_out_points();
+        const auto point_markers = engine.get_out_point_markers();
+        for (Index v = num_inputs; v < points.rows(); v++) {
+            const Index i = global(v);
+            result.points[i * 2] = points(v, 0);
+            result.points[i * 2 + 1] = points(v, 1);
+            const int origin = get_origin(point_markers[v]);
+            result.point_markers[i] = origin >= 0 ? partition.segment_markers[origin] : 0;
+        }
+
+        const auto triangles = engine.get_out_triangles();
+        Index* triangles_out = result.triangles.data() + triangle_offsets[p] * 3;
+        for (Index t = 0; t < triangles.rows(); t++) {
+            for (Index i = 0; i < 3; i++) triangles_out[t * 3 + i] = global(triangles(t, i));
+        }
+
+        const auto segments = engine.get_out_segments();
+        const auto segment_markers = engine.get_out_segment_markers();
+        Index s_out = segment_offsets[p];
+        for (Index s = 0; s < segments.rows(); s++) {
+            const int origin = get_origin(segment_markers[s]);
+            if (origin < 0) continue; // Interface.
+            result.segments[s_out * 2] = global(segments(s, 0));
+            result.segments[s_out * 2 + 1] = global(segments(s, 1));
+            result.segment_markers[s_out] = partition.segment_markers[origin];
+            s_out++;
+        }
+    });
+    return result;
+}
+
+std::vector<Index> compute_neighbors(const SegmentMesh& mesh, Index num_threads)
+{
+    const Index num_triangles = mesh.num_triangles();
+    auto vertex = [&](Index t, Index i) { return mesh.triangles[t * 3 + i]; };
+
+    // Triangles around each point (CSR).
+    std::vector<Index> offsets(mesh.num_points() + 1, 0);
+    for (Index v : mesh.triangles) offsets[v + 1]++;
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<Index> incident(mesh.triangles.size());
+    {
+        std::vector<Index> cursor(offsets.begin(), offsets.end() - 1);
+        for (Index t = 0; t < num_triangles; t++) {
+            for (Index i = 0; i < 3; i++) incident[cursor[vertex(t, i)]++] = t;
+        }
+    }
+
+    // The neighbor across edge (a, b) of a counterclockwise triangle is the triangle around b
+    // with edge (b, a).
+    std::vector<Index> neighbors(mesh.triangles.size(), -1);
+    const Index num_blocks = std::min(num_triangles, resolve_num_threads(num_threads) * 4);
+    const Index block_size = num_blocks > 0 ? (num_triangles + num_blocks - 1) / num_blocks : 0;
+    parallel_for(num_blocks, num_threads, [&](Index b) {
+        const Index end = std::min(num_triangles, (b + 1) * block_size);
+        for (Index t = b * block_size; t < end; t++) {
+            for (Index j = 0; j < 3; j++) {
+                const Index v0 = vertex(t, (j + 1) % 3);
+                const Index v1 = vertex(t, (j + 2) % 3);
+                for (Index k = offsets[v1]; k < offsets[v1 + 1]; k++) {
+                    const Index n = incident[k];
+                    Index i = 0;
+                    while (vertex(n, i) != v1) i++;
+                    if (vertex(n, (i + 1) % 3) != v0) continue;
+                    neighbors[t * 3 + j] = n;
+                    break;
+                }
+            }
+        }
+    });
+    return neighbors;
+}
+
+std::vector<Index> select_band(const SegmentMesh& mesh,
+    const std::vector<Index>& neighbors,
+    const std::vector<uint8_t>& is_seed,
+    const Config& config,
+    Index num_rings,
+    Index num_threads)
+{
+    const Index num_triangles = mesh.num_triangles();
+    const SegmentIndex segment_index(mesh);
+    auto vertex = [&](Index t, Index i) { return mesh.triangles[t * 3 + i]; };
+    auto point = [&](Index v) { return mesh.points.data() + v * 2; };
+
+    // Tolerances absorb the rounding of triangle's own tests.
+    const double cos_min_angle = std::cos(config.min_angle * (1 - 1e-6) * std::acos(-1.0) / 180);
+    const double max_area = config.max_area * (1 + 1e-6);
+    auto is_bad = [&](Index t) {
+        const Scalar* p[3] = {point(vertex(t, 0)), point(vertex(t, 1)), point(vertex(t, 2))};
+        const double area = signed_area(p[0], p[1], p[2]);
+        if (config.max_area > 0 && area > max_area) return true;
+        if (config.min_angle <= 0) return false;
+        for (Index i = 0; i < 3; i++) {
+            const Index a = (i + 1) % 3;
+            const Index b = (i + 2) % 3;
+            const double ax = double(p[a][0]) - p[i][0];
+            const double ay = double(p[a][1]) - p[i][1];
+            const double bx = double(p[b][0]) - p[i][0];
+            const double by = double(p[b][1]) - p[i][1];
+            if (ax * bx + ay * by <= cos_min_angle * std::hypot(ax, ay) * std::hypot(bx, by)) {
+                continue;
+            }
+            const Index v = vertex(t, i);
+            if (segment_index.find(v, vertex(t, a)) < 0 ||
+                segment_index.find(v, vertex(t, b)) < 0) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<uint8_t> in_band(num_triangles, 0);
+    const Index num_blocks = std::min(num_triangles, resolve_num_threads(num_threads) * 4);
+    const Index block_size = num_blocks > 0 ? (num_triangles + num_blocks - 1) / num_blocks : 0;
+    parallel_for(num_blocks, num_threads, [&](Index b) {
+        const Index end = std::min(num_triangles, (b + 1) * block_size);
+        for (Index t = b * block_size; t < end; t++) {
+            bool is_selected = false;
+            for (Index i = 0; i < 3 && !is_seed.empty(); i++) {
+                is_selected = is_selected || is_seed[vertex(t, i)];
+            }
+            in_band[t] = is_selected || is_bad(t);
+        }
+    });
+
+    std::vector<Index> band;
+    for (Index t = 0; t < num_triangles; t++) {
+        if (in_band[t]) band.push_back(t);
+    }
+    size_t ring_begin = 0;
+    for (Index r = 0; r < num_rings; r++) {
+        const size_t ring_end = band.size();
+        for (size_t k = ring_begin; k < ring_end; k++) {
+            for (Index j = 0; j < 3; j++) {
+                const Index n = neighbors[band[k] * 3 + j];
+                if (n < 0 || in_band[n]) continue;
+                in_band[n] = 1;
+                band.push_back(n);
+            }
+        }
+        ring_begin = ring_end;
+    }
+    return band;
+}
+
+Band extract_band(const SegmentMesh& mesh,
+    const std::vector<Index>& neighbors,
+    const std::vector<Index>& triangles)
+{
+    const SegmentIndex segment_index(mesh);
+    const int boundary_marker = boundary_segment_marker(mesh.num_segments());
+    std::vector<uint8_t> in_band(mesh.num_triangles(), 0);
+    for (Index t : triangles) in_band[t] = 1;
+
+    Band band;
+    band.triangle_ids = triangles;
+    std::vector<Index> local_ids(mesh.num_points(), -1);
+    auto local = [&](Index v) {
+        if (local_ids[v] < 0) {
+            local_ids[v] = static_cast<Index>(band.vertex_ids.size());
+            band.vertex_ids.push_back(v);
+            band.mesh.points.push_back(mesh.points[v * 2]);
+            band.mesh.points.push_back(mesh.points[v * 2 + 1]);
+        }
+        return local_ids[v];
+    };
+
+    for (Index t : triangles) {
+        for (Index i = 0; i < 3; i++) {
+            band.mesh.triangles.push_back(local(mesh.triangles[t * 3 + i]));
+        }
+
+        // Segments inside of the band once, and all edges on its boundary.
+        for (Index j = 0; j < 3; j++) {
+            const Index n = neighbors[t * 3 + j];
+            const Index v0 = mesh.triangles[t * 3 + (j + 1) % 3];
+            const Index v1 = mesh.triangles[t * 3 + (j + 2) % 3];
+            const Index s = segment_index.find(v0, v1);
+            const bool is_inside = n >= 0 && in_band[n];
+            if (is_inside && (s < 0 || n < t)) continue;
+
+            band.mesh.segments.insert(band.mesh.segments.end(), {local(v0), local(v1)});
+            band.mesh.segment_markers.push_back(s >= 0 ? segment_marker(s) : boundary_marker);
+            if (s >= 0) band.segment_ids.push_back(s);
+        }
+    }
+    return band;
+}
+
+bool splice_band(SegmentMesh& mesh, const Band& band, const Engine& refined)
+{
+    const Index num_inputs = static_cast<Index>(band.vertex_ids.size());
+    const Index num_band_triangles = static_cast<Index>(band.triangle_ids.size());
+    const int num_segment_origins = static_cast<int>(mesh.num_segments());
+    auto get_origin = [&](int marker) { return marked_segment(marker, num_segment_origins); };
+
+    const auto points = refined.get_out_points();
+    const auto point_markers = refined.get_out_point_markers();
+    const auto triangles = refined.get_out_triangles();
+    const auto segments = refined.get_out_segments();
+    const auto segment_markers = refined.get_out_segment_markers();
+    const Index num_triangles = static_cast<Index>(triangles.rows());
+    if (num_triangles < num_band_triangles) return false;
+    for (Index s = 0; s < segments.rows(); s++) {
+        if (get_origin(segment_markers[s]) >= 0) continue;
+        if (segments(s, 0) >= num_inputs || segments(s, 1) >= num_inputs) return false;
+    }
+
+    const Index first_point = mesh.num_points();
+    auto global = [&](Index v) {
+        return v < num_inputs ? band.vertex_ids[v] : first_point + v - num_inputs;
+    };
+    for (Index v = num_inputs; v < points.rows(); v++) {
+        mesh.points.push_back(points(v, 0));
+        mesh.points.push_back(points(v, 1));
+        const int origin = get_origin(point_markers[v]);
+        mesh.point_markers.push_back(origin >= 0 ? mesh.segment_markers[origin] : 0);
+    }
+
+    Index next_slot = mesh.num_triangles();
+    mesh.triangles.resize(mesh.triangles.size() + size_t(num_triangles - num_band_triangles) * 3);
+    for (Index t = 0; t < num_triangles; t++) {
+        const Index slot = t < num_band_triangles ? band.triangle_ids[t] : next_slot++;
+        for (Index i = 0; i < 3; i++) mesh.triangles[slot * 3 + i] = global(triangles(t, i));
+    }
+
+    // Segments of the band are replaced by the refined ones, split or not.
+    std::vector<uint8_t> is_replaced(mesh.num_segments(), 0);
+    for (Index s : band.segment_ids) is_replaced[s] = 1;
+    std::vector<Index> new_segments;
+    std::vector<int> new_segment_markers;
+    for (Index s = 0; s < segments.rows(); s++) {
+        const int origin = get_origin(segment_markers[s]);
+        if (origin < 0) continue; // Boundary of the band.
+        new_segments.insert(new_segments.end(), {global(segments(s, 0)), global(segments(s, 1))});
+        new_segment_markers.push_back(mesh.segment_markers[origin]);
+    }
+    Index num_kept = 0;
+    for (Index s = 0; s < num_segment_origins; s++) {
+        if (is_replaced[s]) continue;
+        mesh.segments[num_kept * 2] = mesh.segments[s * 2];
+        mesh.segments[num_kept * 2 + 1] = mesh.segments[s * 2 + 1];
+        mesh.segment_markers[num_kept] = mesh.segment_markers[s];
+        num_kept++;
+    }
+    mesh.segments.resize(size_t(num_kept) * 2);
+    mesh.segment_markers.resize(num_kept);
+    mesh.segments.insert(mesh.segments.end(), new_segments.begin(), new_segments.end());
+    mesh.segment_markers.insert(
+        mesh.segment_markers.end(), new_segment_markers.begin(), new_segment_markers.end());
+    return true;
+}
+
+void extract_edges(const SegmentMesh& mesh,
+    const std::vector<Index>& neighbors,
+    std::vector<Index>& edges,
+    std::vector<int>& edge_markers)
+{
+    const SegmentIndex segment_index(mesh);
+    edges.clear();
+    edge_markers.clear();
+    for (Index t = 0; t < mesh.num_triangles(); t++) {
+        for (Index j = 0; j < 3; j++) {
+            const Index n = neighbors[t * 3 + j];
+            if (n >= 0 && n < t) continue;
+            const Index v0 = mesh.triangles[t * 3 + (j + 1) % 3];
+            const Index v1 = mesh.triangles[t * 3 + (j + 2) % 3];
+            const Index s = segment_index.find(v0, v1);
+            edges.insert(edges.end(), {v0, v1});
+            edge_markers.push_back(s >= 0 ? mesh.segment_markers[s] : 0);
+        }
+    }
+}
+
+} // namespace trianglelite
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <trianglelite/Config.h>
+#include <trianglelite/common.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace trianglelite {
+
+class Engine;
+
+/**
+ * Triangulation with constraint segments, i.e. the input of a refinement with segments (`rp`).
+ */
+struct SegmentMesh
+{
+    std::vector<Scalar> points; // Row major, 2 coordinates per point.
+    std::vector<int> point_markers; // Empty, or one per point.
+    std::vector<Index> triangles; // Row major, 3 indices per triangle.
+    std::vector<Index> segments; // Row major, 2 indices per segment.
+    std::vector<int> segment_markers; // Empty, or one per segment.
+
+    Index num_points() const { return static_cast<Index>(points.size() / 2); }
+    Index num_triangles() const { return static_cast<Index>(triangles.size() / 3); }
+    Index num_segments() const { return static_cast<Index>(segments.size() / 2); }
+};
+
+/**
+ * A constrained triangulation split into subdomains that can be refined independently.
+ *
+ * Interface edges between subdomains are pre-split into segments that no subdomain may split
+ * further (`Config::split_boundary == false`), so that the refined subdomains match along
+ * their interfaces.  Subdomain segment markers identify where each segment comes from (see
+ * `merge_subdomains`), and subdomain point markers are not set.
+ */
+struct Partition
+{
+    std::vector<Scalar> points; // Vertices shared by all subdomains.
+    std::vector<int> point_markers;
+    std::vector<uint8_t> is_interface; // Whether each point lies on an interface.
+    std::vector<SegmentMesh> subdomains;
+    std::vector<std::vector<Index>> vertex_ids; // Index into `points` of each subdomain vertex.
+    std::vector<int> segment_markers; // Marker of each segment of the partitioned mesh.
+};
+
+/**
+ * Band of triangles of a mesh, extracted as a mesh of its own whose boundary edges are segments
+ * (see `extract_band`).  Segments are marked as in the subdomains of a `Partition`: with the index
+ * of their segment plus 2, and boundary edges that are not segments with one past the last.
+ */
+struct Band
+{
+    SegmentMesh mesh;
+    std::vector<Index> triangle_ids; // Triangle of each band triangle.
+    std::vector<Index> vertex_ids; // Point of each band point.
+    std::vector<Index> segment_ids; // Segments inside of the band or on its boundary.
+};
+
+/**
+ * Split `mesh` into `num_parts` non-empty subdomains of similar refinement cost.
+ *
+ * @param mesh       Constrained triangulation with point and segment markers, whose boundary
+ *                   edges are all segments, and at least `num_parts` triangles.
+ * @param neighbors  Triangle neighbors of `mesh` (triangle's `n` switch).
+ * @param config     Refinement configuration, used to size the interface segments.
+ */
+Partition partition_mesh(const SegmentMesh& mesh,
+    const std::vector<Index>& neighbors,
+    const Config& config,
+    Index num_parts);
+
+/**
+ * Weld the refined subdomains of `partition`, whose outputs are held by `engines`, into a single
+ * mesh with global indices.  Interface segments are dropped, and the other segments and all
+ * points get back the markers of the partitioned mesh.
+ */
+SegmentMesh merge_subdomains(const Partition& partition, const Engine* engines);
+
+/**
+ * Triangle neighbors of `mesh`, the same way triangle lists them (`n` switch): neighbor `i` of a
+ * triangle is across the edge opposite to its vertex `i`, -1 on the boundary.
+ */
+std::vector<Index> compute_neighbors(const SegmentMesh& mesh, Index num_threads);
+
+/**
+ * Triangles of `mesh` within `num_rings` rings of neighbors of a triangle that has a point
+ * flagged in `is_seed` (one flag per point, or empty), or that does not meet the constraints of
+ * `config`.  Small angles between two segments are ignored, since refinement cannot remove them.
+ */
+std::vector<Index> select_band(const SegmentMesh& mesh,
+    const std::vector<Index>& neighbors,
+    const std::vector<uint8_t>& is_seed,
+    const Config& config,
+    Index num_rings,
+    Index num_threads);
+
+/**
+ * Extract the given triangles of `mesh`, which has point and segment markers, as a band to be
+ * refined without splitting its boundary.
+ */
+Band extract_band(const SegmentMesh& mesh,
+    const std::vector<Index>& neighbors,
+    const std::vector<Index>& triangles);
+
+/**
+ * Replace the triangles of `band` in `mesh` by the output of `refined`, a refinement of
+ * `band.mesh`.  Triangles reuse the slots of the band first, new points are appended and take the
+ * marker of the segment they lie on, if any, and the segments of the band are replaced.
+ *
+ * @returns false if `refined` split the boundary of the band or lost triangles, in which case
+ *          `mesh` is left untouched.
+ */
+bool splice_band(SegmentMesh& mesh, const Band& band, const Engine& refined);
+
+/**
+ * Edges of `mesh`, each listed once, the same way triangle lists them (`e` switch), along with
+ * the marker of their segment, or 0.
+ */
+void extract_edges(const SegmentMesh& mesh,
+    const std::vector<Index>& neighbors,
+    std::vector<Index>& edges,
+    std::vector<int>& edge_markers);
+
+} // namespace trianglelite
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <trianglelite/common.h>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace trianglelite {
+
+/**
+ * Row major 2D points stored in either precision (see `CoordinateType`), read as `Scalar`.
+ */
+class PointView
+{
+public:
+    PointView(const void* data, CoordinateType type)
+        : m_data(data)
+        , m_type(type)
+    {}
+
+    static size_t point_size(CoordinateType type)
+    {
+        return type == CoordinateType::FLOAT32 ? 2 * sizeof(float) : 2 * sizeof(double);
+    }
+
+    /**
+     * Coordinate `d` of point `i`.
+     */
+    Scalar operator()(size_t i, Index d) const
+    {
+        return m_type == CoordinateType::FLOAT32
+                   ? static_cast<Scalar>(static_cast<const float*>(m_data)[i * 2 + d])
+                   : static_cast<Scalar>(static_cast<const double*>(m_data)[i * 2 + d]);
+    }
+
+    /**
+     * Copy the `count` points starting at point `first` into `points`.
+     */
+    void copy(size_t first, size_t count, Scalar* points) const
+    {
+        if (m_type == CoordinateType::FLOAT32) {
+            const float* begin = static_cast<const float*>(m_data) + first * 2;
+            std::transform(begin, begin + count * 2, points, [](float v) {
+                return static_cast<Scalar>(v);
+            });
+        } else {
+            const double* begin = static_cast<const double*>(m_data) + first * 2;
+            std::transform(begin, begin + count * 2, points, [](double v) {
+                return static_cast<Scalar>(v);
+            });
+        }
+    }
+
+private:
+    const void* m_data;
+    CoordinateType m_type;
+};
+
+} // namespace trianglelite
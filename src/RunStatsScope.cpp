@@ -0,0 +1,128 @@
+#include "RunStatsScope.h"
+
+#include <algorithm>
+
+namespace trianglelite {
+
+namespace {
+
+thread_local RunStatsScope* t_current_scope = nullptr;
+
+} // namespace
+
+RunStatsScope::RunStatsScope(RunStats& stats)
+    : m_stats(stats)
+    , m_previous(t_current_scope)
+    , m_start(std::chrono::steady_clock::now())
+{
+    m_stats = RunStats();
+    t_current_scope = this;
+}
+
+RunStatsScope::~RunStatsScope()
+{
+    t_current_scope = m_previous;
+    m_stats.total_time =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    if (m_previous == nullptr) return;
+
+    RunStats& outer = m_previous->m_stats;
+    outer.input_time += m_stats.input_time;
+    outer.delaunay_time += m_stats.delaunay_time;
+    outer.segment_time += m_stats.segment_time;
+    outer.hole_time += m_stats.hole_time;
+    outer.quality_time += m_stats.quality_time;
+    outer.output_time += m_stats.output_time;
+    outer.auto_hole_triangulation_time += m_stats.auto_hole_triangulation_time;
+    outer.auto_hole_region_time += m_stats.auto_hole_region_time;
+    outer.auto_hole_winding_time += m_stats.auto_hole_winding_time;
+    outer.auto_hole_extraction_time += m_stats.auto_hole_extraction_time;
+    outer.num_triangle_runs += m_stats.num_triangle_runs;
+    outer.num_orient2d += m_stats.num_orient2d;
+    outer.num_incircle += m_stats.num_incircle;
+    outer.num_exact_orient2d += m_stats.num_exact_orient2d;
+    outer.num_exact_incircle += m_stats.num_exact_incircle;
+    outer.num_subdomains += m_stats.num_subdomains;
+    outer.peak_memory = std::max(outer.peak_memory, m_stats.peak_memory);
+}
+
+void RunStatsScope::phase(int phase, long num_orient2d, long num_incircle)
+{
+    if (phase == 0) {
+        m_stats.num_triangle_runs++;
+        m_num_orient2d = 0;
+        m_num_incircle = 0;
+        m_memory = 0;
+    }
+
+    // Time before phase 0 is spent outside of triangle.
+    double outside = 0;
+    double* const times[] = {&outside,
+        &m_stats.input_time,
+        &m_stats.delaunay_time,
+        &m_stats.segment_time,
+        &m_stats.hole_time,
+        &m_stats.quality_time,
+        &m_stats.output_time};
+    m_timer.lap(*times[std::min(std::max(phase, 0), 6)]);
+
+    m_stats.num_orient2d += num_orient2d - m_num_orient2d;
+    m_stats.num_incircle += num_incircle - m_num_incircle;
+    m_num_orient2d = num_orient2d;
+    m_num_incircle = num_incircle;
+}
+
+void RunStatsScope::exact(int predicate)
+{
+    if (predicate == ORIENT2D) {
+        m_stats.num_exact_orient2d++;
+    } else {
+        m_stats.num_exact_incircle++;
+    }
+}
+
+void RunStatsScope::allocate(size_t size)
+{
+    m_memory += size;
+    m_stats.peak_memory = std::max(m_stats.peak_memory, m_memory);
+}
+
+void RunStatsScope::free(size_t size)
+{
+    m_memory -= std::min(m_memory, size);
+}
+
+RunStatsScope* RunStatsScope::get_current()
+{
+    return t_current_scope;
+}
+
+RunStatsScope::Suspend::Suspend()
+    : m_suspended(t_current_scope)
+{
+    t_current_scope = nullptr;
+}
+
+RunStatsScope::Suspend::~Suspend()
+{
+    t_current_scope = m_suspended;
+}
+
+} // namespace trianglelite
+
+//================== Triangle statistics hooks ========================
+// See `triangle_prelude.h`.
+
+using trianglelite::RunStatsScope;
+
+extern "C" void trianglelite_phase_hook(int phase, long num_orient2d, long num_incircle)
+{
+    RunStatsScope* scope = RunStatsScope::get_current();
+    if (scope != nullptr) scope->phase(phase, num_orient2d, num_incircle);
+}
+
+extern "C" void trianglelite_exact_hook(int predicate)
+{
+    RunStatsScope* scope = RunStatsScope::get_current();
+    if (scope != nullptr) scope->exact(predicate);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <trianglelite/Engine.h>
+
+#include <chrono>
+#include <cstddef>
+
+namespace trianglelite {
+
+/**
+ * Wall clock that adds the time elapsed since its last lap to a phase of `RunStats`.
+ */
+class PhaseTimer
+{
+public:
+    void lap(double& time)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        time += std::chrono::duration<double>(now - m_start).count();
+        m_start = now;
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+};
+
+/**
+ * RAII helper that gathers into `stats` the phases, predicate counts and memory of the triangle
+ * runs made on the current thread (see `trianglelite_phase_hook` in `triangle_prelude.h`).
+ *
+ * `stats` is reset first.  When the scope ends, its total time is set, and everything else is
+ * added to the enclosing scope, if any, so that nested runs count toward the outer one.
+ */
+class RunStatsScope
+{
+public:
+    // Must match `TRIANGLELITE_EXACT_*` in `triangle_prelude.h`.
+    enum Predicate { ORIENT2D = 0, INCIRCLE = 1 };
+
+public:
+    explicit RunStatsScope(RunStats& stats);
+    ~RunStatsScope();
+    RunStatsScope(const RunStatsScope&) = delete;
+    RunStatsScope& operator=(const RunStatsScope&) = delete;
+
+    RunStats& get_stats() { return m_stats; }
+
+    /**
+     * Called by triangle when it starts (phase 0) and at the end of each of its phases.
+     */
+    void phase(int phase, long num_orient2d, long num_incircle);
+
+    /**
+     * Called by triangle when a predicate falls back to exact arithmetic.
+     */
+    void exact(int predicate);
+
+    /**
+     * Called when triangle allocates (frees) a block of `size` bytes.
+     */
+    void allocate(size_t size);
+    void free(size_t size);
+
+    static RunStatsScope* get_current();
+
+    /**
+     * RAII helper that detaches the current thread from the current scope, e.g. while it runs
+     * some of the concurrent tasks of a parallel algorithm, which are not broken down into phases.
+     */
+    class Suspend
+    {
+    public:
+        Suspend();
+        ~Suspend();
+        Suspend(const Suspend&) = delete;
+        Suspend& operator=(const Suspend&) = delete;
+
+    private:
+        RunStatsScope* m_suspended;
+    };
+
+private:
+    RunStats& m_stats;
+    RunStatsScope* m_previous;
+    std::chrono::steady_clock::time_point m_start;
+    PhaseTimer m_timer;
+    long m_num_orient2d = 0; // Counters of the current triangle run at its last phase.
+    long m_num_incircle = 0;
+    size_t m_memory = 0; // Bytes allocated by the current triangle run and not freed yet.
+};
+
+} // namespace trianglelite
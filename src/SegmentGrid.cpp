@@ -0,0 +1,123 @@
+#include "SegmentGrid.h"
+#include "predicates.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
+namespace trianglelite {
+
+SegmentGrid::SegmentGrid(const Scalar* points, const Index* segments, Index num_segments)
+    : m_points(points)
+    , m_segments(segments)
+{
+    if (num_segments <= 0) return;
+
+    Scalar y_min = points[segments[0] * 2 + 1];
+    Scalar y_max = y_min;
+    for (Index i = 0; i < num_segments * 2; i++) {
+        const Scalar y = points[segments[i] * 2 + 1];
+        y_min = std::min(y_min, y);
+        y_max = std::max(y_max, y);
+    }
+
+    // sqrt(#segments) bands balances the cost of long segments spanning many bands against the
+    // number of segments per band.
+    m_y_min = y_min;
+    m_num_bands = std::max<Index>(1, static_cast<Index>(std::sqrt(Scalar(num_segments))));
+    m_inv_band_height = y_max > y_min ? Scalar(m_num_bands) / (y_max - y_min) : 0;
+
+    // Count entries per band.
+    m_band_offsets.assign(m_num_bands + 1, 0);
+    for (Index i = 0; i < num_segments; i++) {
+        const Scalar y0 = points[segments[i * 2] * 2 + 1];
+        const Scalar y1 = points[segments[i * 2 + 1] * 2 + 1];
+        if (y0 == y1) continue; // Horizontal segments never cross a horizontal ray.
+        const Index b0 = get_band(std::min(y0, y1));
+        const Index b1 = get_band(std::max(y0, y1));
+        for (Index b = b0; b <= b1; b++) {
+            m_band_offsets[b + 1]++;
+        }
+    }
+    std::partial_sum(m_band_offsets.begin(), m_band_offsets.end(), m_band_offsets.begin());
+
+    // Fill entries.
+    m_band_segments.resize(m_band_offsets.back());
+    m_band_max_x.resize(m_band_offsets.back());
+    std::vector<Index> cursor(m_band_offsets.begin(), m_band_offsets.end() - 1);
+    for (Index i = 0; i < num_segments; i++) {
+        const Scalar* v0 = points + segments[i * 2] * 2;
+        const Scalar* v1 = points + segments[i * 2 + 1] * 2;
+        if (v0[1] == v1[1]) continue;
+        const Index b0 = get_band(std::min(v0[1], v1[1]));
+        const Index b1 = get_band(std::max(v0[1], v1[1]));
+        for (Index b = b0; b <= b1; b++) {
+            m_band_segments[cursor[b]++] = i;
+        }
+    }
+
+    // Sort each band by decreasing max x.
+    std::vector<Index> order;
+    std::vector<Index> sorted_segments;
+    for (Index b = 0; b < m_num_bands; b++) {
+        const Index begin = m_band_offsets[b];
+        const Index end = m_band_offsets[b + 1];
+        for (Index k = begin; k < end; k++) {
+            const Index i = m_band_segments[k];
+            m_band_max_x[k] =
+                std::max(points[segments[i * 2] * 2], points[segments[i * 2 + 1] * 2]);
+        }
+
+        order.resize(end - begin);
+        std::iota(order.begin(), order.end(), begin);
+        std::sort(order.begin(), order.end(), [&](Index k0, Index k1) {
+            return m_band_max_x[k0] > m_band_max_x[k1];
+        });
+        sorted_segments.resize(end - begin);
+        for (Index k = begin; k < end; k++) {
+            sorted_segments[k - begin] = m_band_segments[order[k - begin]];
+        }
+        std::copy(sorted_segments.begin(), sorted_segments.end(), m_band_segments.begin() + begin);
+        std::sort(m_band_max_x.begin() + begin, m_band_max_x.begin() + end, std::greater<Scalar>());
+    }
+}
+
+Index SegmentGrid::get_band(Scalar y) const
+{
+    const Scalar t = (y - m_y_min) * m_inv_band_height;
+    if (!(t > 0)) return 0;
+    if (t >= Scalar(m_num_bands)) return m_num_bands - 1;
+    return static_cast<Index>(t);
+}
+
+Index SegmentGrid::winding_number(const Scalar* p) const
+{
+    if (m_num_bands == 0) return 0;
+    if (p[1] < m_y_min) return 0;
+
+    const Index b = get_band(p[1]);
+    const Index begin = m_band_offsets[b];
+    const Index end = m_band_offsets[b + 1];
+
+    Index winding_number = 0;
+    for (Index k = begin; k < end; k++) {
+        if (m_band_max_x[k] < p[0]) break; // All remaining segments are to the left of p.
+
+        const Index i = m_band_segments[k];
+        const Scalar* v0 = m_points + m_segments[i * 2] * 2;
+        const Scalar* v1 = m_points + m_segments[i * 2 + 1] * 2;
+        if (v0[1] <= p[1]) {
+            if (v1[1] > p[1] && predicates::orient2d(v0, v1, p) > 0) {
+                winding_number++; // Upward crossing with p on the left.
+            }
+        } else {
+            if (v1[1] <= p[1] && predicates::orient2d(v0, v1, p) < 0) {
+                winding_number--; // Downward crossing with p on the right.
+            }
+        }
+    }
+    return winding_number;
+}
+
+} // namespace trianglelite
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <trianglelite/common.h>
+
+#include <vector>
+
+namespace trianglelite {
+
+/**
+ * Acceleration structure for point queries against a set of oriented segments.
+ *
+ * Segments are bucketed into uniform horizontal bands.  A query only visits the band containing
+ * the query point, and within a band segments are sorted by decreasing max x so that segments
+ * entirely to the left of the query point are never visited.
+ */
+class SegmentGrid
+{
+public:
+    /**
+     * @param points        Row major point coordinates, i.e. [x0, y0, x1, y1, ...].
+     * @param segments      Row major oriented segments, i.e. [s00, s01, s10, s11, ...].
+     * @param num_segments  Number of segments.
+     */
+    SegmentGrid(const Scalar* points, const Index* segments, Index num_segments);
+
+    /**
+     * Compute the winding number of a point with respect to the segments by counting signed
+     * crossings of the ray going from `p` in +x direction.  Uses exact orientation predicates.
+     *
+     * The result is only meaningful if the segments form closed loops, and `p` should not lie on
+     * any segment.
+     */
+    Index winding_number(const Scalar* p) const;
+
+private:
+    Index get_band(Scalar y) const;
+
+private:
+    const Scalar* m_points;
+    const Index* m_segments;
+    Scalar m_y_min = 0;
+    Scalar m_inv_band_height = 0;
+    Index m_num_bands = 0;
+    std::vector<Index> m_band_offsets; // CSR offsets into m_band_segments.
+    std::vector<Index> m_band_segments; // Sorted by decreasing max x within each band.
+    std::vector<Scalar> m_band_max_x; // Max x of each entry in m_band_segments.
+};
+
+} // namespace trianglelite
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <trianglelite/common.h>
+
+namespace trianglelite {
+
+/**
+ * Internal runs of triangle mark segment s with `segment_marker(s)`, so that the markers of the
+ * output points, edges and segment pieces identify the input segment they lie on.  Markers 0 and
+ * 1 have a meaning for triangle, hence the offset.
+ */
+constexpr int segment_marker_offset = 2;
+
+inline int segment_marker(Index s)
+{
+    return static_cast<int>(s) + segment_marker_offset;
+}
+
+/**
+ * Marker of the edges that bound a submesh without being one of its `num_segments` segments,
+ * i.e. one past the last segment marker.
+ */
+inline int boundary_segment_marker(Index num_segments)
+{
+    return segment_marker(num_segments);
+}
+
+/**
+ * Segment marked with `marker` among `num_segments` segments, or -1 if it marks none of them.
+ */
+inline Index marked_segment(int marker, Index num_segments)
+{
+    const int s = marker - segment_marker_offset;
+    return s >= 0 && s < num_segments ? static_cast<Index>(s) : -1;
+}
+
+} // namespace trianglelite
@@ -0,0 +1,147 @@
+#include "SpatialSort.h"
+#include "parallel_for.h"
+
+#include <algorithm>
+#include <array>
+
+namespace trianglelite {
+
+namespace {
+
+constexpr int hilbert_bits = 16;
+constexpr int radix_bits = 8;
+constexpr int radix_size = 1 << radix_bits;
+
+// Amount of work below which threads are not worth it.
+constexpr Index min_chunk_size = 1 << 16;
+
+/**
+ * Hilbert index of cell (x, y) of a 2^16 x 2^16 grid.
+ */
+uint32_t hilbert_index(uint32_t x, uint32_t y)
+{
+    uint32_t d = 0;
+    for (uint32_t s = 1u << (hilbert_bits - 1); s > 0; s >>= 1) {
+        const uint32_t rx = (x & s) > 0;
+        const uint32_t ry = (y & s) > 0;
+        d += s * s * ((3 * rx) ^ ry);
+        // Rotate the quadrant so that the curve is continuous.
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - (x & (s - 1));
+                y = s - 1 - (y & (s - 1));
+            }
+            std::swap(x, y);
+        }
+        x &= s - 1;
+        y &= s - 1;
+    }
+    return d;
+}
+
+Index get_num_chunks(Index size, Index num_threads)
+{
+    return std::max<Index>(1, std::min(resolve_num_threads(num_threads), size / min_chunk_size));
+}
+
+} // namespace
+
+std::vector<uint32_t> compute_hilbert_keys(
+    const Scalar* points, Index num_points, Index num_threads)
+{
+    std::vector<uint32_t> keys(num_points);
+    if (num_points == 0) return keys;
+
+    const Index num_chunks = get_num_chunks(num_points, num_threads);
+    const Index chunk_size = (num_points + num_chunks - 1) / num_chunks;
+    std::vector<std::array<double, 4>> boxes(num_chunks);
+    parallel_for(num_chunks, num_chunks, [&](Index c) {
+        const Index begin = c * chunk_size;
+        const Index end = std::min(num_points, begin + chunk_size);
+        std::array<double, 4> box{points[begin * 2], points[begin * 2 + 1], points[begin * 2],
+            points[begin * 2 + 1]};
+        for (Index i = begin; i < end; i++) {
+            box[0] = std::min<double>(box[0], points[i * 2]);
+            box[1] = std::min<double>(box[1], points[i * 2 + 1]);
+            box[2] = std::max<double>(box[2], points[i * 2]);
+            box[3] = std::max<double>(box[3], points[i * 2 + 1]);
+        }
+        boxes[c] = box;
+    });
+    std::array<double, 4> box = boxes[0];
+    for (const auto& b : boxes) {
+        box = {std::min(box[0], b[0]), std::min(box[1], b[1]), std::max(box[2], b[2]),
+            std::max(box[3], b[3])};
+    }
+
+    // Same scale along both axes so that the curve follows the geometry.
+    const double extent = std::max(box[2] - box[0], box[3] - box[1]);
+    const double max_cell = (1u << hilbert_bits) - 1;
+    const double scale = extent > 0 ? max_cell / extent : 0;
+    parallel_for(num_chunks, num_chunks, [&](Index c) {
+        const Index begin = c * chunk_size;
+        const Index end = std::min(num_points, begin + chunk_size);
+        for (Index i = begin; i < end; i++) {
+            const double x = std::min(max_cell, (points[i * 2] - box[0]) * scale);
+            const double y = std::min(max_cell, (points[i * 2 + 1] - box[1]) * scale);
+            keys[i] = hilbert_index(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+        }
+    });
+    return keys;
+}
+
+std::vector<Index> sort_by_keys(const std::vector<uint32_t>& keys, Index num_threads)
+{
+    const Index size = static_cast<Index>(keys.size());
+    const Index num_chunks = get_num_chunks(size, num_threads);
+    const Index chunk_size = std::max<Index>(1, (size + num_chunks - 1) / num_chunks);
+
+    std::vector<Index> order(size), buffer(size);
+    for (Index i = 0; i < size; i++) order[i] = i;
+
+    // One pass per digit, each chunk scattering its elements to its own range of every bucket.
+    std::vector<std::array<Index, radix_size>> offsets(num_chunks);
+    for (int shift = 0; shift < 32; shift += radix_bits) {
+        parallel_for(num_chunks, num_chunks, [&](Index c) {
+            auto& counts = offsets[c];
+            counts.fill(0);
+            const Index end = std::min(size, (c + 1) * chunk_size);
+            for (Index i = c * chunk_size; i < end; i++) {
+                counts[(keys[order[i]] >> shift) & (radix_size - 1)]++;
+            }
+        });
+        // Skip digits shared by all keys.
+        bool is_constant = false;
+        for (int digit = 0; digit < radix_size && !is_constant; digit++) {
+            Index count = 0;
+            for (Index c = 0; c < num_chunks; c++) count += offsets[c][digit];
+            is_constant = count == size;
+        }
+        if (is_constant) continue;
+
+        Index offset = 0;
+        for (int digit = 0; digit < radix_size; digit++) {
+            for (Index c = 0; c < num_chunks; c++) {
+                const Index count = offsets[c][digit];
+                offsets[c][digit] = offset;
+                offset += count;
+            }
+        }
+        parallel_for(num_chunks, num_chunks, [&](Index c) {
+            auto& cursor = offsets[c];
+            const Index end = std::min(size, (c + 1) * chunk_size);
+            for (Index i = c * chunk_size; i < end; i++) {
+                buffer[cursor[(keys[order[i]] >> shift) & (radix_size - 1)]++] = order[i];
+            }
+        });
+        order.swap(buffer);
+    }
+    return order;
+}
+
+std::vector<Index> compute_hilbert_order(const Scalar* points, Index num_points, Index num_threads)
+{
+    return sort_by_keys(compute_hilbert_keys(points, num_points, num_threads), num_threads);
+}
+
+} // namespace trianglelite
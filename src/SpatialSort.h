@@ -0,0 +1,28 @@
+#pragma once
+
+#include <trianglelite/common.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace trianglelite {
+
+/**
+ * Hilbert curve index of each point, on a 2^16 x 2^16 grid over the bounding square of the points.
+ */
+std::vector<uint32_t> compute_hilbert_keys(
+    const Scalar* points, Index num_points, Index num_threads = 0);
+
+/**
+ * Stable order of `keys` by increasing value (LSD radix sort), i.e. `order[i]` is the index of
+ * the i-th smallest key.
+ */
+std::vector<Index> sort_by_keys(const std::vector<uint32_t>& keys, Index num_threads = 0);
+
+/**
+ * Order of the points along a Hilbert curve.
+ */
+std::vector<Index> compute_hilbert_order(
+    const Scalar* points, Index num_points, Index num_threads = 0);
+
+} // namespace trianglelite
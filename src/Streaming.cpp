@@ -0,0 +1,750 @@
+#include <trianglelite/Streaming.h>
+#include "Circumcircle.h"
+#include "PointView.h"
+#include "parallel_for.h"
+#include "predicates.h"
+
+#include <trianglelite/Engine.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace trianglelite {
+
+namespace {
+
+// Number of points read at once.
+constexpr Index chunk_size = 1 << 16;
+
+// Largest grid used to look up the seam triangles of the last pass.
+constexpr Index max_circle_grid_size = 1 << 10;
+
+// Number of points buffered per batch before they are spilled.
+constexpr size_t spill_buffer_size = 1 << 12;
+
+constexpr double infinity = std::numeric_limits<double>::infinity();
+
+struct Box
+{
+    double min_x = infinity;
+    double min_y = infinity;
+    double max_x = -infinity;
+    double max_y = -infinity;
+
+    bool contains(const Scalar* p) const
+    {
+        return min_x <= p[0] && p[0] <= max_x && min_y <= p[1] && p[1] <= max_y;
+    }
+};
+
+/**
+ * Squared distance from (x, y) to `box`, zero inside of it.
+ */
+double squared_distance(const Box& box, double x, double y)
+{
+    const double dx = std::max({box.min_x - x, 0.0, x - box.max_x});
+    const double dy = std::max({box.min_y - y, 0.0, y - box.max_y});
+    return dx * dx + dy * dy;
+}
+
+/**
+ * Call `fn(i, p)` for every input point, where `p` points to the coordinates of point `i`.
+ */
+template <typename Fn>
+void for_each_point(PointStream& points, std::vector<Scalar>& buffer, const Fn& fn)
+{
+    const LargeIndex num_points = points.size();
+    buffer.resize(static_cast<size_t>(chunk_size) * 2);
+    for (LargeIndex first = 0; first < num_points; first += chunk_size) {
+        const Index count =
+            static_cast<Index>(std::min<LargeIndex>(chunk_size, num_points - first));
+        points.read(first, count, buffer.data());
+        for (Index i = 0; i < count; i++) fn(first + i, buffer.data() + static_cast<size_t>(i) * 2);
+    }
+}
+
+/**
+ * Uniform grid of tiles over the bounding box of the input.  A tile owns the points of its cell,
+ * and loads the points of its cell extended by the margin.  Cell sides on the bounding box extend
+ * to infinity.
+ */
+class TileGrid
+{
+public:
+    TileGrid(const Box& box, LargeIndex num_points, const StreamingConfig& config)
+        : m_box(box)
+    {
+        const LargeIndex num_tiles =
+            (num_points + config.points_per_tile - 1) / config.points_per_tile;
+        if (num_tiles > std::numeric_limits<Index>::max()) {
+            throw std::runtime_error("Too many tiles, increase points_per_tile");
+        }
+
+        const double width = box.max_x - box.min_x;
+        const double height = box.max_y - box.min_y;
+        if (width > 0 && height > 0) {
+            const double cols = std::round(std::sqrt(num_tiles * width / height));
+            m_num_cols = static_cast<Index>(std::max(1.0, std::min<double>(cols, num_tiles)));
+        } else {
+            m_num_cols = width > 0 ? static_cast<Index>(num_tiles) : 1;
+        }
+        m_num_rows = static_cast<Index>((num_tiles + m_num_cols - 1) / m_num_cols);
+        m_tile_width = width > 0 ? width / m_num_cols : 1;
+        m_tile_height = height > 0 ? height / m_num_rows : 1;
+        m_margin_x = config.margin * m_tile_width;
+        m_margin_y = config.margin * m_tile_height;
+    }
+
+    Index size() const { return m_num_cols * m_num_rows; }
+
+    /**
+     * Tile owning (x, y), or the closest one if (x, y) is outside of the bounding box.
+     */
+    Index find(double x, double y) const
+    {
+        return clamp_row((y - m_box.min_y) / m_tile_height) * m_num_cols +
+               clamp_col((x - m_box.min_x) / m_tile_width);
+    }
+
+    /**
+     * Region whose points are loaded by tile `t`.
+     */
+    Box get_loaded_box(Index t) const
+    {
+        const Index col = t % m_num_cols;
+        const Index row = t / m_num_cols;
+        Box box;
+        box.min_x = col == 0 ? -infinity : m_box.min_x + col * m_tile_width - m_margin_x;
+        box.min_y = row == 0 ? -infinity : m_box.min_y + row * m_tile_height - m_margin_y;
+        box.max_x = col == m_num_cols - 1 ? infinity
+                                          : m_box.min_x + (col + 1) * m_tile_width + m_margin_x;
+        box.max_y = row == m_num_rows - 1 ? infinity
+                                          : m_box.min_y + (row + 1) * m_tile_height + m_margin_y;
+        return box;
+    }
+
+    /**
+     * Call `fn(t)` for every tile `t` that loads point `p`.
+     */
+    template <typename Fn>
+    void for_each_loading_tile(const Scalar* p, const Fn& fn) const
+    {
+        const double x = (p[0] - m_box.min_x) / m_tile_width;
+        const double y = (p[1] - m_box.min_y) / m_tile_height;
+        const double dx = m_margin_x / m_tile_width + 1;
+        const double dy = m_margin_y / m_tile_height + 1;
+        for (Index row = clamp_row(y - dy); row <= clamp_row(y + dy); row++) {
+            for (Index col = clamp_col(x - dx); col <= clamp_col(x + dx); col++) {
+                const Index t = row * m_num_cols + col;
+                if (get_loaded_box(t).contains(p)) fn(t);
+            }
+        }
+    }
+
+    /**
+     * Whether `circle` reaches no part of the bounding box beyond the region loaded by tile `t`,
+     * i.e. all the points it may contain are loaded by `t`.
+     */
+    bool certifies(Index t, const Circle& circle) const
+    {
+        const Box loaded = get_loaded_box(t);
+        Box beyond[4] = {m_box, m_box, m_box, m_box};
+        beyond[0].max_x = loaded.min_x;
+        beyond[1].min_x = loaded.max_x;
+        beyond[2].max_y = loaded.min_y;
+        beyond[3].min_y = loaded.max_y;
+        const double r = circle.r + circle.error;
+        for (const Box& box : beyond) {
+            if (box.min_x > box.max_x || box.min_y > box.max_y) continue;
+            if (squared_distance(box, circle.x, circle.y) <= r * r) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Whether the triangle with circumcircle `circle` is final, i.e. certified by the tile holding
+     * its circumcenter.
+     */
+    bool is_final(const Circle& circle) const
+    {
+        return certifies(find(circle.x, circle.y), circle);
+    }
+
+private:
+    Index clamp_col(double col) const
+    {
+        return static_cast<Index>(std::max(0.0, std::min<double>(col, m_num_cols - 1)));
+    }
+
+    Index clamp_row(double row) const
+    {
+        return static_cast<Index>(std::max(0.0, std::min<double>(row, m_num_rows - 1)));
+    }
+
+private:
+    Box m_box;
+    Index m_num_cols = 1;
+    Index m_num_rows = 1;
+    double m_tile_width = 1;
+    double m_tile_height = 1;
+    double m_margin_x = 0;
+    double m_margin_y = 0;
+};
+
+struct Tile
+{
+    std::vector<Scalar> points; // Loaded points, in input order.
+    std::vector<LargeIndex> ids; // Input index of each loaded point.
+    std::vector<LargeIndex> triangles; // Final triangles written by the tile (input indices).
+    double area = 0; // Total area of `triangles`, NaN if one of them is inverted.
+    LargeIndex num_used = 0; // Number of owned points used by the tile triangulation.
+    std::vector<LargeIndex> seam_ids; // Owned points not surrounded by final triangles.
+    std::vector<Scalar> seam_points;
+    bool degenerate = false; // Too few or collinear points to be triangulated.
+};
+
+struct SpilledPoint
+{
+    Scalar x;
+    Scalar y;
+    LargeIndex id;
+};
+
+/**
+ * Temporary file of points, deleted when closed.  Positions are counted in points.
+ */
+class SpillFile
+{
+public:
+    SpillFile()
+        : m_file(std::tmpfile())
+    {
+        if (m_file == nullptr) throw std::runtime_error("Cannot create a temporary file");
+    }
+    ~SpillFile() { std::fclose(m_file); }
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+
+    void write(LargeIndex first, const SpilledPoint* points, size_t count)
+    {
+        seek(first);
+        if (std::fwrite(points, sizeof(SpilledPoint), count, m_file) != count) {
+            throw std::runtime_error("Failed to write a temporary file");
+        }
+    }
+
+    void read(LargeIndex first, SpilledPoint* points, size_t count)
+    {
+        seek(first);
+        if (std::fread(points, sizeof(SpilledPoint), count, m_file) != count) {
+            throw std::runtime_error("Failed to read a temporary file");
+        }
+    }
+
+private:
+    void seek(LargeIndex first)
+    {
+        const int64_t offset = static_cast<int64_t>(first) * sizeof(SpilledPoint);
+#ifdef _WIN32
+        const int status = _fseeki64(m_file, offset, SEEK_SET);
+#else
+        const int status = fseeko(m_file, static_cast<off_t>(offset), SEEK_SET);
+#endif
+        if (status != 0) throw std::runtime_error("Failed to seek a temporary file");
+    }
+
+private:
+    std::FILE* m_file;
+};
+
+/**
+ * Triangle seen by the seam triangulation, final once its circumcircle is known to be empty.
+ */
+struct SeamTriangle
+{
+    LargeIndex ids[3];
+    Scalar points[6];
+    Circle circle;
+    bool is_empty = true;
+};
+
+/**
+ * Triangulate the points loaded by tile `t`, keep the final triangles it owns, and gather its
+ * owned points that are not surrounded by final triangles.
+ */
+void process_tile(const TileGrid& grid, Index t, Tile& tile)
+{
+    const Index n = static_cast<Index>(tile.ids.size());
+    const Scalar* p = tile.points.data();
+    auto add_seam_points = [&](const std::vector<uint8_t>& is_seam) {
+        for (Index i = 0; i < n; i++) {
+            if (!is_seam[i] || grid.find(p[i * 2], p[i * 2 + 1]) != t) continue;
+            tile.seam_ids.push_back(tile.ids[i]);
+            tile.seam_points.insert(tile.seam_points.end(), p + i * 2, p + i * 2 + 2);
+        }
+    };
+    if (!has_triangle(p, n)) {
+        tile.degenerate = true;
+        add_seam_points(std::vector<uint8_t>(n, 1));
+        return;
+    }
+
+    Engine engine;
+    engine.set_in_points(p, n);
+    engine.run(get_serial_delaunay_config());
+    const auto triangles = engine.get_out_triangles();
+    const auto neighbors = engine.get_out_triangle_neighbors();
+
+    std::vector<uint8_t> is_used(n, 0);
+    std::vector<uint8_t> is_seam(n, 0);
+    for (Index k = 0; k < triangles.rows(); k++) {
+        Index v[3] = {triangles(k, 0), triangles(k, 1), triangles(k, 2)};
+        canonicalize(v);
+        for (Index i = 0; i < 3; i++) is_used[v[i]] = 1;
+
+        Circle circle;
+        const Scalar* p0 = p + v[0] * 2;
+        const Scalar* p1 = p + v[1] * 2;
+        const Scalar* p2 = p + v[2] * 2;
+        // The triangle is only known to be Delaunay if this tile certifies it.
+        if (!compute_circumcircle(p0, p1, p2, circle) || !grid.certifies(t, circle) ||
+            !grid.is_final(circle)) {
+            for (Index i = 0; i < 3; i++) is_seam[v[i]] = 1;
+        } else if (grid.find(circle.x, circle.y) == t) {
+            for (Index i = 0; i < 3; i++) tile.triangles.push_back(tile.ids[v[i]]);
+            tile.area += checked_area(p0, p1, p2);
+        }
+        for (Index i = 0; i < 3; i++) {
+            if (neighbors(k, i) >= 0) continue;
+            is_seam[triangles(k, (i + 1) % 3)] = 1;
+            is_seam[triangles(k, (i + 2) % 3)] = 1;
+        }
+    }
+    for (Index i = 0; i < n; i++) {
+        if (is_used[i] && grid.find(p[i * 2], p[i * 2 + 1]) == t) tile.num_used++;
+    }
+    add_seam_points(is_seam);
+}
+
+/**
+ * Mark the seam triangles whose circumcircle contains an input point, in one pass over the input.
+ */
+void check_seam_triangles(PointStream& points,
+    const Box& box,
+    std::vector<SeamTriangle>& seam_triangles,
+    std::vector<Scalar>& buffer)
+{
+    if (seam_triangles.empty()) return;
+
+    // Grid of the circumcircle bounding boxes, clipped to the bounding box of the input.
+    const double width = std::max(box.max_x - box.min_x, std::numeric_limits<double>::min());
+    const double height = std::max(box.max_y - box.min_y, std::numeric_limits<double>::min());
+    const Index size = static_cast<Index>(std::min<double>(
+        max_circle_grid_size, std::ceil(std::sqrt(double(seam_triangles.size())))));
+    auto clamp = [size](double v) {
+        return static_cast<Index>(std::max(0.0, std::min<double>(v, size - 1)));
+    };
+    auto for_each_cell = [&](const SeamTriangle& triangle, auto fn) {
+        const double r = triangle.circle.r + triangle.circle.error;
+        const Index col_end = clamp((triangle.circle.x + r - box.min_x) / width * size);
+        const Index row_end = clamp((triangle.circle.y + r - box.min_y) / height * size);
+        for (Index row = clamp((triangle.circle.y - r - box.min_y) / height * size);
+             row <= row_end;
+             row++) {
+            for (Index col = clamp((triangle.circle.x - r - box.min_x) / width * size);
+                 col <= col_end;
+                 col++) {
+                fn(row * size + col);
+            }
+        }
+    };
+    std::vector<size_t> offsets(static_cast<size_t>(size) * size + 1, 0);
+    for (const auto& triangle : seam_triangles) {
+        for_each_cell(triangle, [&](Index cell) { offsets[cell + 1]++; });
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<Index> cell_triangles(offsets.back());
+    {
+        std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t k = 0; k < seam_triangles.size(); k++) {
+            for_each_cell(seam_triangles[k],
+                [&](Index cell) { cell_triangles[cursor[cell]++] = static_cast<Index>(k); });
+        }
+    }
+
+    for_each_point(points, buffer, [&](LargeIndex, const Scalar* p) {
+        const Index cell = clamp((p[1] - box.min_y) / height * size) * size +
+                           clamp((p[0] - box.min_x) / width * size);
+        for (size_t k = offsets[cell]; k < offsets[cell + 1]; k++) {
+            SeamTriangle& triangle = seam_triangles[cell_triangles[k]];
+            if (!triangle.is_empty) continue;
+            const Circle& circle = triangle.circle;
+            const double dx = p[0] - circle.x;
+            const double dy = p[1] - circle.y;
+            const double r = circle.r + circle.error;
+            if (dx * dx + dy * dy > r * r) continue;
+            const Scalar* q = triangle.points;
+            triangle.is_empty = predicates::incircle(q, q + 2, q + 4, p) <= 0;
+        }
+    });
+}
+
+} // namespace
+
+ArrayPointStream::ArrayPointStream(const float* points, LargeIndex num_points)
+    : m_points(points)
+    , m_coordinate_type(CoordinateType::FLOAT32)
+    , m_num_points(num_points)
+{}
+
+ArrayPointStream::ArrayPointStream(const double* points, LargeIndex num_points)
+    : m_points(points)
+    , m_coordinate_type(CoordinateType::FLOAT64)
+    , m_num_points(num_points)
+{}
+
+void ArrayPointStream::read(LargeIndex first, Index count, Scalar* points)
+{
+    PointView(m_points, m_coordinate_type)
+        .copy(static_cast<size_t>(first), static_cast<size_t>(count), points);
+}
+
+MappedPointFile::MappedPointFile(const std::string& filename, CoordinateType coordinate_type)
+    : m_coordinate_type(coordinate_type)
+{
+    const size_t point_size = PointView::point_size(coordinate_type);
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Cannot open " + filename);
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart % point_size != 0) {
+        CloseHandle(file);
+        throw std::runtime_error(filename + " does not hold a whole number of points");
+    }
+    if (size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (data == nullptr) {
+            if (mapping) CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::runtime_error("Cannot map " + filename);
+        }
+        m_mapping = mapping;
+        m_points = data;
+    }
+    m_file = file;
+    m_num_points = static_cast<LargeIndex>(size.QuadPart / point_size);
+#else
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + filename);
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) % point_size != 0) {
+        ::close(fd);
+        throw std::runtime_error(filename + " does not hold a whole number of points");
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    if (size > 0) {
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map " + filename);
+        }
+        // Points are read front to back, several times.
+        ::madvise(data, size, MADV_SEQUENTIAL);
+        m_points = data;
+    }
+    ::close(fd); // The mapping stays valid.
+    m_num_points = static_cast<LargeIndex>(size / point_size);
+#endif
+}
+
+MappedPointFile::~MappedPointFile()
+{
+#ifdef _WIN32
+    if (m_points != nullptr) UnmapViewOfFile(const_cast<void*>(m_points));
+    if (m_mapping != nullptr) CloseHandle(m_mapping);
+    if (m_file != nullptr) CloseHandle(m_file);
+#else
+    if (m_points != nullptr) {
+        const size_t size =
+            static_cast<size_t>(m_num_points) * PointView::point_size(m_coordinate_type);
+        ::munmap(const_cast<void*>(m_points), size);
+    }
+#endif
+}
+
+void MappedPointFile::read(LargeIndex first, Index count, Scalar* points)
+{
+    PointView(m_points, m_coordinate_type)
+        .copy(static_cast<size_t>(first), static_cast<size_t>(count), points);
+}
+
+TriangleFileWriter::TriangleFileWriter(const std::string& filename)
+    : m_file(std::fopen(filename.c_str(), "wb"))
+{
+    if (m_file == nullptr) throw std::runtime_error("Cannot create " + filename);
+}
+
+TriangleFileWriter::~TriangleFileWriter()
+{
+    std::fclose(m_file);
+}
+
+void TriangleFileWriter::write_triangles(const LargeIndex* triangles, Index num_triangles)
+{
+    const size_t count = static_cast<size_t>(num_triangles) * 3;
+    if (std::fwrite(triangles, sizeof(LargeIndex), count, m_file) != count) {
+        throw std::runtime_error("Failed to write triangles");
+    }
+}
+
+LargeIndex stream_delaunay(
+    PointStream& points, TriangleWriter& writer, const StreamingConfig& config)
+{
+    if (config.points_per_tile <= 0 || config.max_points_in_memory <= 0 || !(config.margin > 0)) {
+        throw std::runtime_error("Invalid streaming configuration");
+    }
+    const LargeIndex num_points = points.size();
+    if (num_points < 3) return 0;
+    std::vector<Scalar> buffer;
+
+    // Pass 1: bounding box.
+    Box box;
+    for_each_point(points, buffer, [&](LargeIndex, const Scalar* p) {
+        box.min_x = std::min<double>(box.min_x, p[0]);
+        box.min_y = std::min<double>(box.min_y, p[1]);
+        box.max_x = std::max<double>(box.max_x, p[0]);
+        box.max_y = std::max<double>(box.max_y, p[1]);
+    });
+    const TileGrid grid(box, num_points, config);
+    const Index num_tiles = grid.size();
+
+    // Pass 2: number of points loaded by each tile, to plan the batches.
+    std::vector<LargeIndex> num_loaded(num_tiles, 0);
+    for_each_point(points, buffer, [&](LargeIndex, const Scalar* p) {
+        grid.for_each_loading_tile(p, [&](Index t) { num_loaded[t]++; });
+    });
+
+    // Batches of consecutive tiles, which are triangulated concurrently.  The points of a batch
+    // take at most `capacity` entries, fewer if some are loaded by several of its tiles.
+    std::vector<Index> batch_begins{0};
+    std::vector<LargeIndex> capacities{0};
+    std::vector<Index> tile_batches(num_tiles);
+    for (Index t = 0; t < num_tiles; t++) {
+        if (num_loaded[t] > std::numeric_limits<Index>::max() / 2) {
+            throw std::runtime_error("Tile too large, decrease points_per_tile");
+        }
+        if (t > batch_begins.back() &&
+            capacities.back() + num_loaded[t] > config.max_points_in_memory) {
+            batch_begins.push_back(t);
+            capacities.push_back(0);
+        }
+        capacities.back() += num_loaded[t];
+        tile_batches[t] = static_cast<Index>(batch_begins.size()) - 1;
+    }
+    const Index num_batches = static_cast<Index>(batch_begins.size());
+    batch_begins.push_back(num_tiles);
+
+    // Pass 3, with several batches: spill the points of each batch, in input order, to its own
+    // region of a temporary file, so that the input is read a constant number of times.
+    std::unique_ptr<SpillFile> spill;
+    std::vector<LargeIndex> spill_offsets(num_batches + 1, 0);
+    std::vector<LargeIndex> spill_sizes(num_batches, 0);
+    if (num_batches > 1) {
+        spill.reset(new SpillFile());
+        std::partial_sum(capacities.begin(), capacities.end(), spill_offsets.begin() + 1);
+        std::vector<std::vector<SpilledPoint>> pending(num_batches);
+        auto flush = [&](Index b) {
+            if (pending[b].empty()) return;
+            spill->write(spill_offsets[b] + spill_sizes[b], pending[b].data(), pending[b].size());
+            spill_sizes[b] += static_cast<LargeIndex>(pending[b].size());
+            pending[b].clear();
+        };
+        for_each_point(points, buffer, [&](LargeIndex i, const Scalar* p) {
+            // Loading tiles come in increasing order, so a batch shows up in a single run.
+            Index last_batch = -1;
+            grid.for_each_loading_tile(p, [&](Index t) {
+                const Index b = tile_batches[t];
+                if (b == last_batch) return;
+                last_batch = b;
+                pending[b].push_back({p[0], p[1], i});
+                if (pending[b].size() == spill_buffer_size) flush(b);
+            });
+        });
+        for (Index b = 0; b < num_batches; b++) flush(b);
+    }
+
+    // Call `fn(i, p)` for every point loaded by batch `b`, in input order.
+    std::vector<SpilledPoint> spilled;
+    auto for_each_batch_point = [&](Index b, const auto& fn) {
+        if (!spill) {
+            for_each_point(points, buffer, fn);
+            return;
+        }
+        spilled.resize(chunk_size);
+        for (LargeIndex first = 0; first < spill_sizes[b]; first += chunk_size) {
+            const Index count =
+                static_cast<Index>(std::min<LargeIndex>(chunk_size, spill_sizes[b] - first));
+            spill->read(spill_offsets[b] + first, spilled.data(), count);
+            for (Index k = 0; k < count; k++) {
+                const Scalar p[2] = {spilled[k].x, spilled[k].y};
+                fn(spilled[k].id, p);
+            }
+        }
+    };
+
+    LargeIndex num_triangles = 0;
+    LargeIndex num_unique = 0; // Distinct points, i.e. ignoring duplicates left out by triangle.
+    double area = 0;
+    std::vector<uint8_t> is_degenerate(num_tiles, 0);
+    std::vector<LargeIndex> seam_ids;
+    std::vector<Scalar> seam_points;
+
+    for (Index b = 0; b < num_batches; b++) {
+        const Index begin = batch_begins[b];
+        const Index end = batch_begins[b + 1];
+        std::vector<Tile> tiles(end - begin);
+        for (Index t = begin; t < end; t++) {
+            tiles[t - begin].points.reserve(static_cast<size_t>(num_loaded[t]) * 2);
+            tiles[t - begin].ids.reserve(static_cast<size_t>(num_loaded[t]));
+        }
+        for_each_batch_point(b, [&](LargeIndex i, const Scalar* p) {
+            grid.for_each_loading_tile(p, [&](Index t) {
+                if (t < begin || t >= end) return;
+                Tile& tile = tiles[t - begin];
+                tile.points.insert(tile.points.end(), p, p + 2);
+                tile.ids.push_back(i);
+            });
+        });
+        parallel_for(end - begin, config.num_threads, [&](Index k) {
+            process_tile(grid, begin + k, tiles[k]);
+            std::vector<Scalar>().swap(tiles[k].points);
+            std::vector<LargeIndex>().swap(tiles[k].ids);
+        });
+
+        for (Index k = 0; k < end - begin; k++) {
+            const Tile& tile = tiles[k];
+            const Index num_tile_triangles = static_cast<Index>(tile.triangles.size() / 3);
+            if (num_tile_triangles > 0) {
+                writer.write_triangles(tile.triangles.data(), num_tile_triangles);
+            }
+            num_triangles += num_tile_triangles;
+            num_unique += tile.num_used;
+            area += tile.area;
+            is_degenerate[begin + k] = tile.degenerate;
+            seam_ids.insert(seam_ids.end(), tile.seam_ids.begin(), tile.seam_ids.end());
+            seam_points.insert(seam_points.end(), tile.seam_points.begin(), tile.seam_points.end());
+        }
+    }
+    spill.reset();
+
+    // Delaunay triangulation of the seam points, in input order.  Its boundary is the convex hull
+    // of all points.
+    if (seam_ids.size() > static_cast<size_t>(std::numeric_limits<Index>::max() / 2)) {
+        throw std::runtime_error("Too many seam points, increase the margin");
+    }
+    const Index num_seam = static_cast<Index>(seam_ids.size());
+    {
+        std::vector<Index> order(num_seam);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](Index a, Index b) {
+            return seam_ids[a] < seam_ids[b];
+        });
+        std::vector<LargeIndex> sorted_ids(num_seam);
+        std::vector<Scalar> sorted_points(static_cast<size_t>(num_seam) * 2);
+        for (Index i = 0; i < num_seam; i++) {
+            sorted_ids[i] = seam_ids[order[i]];
+            sorted_points[i * 2] = seam_points[order[i] * 2];
+            sorted_points[i * 2 + 1] = seam_points[order[i] * 2 + 1];
+        }
+        seam_ids.swap(sorted_ids);
+        seam_points.swap(sorted_points);
+    }
+    if (!has_triangle(seam_points.data(), num_seam)) {
+        if (num_triangles == 0) return 0; // All points are collinear.
+        throw std::runtime_error("Streaming Delaunay triangulation failed: degenerate seam");
+    }
+
+    Engine engine;
+    engine.set_in_points(seam_points.data(), num_seam);
+    engine.run(get_serial_delaunay_config());
+    const auto triangles = engine.get_out_triangles();
+    const auto neighbors = engine.get_out_triangle_neighbors();
+
+    LargeIndex hull_size = 0;
+    double hull_area = 0;
+    std::vector<uint8_t> is_used(num_seam, 0);
+    std::vector<SeamTriangle> seam_triangles;
+    for (Index k = 0; k < triangles.rows(); k++) {
+        Index v[3] = {triangles(k, 0), triangles(k, 1), triangles(k, 2)};
+        canonicalize(v);
+        SeamTriangle triangle;
+        for (Index i = 0; i < 3; i++) {
+            is_used[v[i]] = 1;
+            triangle.ids[i] = seam_ids[v[i]];
+            triangle.points[i * 2] = seam_points[v[i] * 2];
+            triangle.points[i * 2 + 1] = seam_points[v[i] * 2 + 1];
+            if (neighbors(k, i) < 0) hull_size++;
+        }
+        const Scalar* q = triangle.points;
+        hull_area += signed_area(q, q + 2, q + 4);
+        // Final triangles are already written by their tile.
+        if (compute_circumcircle(q, q + 2, q + 4, triangle.circle) &&
+            !grid.is_final(triangle.circle)) {
+            seam_triangles.push_back(triangle);
+        }
+    }
+    for (Index i = 0; i < num_seam; i++) {
+        if (is_used[i] && is_degenerate[grid.find(seam_points[i * 2], seam_points[i * 2 + 1])]) {
+            num_unique++;
+        }
+    }
+
+    // Last pass: keep the seam triangles whose circumcircle is empty of all points.
+    check_seam_triangles(points, box, seam_triangles, buffer);
+    std::vector<LargeIndex> seam_output;
+    for (const auto& triangle : seam_triangles) {
+        if (!triangle.is_empty) continue;
+        seam_output.insert(seam_output.end(), triangle.ids, triangle.ids + 3);
+        const Scalar* q = triangle.points;
+        area += checked_area(q, q + 2, q + 4);
+    }
+    const Index num_seam_triangles = static_cast<Index>(seam_output.size() / 3);
+    if (num_seam_triangles > 0) writer.write_triangles(seam_output.data(), num_seam_triangles);
+    num_triangles += num_seam_triangles;
+
+    // Sanity checks: Euler's formula and total area.
+    if (num_triangles != 2 * num_unique - 2 - hull_size ||
+        !(std::abs(area - hull_area) <= 1e-8 * hull_area)) {
+        throw std::runtime_error("Streaming Delaunay triangulation failed: inconsistent result");
+    }
+    return num_triangles;
+}
+
+} // namespace trianglelite
@@ -0,0 +1,420 @@
+#include <trianglelite/Batch.h>
+#include <trianglelite/Tiling.h>
+#include "PointView.h"
+#include "parallel_for.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace trianglelite {
+
+namespace {
+
+// Segment markers of tile borders.
+constexpr int domain_boundary_marker = 1;
+constexpr int shared_border_marker = 2;
+
+/**
+ * Index of the line `v` lies on, or of the cell between two lines it lies in.
+ */
+Index locate(const std::vector<Scalar>& lines, Scalar v, bool& on_line)
+{
+    const Index last = static_cast<Index>(lines.size()) - 1;
+    const Index i =
+        static_cast<Index>(std::upper_bound(lines.begin(), lines.end(), v) - lines.begin()) - 1;
+    const Index result = std::max<Index>(0, std::min(i, last));
+    on_line = lines[result] == v;
+    return result;
+}
+
+/**
+ * `num_cells + 1` increasing lines from `min_value` to `max_value`, both exact.
+ */
+std::vector<Scalar> split_range(Scalar min_value, Scalar max_value, Index num_cells)
+{
+    std::vector<Scalar> lines(num_cells + 1);
+    for (Index i = 0; i <= num_cells; i++) {
+        lines[i] = static_cast<Scalar>(
+            min_value + (double(max_value) - min_value) * i / num_cells);
+    }
+    lines.front() = min_value;
+    lines.back() = max_value;
+    for (Index i = 0; i < num_cells; i++) {
+        if (!(lines[i] < lines[i + 1])) {
+            throw std::runtime_error("Too many tiles for the extent of the points");
+        }
+    }
+    return lines;
+}
+
+Config get_tile_config(const Config& config)
+{
+    Config tile_config = config;
+    tile_config.split_boundary = false;
+    tile_config.convex_hull = false;
+    tile_config.conforming = false;
+    tile_config.auto_hole_detection = false;
+    tile_config.parallel_refinement = false;
+    if (tile_config.algorithm == Algorithm::PARALLEL_DIVIDE_AND_CONQUER) {
+        tile_config.algorithm = Algorithm::DIVIDE_AND_CONQUER;
+    }
+    tile_config.keep_spatial_order = false;
+    tile_config.output_order = OutputOrder::DEFAULT;
+    tile_config.output_flags |= OUTPUT_POINTS | OUTPUT_TRIANGLES;
+    return tile_config;
+}
+
+} // namespace
+
+TiledMesh::TiledMesh(const float* points, LargeIndex num_points, const TilingConfig& config)
+    : TiledMesh(points, CoordinateType::FLOAT32, num_points, config)
+{}
+
+TiledMesh::TiledMesh(const double* points, LargeIndex num_points, const TilingConfig& config)
+    : TiledMesh(points, CoordinateType::FLOAT64, num_points, config)
+{}
+
+TiledMesh::TiledMesh(const void* points,
+    CoordinateType coordinate_type,
+    LargeIndex num_points,
+    const TilingConfig& config)
+    : m_points(points)
+    , m_coordinate_type(coordinate_type)
+    , m_num_points(num_points)
+    , m_config(config)
+{
+    if (num_points <= 0) throw std::runtime_error("Tiling requires input points");
+    const PointView view(points, coordinate_type);
+    Scalar min_x = view(0, 0), max_x = view(0, 0);
+    Scalar min_y = view(0, 1), max_y = view(0, 1);
+    for (LargeIndex i = 1; i < num_points; i++) {
+        min_x = std::min(min_x, view(i, 0));
+        max_x = std::max(max_x, view(i, 0));
+        min_y = std::min(min_y, view(i, 1));
+        max_y = std::max(max_y, view(i, 1));
+    }
+    const double width = double(max_x) - min_x;
+    const double height = double(max_y) - min_y;
+    if (!(width > 0 && height > 0)) {
+        throw std::runtime_error("Tiling requires points spanning a 2D region");
+    }
+
+    if (config.num_cols > 0 && config.num_rows > 0) {
+        m_num_cols = config.num_cols;
+        m_num_rows = config.num_rows;
+    } else {
+        if (config.points_per_tile <= 0) throw std::runtime_error("Invalid tiling configuration");
+        const LargeIndex tiles = (num_points - 1) / config.points_per_tile + 1;
+        if (tiles > std::numeric_limits<Index>::max()) throw std::runtime_error("Too many tiles");
+        const Index num_tiles = static_cast<Index>(tiles);
+        const double cols = std::round(std::sqrt(num_tiles * width / height));
+        m_num_cols = static_cast<Index>(std::max(1.0, std::min<double>(cols, num_tiles)));
+        m_num_rows = (num_tiles - 1) / m_num_cols + 1;
+    }
+    m_x_lines = split_range(min_x, max_x, m_num_cols);
+    m_y_lines = split_range(min_y, max_y, m_num_rows);
+}
+
+void TiledMesh::place_borders(const Config& config)
+{
+    const Index num_cols = m_num_cols;
+    const Index num_rows = m_num_rows;
+    const double width = double(m_x_lines.back()) - m_x_lines.front();
+    const double height = double(m_y_lines.back()) - m_y_lines.front();
+    double spacing = m_config.border_spacing;
+    if (!(spacing > 0)) {
+        spacing = config.max_area > 0 ? std::sqrt(4 * double(config.max_area) / std::sqrt(3.0))
+                                      : std::sqrt(width * height / double(m_num_points));
+    }
+
+    // Vertical border edge (col, row) goes from corner (col, row) to corner (col, row + 1), and
+    // horizontal border edge (col, row) from corner (col, row) to corner (col + 1, row).
+    const Index num_corners = (num_cols + 1) * (num_rows + 1);
+    const Index num_vertical_edges = (num_cols + 1) * num_rows;
+    const Index num_edges = num_vertical_edges + num_cols * (num_rows + 1);
+    auto corner = [&](Index col, Index row) { return row * (num_cols + 1) + col; };
+    auto vertical_edge = [&](Index col, Index row) { return row * (num_cols + 1) + col; };
+    auto horizontal_edge = [&](Index col, Index row) {
+        return num_vertical_edges + row * num_cols + col;
+    };
+
+    // Sort the input points into tiles, border edges and corners.  Duplicates of a corner are left
+    // out, and triangle leaves out the other duplicates.
+    std::vector<LargeIndex> corner_ids(num_corners, -1);
+    std::vector<std::vector<LargeIndex>> edge_ids(num_edges);
+    std::vector<std::vector<LargeIndex>> tile_ids(get_num_tiles());
+    const PointView view(m_points, m_coordinate_type);
+    for (LargeIndex i = 0; i < m_num_points; i++) {
+        bool on_x, on_y;
+        const Index col = locate(m_x_lines, view(i, 0), on_x);
+        const Index row = locate(m_y_lines, view(i, 1), on_y);
+        if (on_x && on_y) {
+            if (corner_ids[corner(col, row)] < 0) corner_ids[corner(col, row)] = i;
+        } else if (on_x) {
+            edge_ids[vertical_edge(col, row)].push_back(i);
+        } else if (on_y) {
+            edge_ids[horizontal_edge(col, row)].push_back(i);
+        } else {
+            tile_ids[row * num_cols + col].push_back(i);
+        }
+    }
+
+    m_border_points.clear();
+    auto add_border_point = [&](Scalar x, Scalar y) {
+        m_border_points.push_back(x);
+        m_border_points.push_back(y);
+        return m_num_points + static_cast<LargeIndex>(m_border_points.size() / 2) - 1;
+    };
+    for (Index row = 0; row <= num_rows; row++) {
+        for (Index col = 0; col <= num_cols; col++) {
+            LargeIndex& id = corner_ids[corner(col, row)];
+            if (id < 0) id = add_border_point(m_x_lines[col], m_y_lines[row]);
+        }
+    }
+
+    // Border points of each edge, from its first corner to its second one (excluded): the input
+    // points on the edge, and evenly spaced Steiner points that are not too close to them.
+    for (Index e = 0; e < num_edges; e++) {
+        const bool is_vertical = e < num_vertical_edges;
+        const Index k = is_vertical ? e : e - num_vertical_edges;
+        const Index stride = is_vertical ? num_cols + 1 : num_cols;
+        const Index col = k % stride;
+        const Index row = k / stride;
+        const Scalar fixed = is_vertical ? m_x_lines[col] : m_y_lines[row];
+        const Scalar begin = is_vertical ? m_y_lines[row] : m_x_lines[col];
+        const Scalar end = is_vertical ? m_y_lines[row + 1] : m_x_lines[col + 1];
+        auto along = [&](LargeIndex i) { return view(i, is_vertical ? 1 : 0); };
+
+        std::vector<LargeIndex> inputs;
+        inputs.swap(edge_ids[e]);
+        std::sort(inputs.begin(), inputs.end(), [&](LargeIndex i, LargeIndex j) {
+            return along(i) < along(j) || (along(i) == along(j) && i < j);
+        });
+        inputs.erase(std::unique(inputs.begin(),
+                         inputs.end(),
+                         [&](LargeIndex i, LargeIndex j) { return along(i) == along(j); }),
+            inputs.end());
+
+        std::vector<LargeIndex>& ids = edge_ids[e];
+        const double length = double(end) - begin;
+        const Index num_pieces = static_cast<Index>(std::max(1.0, std::ceil(length / spacing)));
+        double previous = -std::numeric_limits<double>::infinity();
+        size_t next = 0;
+        for (Index j = 1; j < num_pieces; j++) {
+            const Scalar v = static_cast<Scalar>(begin + length * j / num_pieces);
+            while (next < inputs.size() && along(inputs[next]) <= v) {
+                previous = along(inputs[next]);
+                ids.push_back(inputs[next++]);
+            }
+            const double following = next < inputs.size()
+                                         ? double(along(inputs[next]))
+                                         : std::numeric_limits<double>::infinity();
+            if (!(begin < v && v < end) || v - previous < spacing / 2 ||
+                following - v < spacing / 2) {
+                continue;
+            }
+            ids.push_back(is_vertical ? add_border_point(fixed, v) : add_border_point(v, fixed));
+        }
+        ids.insert(ids.end(), inputs.begin() + next, inputs.end());
+    }
+
+    // Tile inputs: the border counterclockwise, then the inner points.
+    m_tiles.assign(get_num_tiles(), Tile());
+    parallel_for(get_num_tiles(), m_config.num_threads, [&](Index t) {
+        const Index col = t % num_cols;
+        const Index row = t / num_cols;
+        Tile& tile = m_tiles[t];
+        std::vector<LargeIndex>& ids = tile.point_ids;
+        auto add_side = [&](LargeIndex first_corner, Index e, bool reversed, bool on_boundary) {
+            const size_t begin = ids.size();
+            ids.push_back(first_corner);
+            if (reversed) {
+                ids.insert(ids.end(), edge_ids[e].rbegin(), edge_ids[e].rend());
+            } else {
+                ids.insert(ids.end(), edge_ids[e].begin(), edge_ids[e].end());
+            }
+            const int marker = on_boundary ? domain_boundary_marker : shared_border_marker;
+            tile.segment_markers.insert(tile.segment_markers.end(), ids.size() - begin, marker);
+        };
+        add_side(corner_ids[corner(col, row)], horizontal_edge(col, row), false, row == 0);
+        add_side(corner_ids[corner(col + 1, row)],
+            vertical_edge(col + 1, row),
+            false,
+            col + 1 == num_cols);
+        add_side(corner_ids[corner(col + 1, row + 1)],
+            horizontal_edge(col, row + 1),
+            true,
+            row + 1 == num_rows);
+        add_side(corner_ids[corner(col, row + 1)], vertical_edge(col, row), true, col == 0);
+
+        const Index border_size = static_cast<Index>(ids.size());
+        for (Index i = 0; i < border_size; i++) {
+            tile.segments.push_back(i);
+            tile.segments.push_back((i + 1) % border_size);
+        }
+        ids.insert(ids.end(), tile_ids[t].begin(), tile_ids[t].end());
+        for (LargeIndex id : ids) {
+            if (id < m_num_points) {
+                tile.points.push_back(view(id, 0));
+                tile.points.push_back(view(id, 1));
+            } else {
+                const Scalar* p = m_border_points.data() + (id - m_num_points) * 2;
+                tile.points.insert(tile.points.end(), p, p + 2);
+            }
+        }
+    });
+}
+
+void TiledMesh::run(const Config& config)
+{
+    place_borders(config);
+    const Index num_tiles = get_num_tiles();
+    m_engines.clear();
+    m_engines.resize(num_tiles);
+    for (Index t = 0; t < num_tiles; t++) {
+        const Tile& tile = m_tiles[t];
+        Engine& engine = m_engines[t];
+        engine.set_in_points(tile.points.data(), static_cast<Index>(tile.point_ids.size()));
+        engine.set_in_segments(tile.segments.data(), static_cast<Index>(tile.segments.size() / 2));
+        engine.set_in_segment_markers(
+            tile.segment_markers.data(), static_cast<Index>(tile.segment_markers.size()));
+    }
+    run_batch(m_engines.data(), num_tiles, get_tile_config(config), m_config.num_threads);
+}
+
+void TiledMesh::run_tile(Index tile, const Config& config)
+{
+    check_tile(tile);
+    m_engines[tile].run(get_tile_config(config));
+}
+
+const Engine& TiledMesh::get_tile(Index tile) const
+{
+    check_tile(tile);
+    return m_engines[tile];
+}
+
+std::vector<LargeIndex> TiledMesh::get_tile_point_ids(Index tile) const
+{
+    check_tile(tile);
+    const std::vector<LargeIndex> offsets = get_point_offsets();
+    std::vector<LargeIndex> ids = m_tiles[tile].point_ids;
+    const Index num_inputs = static_cast<Index>(ids.size());
+    const Index num_points = static_cast<Index>(m_engines[tile].get_out_points().rows());
+    for (Index v = num_inputs; v < num_points; v++) {
+        ids.push_back(offsets[tile] + v - num_inputs);
+    }
+    return ids;
+}
+
+void TiledMesh::weld(Matrix2Fr& points, Matrix3Ir& triangles) const
+{
+    if (m_engines.empty()) throw std::runtime_error("Tiles are not meshed yet, call run() first");
+    const Index num_tiles = static_cast<Index>(m_engines.size());
+    const std::vector<LargeIndex> point_offsets = get_point_offsets();
+    std::vector<LargeIndex> triangle_offsets(num_tiles + 1, 0);
+    for (Index t = 0; t < num_tiles; t++) {
+        triangle_offsets[t + 1] = triangle_offsets[t] + m_engines[t].get_out_triangles().rows();
+    }
+    if (point_offsets.back() > std::numeric_limits<Index>::max() ||
+        triangle_offsets.back() > std::numeric_limits<Index>::max()) {
+        throw std::runtime_error(
+            "Welded mesh exceeds 32-bit indices, weld into a TriangleWriter instead");
+    }
+
+    points.resize(point_offsets.back(), 2);
+    triangles.resize(triangle_offsets.back(), 3);
+    PointView(m_points, m_coordinate_type).copy(0, m_num_points, points.data());
+    std::copy(m_border_points.begin(),
+        m_border_points.end(),
+        points.data() + static_cast<size_t>(m_num_points) * 2);
+
+    parallel_for(num_tiles, m_config.num_threads, [&](Index t) {
+        const std::vector<LargeIndex>& ids = m_tiles[t].point_ids;
+        const Index num_inputs = static_cast<Index>(ids.size());
+        auto global = [&](Index v) {
+            return static_cast<Index>(v < num_inputs ? ids[v] : point_offsets[t] + v - num_inputs);
+        };
+
+        const auto tile_points = m_engines[t].get_out_points();
+        for (Index v = num_inputs; v < tile_points.rows(); v++) {
+            points.row(global(v)) = tile_points.row(v);
+        }
+        const auto tile_triangles = m_engines[t].get_out_triangles();
+        for (Index i = 0; i < tile_triangles.rows(); i++) {
+            for (Index j = 0; j < 3; j++) {
+                triangles(triangle_offsets[t] + i, j) = global(tile_triangles(i, j));
+            }
+        }
+    });
+}
+
+LargeIndex TiledMesh::weld(TriangleWriter& writer, std::vector<Scalar>& steiner_points) const
+{
+    if (m_engines.empty()) throw std::runtime_error("Tiles are not meshed yet, call run() first");
+    const Index num_tiles = static_cast<Index>(m_engines.size());
+    const std::vector<LargeIndex> point_offsets = get_point_offsets();
+    steiner_points.resize(static_cast<size_t>(point_offsets.back() - m_num_points) * 2);
+    std::copy(m_border_points.begin(), m_border_points.end(), steiner_points.begin());
+
+    // Tile by tile, in chunks of bounded size.
+    constexpr Index chunk_size = 1 << 16;
+    std::vector<LargeIndex> chunk;
+    chunk.reserve(chunk_size * 3);
+    LargeIndex num_triangles = 0;
+    for (Index t = 0; t < num_tiles; t++) {
+        const std::vector<LargeIndex>& ids = m_tiles[t].point_ids;
+        const Index num_inputs = static_cast<Index>(ids.size());
+        auto global = [&](Index v) {
+            return v < num_inputs ? ids[v] : point_offsets[t] + v - num_inputs;
+        };
+
+        const auto tile_points = m_engines[t].get_out_points();
+        for (Index v = num_inputs; v < tile_points.rows(); v++) {
+            const size_t k = static_cast<size_t>(global(v) - m_num_points) * 2;
+            steiner_points[k] = tile_points(v, 0);
+            steiner_points[k + 1] = tile_points(v, 1);
+        }
+        const auto tile_triangles = m_engines[t].get_out_triangles();
+        for (Index i = 0; i < tile_triangles.rows(); i++) {
+            for (Index j = 0; j < 3; j++) chunk.push_back(global(tile_triangles(i, j)));
+            if (chunk.size() == chunk_size * 3) {
+                writer.write_triangles(chunk.data(), chunk_size);
+                chunk.clear();
+            }
+        }
+        num_triangles += tile_triangles.rows();
+    }
+    if (!chunk.empty()) {
+        writer.write_triangles(chunk.data(), static_cast<Index>(chunk.size() / 3));
+    }
+    return num_triangles;
+}
+
+void TiledMesh::check_tile(Index tile) const
+{
+    if (m_engines.empty()) throw std::runtime_error("Tiles are not meshed yet, call run() first");
+    if (tile < 0 || tile >= get_num_tiles()) throw std::runtime_error("Invalid tile index");
+}
+
+std::vector<LargeIndex> TiledMesh::get_point_offsets() const
+{
+    const Index num_tiles = static_cast<Index>(m_engines.size());
+    std::vector<LargeIndex> offsets(num_tiles + 1);
+    offsets[0] = m_num_points + static_cast<LargeIndex>(m_border_points.size() / 2);
+    for (Index t = 0; t < num_tiles; t++) {
+        const Index num_inputs = static_cast<Index>(m_tiles[t].point_ids.size());
+        const Index num_points = static_cast<Index>(m_engines[t].get_out_points().rows());
+        const Index num_triangles = static_cast<Index>(m_engines[t].get_out_triangles().rows());
+        if (num_points < num_inputs || num_triangles == 0) {
+            throw std::runtime_error("Welding requires output points and triangles");
+        }
+        offsets[t + 1] = offsets[t] + num_points - num_inputs;
+    }
+    return offsets;
+}
+
+} // namespace trianglelite
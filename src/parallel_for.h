@@ -0,0 +1,73 @@
+#pragma once
+
+#include <trianglelite/common.h>
+#include "RunStatsScope.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace trianglelite {
+
+/**
+ * Resolve a user provided thread count: non-positive means all hardware threads.
+ */
+inline Index resolve_num_threads(Index num_threads)
+{
+    if (num_threads <= 0) {
+        num_threads = static_cast<Index>(std::thread::hardware_concurrency());
+    }
+    return std::max<Index>(1, num_threads);
+}
+
+/**
+ * Call `fn(i)` for every task `i` in `[0, num_tasks)` using up to `num_threads` threads, including
+ * the calling one.  Tasks are handed out dynamically in increasing order.  The first exception
+ * thrown by a task is rethrown once all threads are done.  Tasks are not part of the statistics
+ * of the enclosing `Engine::run`, whichever thread runs them.
+ */
+template <typename Fn>
+void parallel_for(Index num_tasks, Index num_threads, const Fn& fn)
+{
+    if (num_tasks <= 0) return;
+    num_threads = std::min(resolve_num_threads(num_threads), num_tasks);
+
+    std::atomic<Index> next_task(0);
+    std::exception_ptr first_error;
+    std::mutex error_mutex;
+
+    auto worker = [&]() {
+        while (true) {
+            const Index k = next_task.fetch_add(1);
+            if (k >= num_tasks) break;
+            try {
+                fn(k);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!first_error) first_error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (Index i = 1; i < num_threads; i++) {
+        threads.emplace_back(worker);
+    }
+    {
+        RunStatsScope::Suspend suspend;
+        worker(); // The calling thread participates as well.
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
+}
+
+} // namespace trianglelite
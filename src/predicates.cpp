@@ -0,0 +1,378 @@
+#include "predicates.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Filtered predicates following J. R. Shewchuk, "Adaptive Precision Floating-Point Arithmetic and
+// Fast Robust Geometric Predicates".  Computation is always carried out in double precision, which
+// is exact for products of float inputs.
+
+namespace trianglelite {
+namespace predicates {
+
+namespace {
+
+constexpr double epsilon = std::numeric_limits<double>::epsilon() / 2;
+constexpr double ccwerrboundA = (3.0 + 16.0 * epsilon) * epsilon;
+constexpr double iccerrboundA = (10.0 + 96.0 * epsilon) * epsilon;
+
+// Points filtered at once by the batch predicates, so that their signs stay in L1 cache.
+constexpr Index batch_block_size = 256;
+
+inline void fast_two_sum(double a, double b, double& x, double& y)
+{
+    x = a + b;
+    const double bvirt = x - a;
+    y = b - bvirt;
+}
+
+inline void two_sum(double a, double b, double& x, double& y)
+{
+    x = a + b;
+    const double bvirt = x - a;
+    const double avirt = x - bvirt;
+    y = (a - avirt) + (b - bvirt);
+}
+
+inline void two_diff(double a, double b, double& x, double& y)
+{
+    x = a - b;
+    const double bvirt = a - x;
+    const double avirt = x + bvirt;
+    y = (a - avirt) + (bvirt - b);
+}
+
+inline void two_product(double a, double b, double& x, double& y)
+{
+    x = a * b;
+    y = std::fma(a, b, -x);
+}
+
+/**
+ * Add `b` to a nonoverlapping expansion `e` (in place), with zero elimination.
+ *
+ * @returns  The new length of the expansion.
+ */
+int grow_expansion(int elen, double* e, double b)
+{
+    double q = b;
+    int hindex = 0;
+    for (int i = 0; i < elen; i++) {
+        double sum, err;
+        two_sum(q, e[i], sum, err);
+        q = sum;
+        if (err != 0) e[hindex++] = err;
+    }
+    if (q != 0 || hindex == 0) e[hindex++] = q;
+    return hindex;
+}
+
+/**
+ * Add the exact product `a * b` to expansion `e` (in place).
+ */
+int grow_expansion_product(int elen, double* e, double a, double b)
+{
+    double p, err;
+    two_product(a, b, p, err);
+    elen = grow_expansion(elen, e, err);
+    return grow_expansion(elen, e, p);
+}
+
+/**
+ * Exact `a * b - c * d` as a 4 component expansion.
+ */
+void two_two_product_diff(double a, double b, double c, double d, double* h)
+{
+    double ab1, ab0, cd1, cd0;
+    two_product(a, b, ab1, ab0);
+    two_product(c, d, cd1, cd0);
+
+    // Two_Two_Diff: (ab1 + ab0) - (cd1 + cd0).
+    double i, j, k;
+    two_diff(ab0, cd0, i, h[0]);
+    two_sum(ab1, i, j, k);
+    two_diff(k, cd1, i, h[1]);
+    two_sum(j, i, h[3], h[2]);
+}
+
+/**
+ * Sum of two nonoverlapping expansions, with zero elimination.
+ *
+ * @returns  The length of `h`, which must have room for `elen + flen` components.
+ */
+int fast_expansion_sum(int elen, const double* e, int flen, const double* f, double* h)
+{
+    auto smaller_e = [](double enow, double fnow) { return (fnow > enow) == (fnow > -enow); };
+
+    double enow = e[0];
+    double fnow = f[0];
+    int eindex = 0, findex = 0;
+    double q;
+    if (smaller_e(enow, fnow)) {
+        q = enow;
+        enow = ++eindex < elen ? e[eindex] : 0;
+    } else {
+        q = fnow;
+        fnow = ++findex < flen ? f[findex] : 0;
+    }
+
+    int hindex = 0;
+    double qnew, hh;
+    if (eindex < elen && findex < flen) {
+        if (smaller_e(enow, fnow)) {
+            fast_two_sum(enow, q, qnew, hh);
+            enow = ++eindex < elen ? e[eindex] : 0;
+        } else {
+            fast_two_sum(fnow, q, qnew, hh);
+            fnow = ++findex < flen ? f[findex] : 0;
+        }
+        q = qnew;
+        if (hh != 0) h[hindex++] = hh;
+        while (eindex < elen && findex < flen) {
+            if (smaller_e(enow, fnow)) {
+                two_sum(q, enow, qnew, hh);
+                enow = ++eindex < elen ? e[eindex] : 0;
+            } else {
+                two_sum(q, fnow, qnew, hh);
+                fnow = ++findex < flen ? f[findex] : 0;
+            }
+            q = qnew;
+            if (hh != 0) h[hindex++] = hh;
+        }
+    }
+    while (eindex < elen) {
+        two_sum(q, enow, qnew, hh);
+        enow = ++eindex < elen ? e[eindex] : 0;
+        q = qnew;
+        if (hh != 0) h[hindex++] = hh;
+    }
+    while (findex < flen) {
+        two_sum(q, fnow, qnew, hh);
+        fnow = ++findex < flen ? f[findex] : 0;
+        q = qnew;
+        if (hh != 0) h[hindex++] = hh;
+    }
+    if (q != 0 || hindex == 0) h[hindex++] = q;
+    return hindex;
+}
+
+/**
+ * Product of a nonoverlapping expansion and a scalar, with zero elimination.
+ *
+ * @returns  The length of `h`, which must have room for `2 * elen` components.
+ */
+int scale_expansion(int elen, const double* e, double b, double* h)
+{
+    double q, hh;
+    two_product(e[0], b, q, hh);
+    int hindex = 0;
+    if (hh != 0) h[hindex++] = hh;
+    for (int i = 1; i < elen; i++) {
+        double product1, product0, sum;
+        two_product(e[i], b, product1, product0);
+        two_sum(q, product0, sum, hh);
+        if (hh != 0) h[hindex++] = hh;
+        fast_two_sum(product1, sum, q, hh);
+        if (hh != 0) h[hindex++] = hh;
+    }
+    if (q != 0 || hindex == 0) h[hindex++] = q;
+    return hindex;
+}
+
+/**
+ * `(px^2 + py^2) * e` where `e` has at most 12 components, scaled by `s` (+1 or -1).
+ */
+int lift_expansion(int elen, const double* e, double px, double py, double s, double* h)
+{
+    double t24x[24], t48x[48], t24y[24], t48y[48];
+    int xlen = scale_expansion(elen, e, px, t24x);
+    xlen = scale_expansion(xlen, t24x, s * px, t48x);
+    int ylen = scale_expansion(elen, e, py, t24y);
+    ylen = scale_expansion(ylen, t24y, s * py, t48y);
+    return fast_expansion_sum(xlen, t48x, ylen, t48y, h);
+}
+
+inline int sign(double v)
+{
+    return (v > 0) - (v < 0);
+}
+
+} // namespace
+
+int orient2d_exact(const Scalar* a, const Scalar* b, const Scalar* c)
+{
+    const double ax = a[0], ay = a[1];
+    const double bx = b[0], by = b[1];
+    const double cx = c[0], cy = c[1];
+
+    // det = ax*by - ax*cy - ay*bx + ay*cx + bx*cy - by*cx, each product is split into 2 terms.
+    double e[13];
+    int elen = 0;
+    elen = grow_expansion_product(elen, e, ax, by);
+    elen = grow_expansion_product(elen, e, -ax, cy);
+    elen = grow_expansion_product(elen, e, -ay, bx);
+    elen = grow_expansion_product(elen, e, ay, cx);
+    elen = grow_expansion_product(elen, e, bx, cy);
+    elen = grow_expansion_product(elen, e, -by, cx);
+
+    // Components are sorted by increasing magnitude, the last one determines the sign.
+    return sign(e[elen - 1]);
+}
+
+int incircle_exact(const Scalar* a, const Scalar* b, const Scalar* c, const Scalar* d)
+{
+    // Laplace expansion of the 4x4 lifted determinant along the lift column, as in Shewchuk's
+    // `incircleexact`, computed directly from the input coordinates.
+    const double pa[2] = {a[0], a[1]};
+    const double pb[2] = {b[0], b[1]};
+    const double pc[2] = {c[0], c[1]};
+    const double pd[2] = {d[0], d[1]};
+
+    double ab[4], bc[4], cd[4], da[4], ac[4], bd[4];
+    two_two_product_diff(pa[0], pb[1], pb[0], pa[1], ab);
+    two_two_product_diff(pb[0], pc[1], pc[0], pb[1], bc);
+    two_two_product_diff(pc[0], pd[1], pd[0], pc[1], cd);
+    two_two_product_diff(pd[0], pa[1], pa[0], pd[1], da);
+    two_two_product_diff(pa[0], pc[1], pc[0], pa[1], ac);
+    two_two_product_diff(pb[0], pd[1], pd[0], pb[1], bd);
+
+    double temp8[8], abc[12], bcd[12], cda[12], dab[12];
+    int templen = fast_expansion_sum(4, cd, 4, da, temp8);
+    const int cdalen = fast_expansion_sum(templen, temp8, 4, ac, cda);
+    templen = fast_expansion_sum(4, da, 4, ab, temp8);
+    const int dablen = fast_expansion_sum(templen, temp8, 4, bd, dab);
+    for (int i = 0; i < 4; i++) {
+        bd[i] = -bd[i];
+        ac[i] = -ac[i];
+    }
+    templen = fast_expansion_sum(4, ab, 4, bc, temp8);
+    const int abclen = fast_expansion_sum(templen, temp8, 4, ac, abc);
+    templen = fast_expansion_sum(4, bc, 4, cd, temp8);
+    const int bcdlen = fast_expansion_sum(templen, temp8, 4, bd, bcd);
+
+    double adet[96], bdet[96], cdet[96], ddet[96];
+    const int alen = lift_expansion(bcdlen, bcd, pa[0], pa[1], 1, adet);
+    const int blen = lift_expansion(cdalen, cda, pb[0], pb[1], -1, bdet);
+    const int clen = lift_expansion(dablen, dab, pc[0], pc[1], 1, cdet);
+    const int dlen = lift_expansion(abclen, abc, pd[0], pd[1], -1, ddet);
+
+    double abdet[192], cddet[192], deter[384];
+    const int ablen = fast_expansion_sum(alen, adet, blen, bdet, abdet);
+    const int cdlen = fast_expansion_sum(clen, cdet, dlen, ddet, cddet);
+    const int deterlen = fast_expansion_sum(ablen, abdet, cdlen, cddet, deter);
+    return sign(deter[deterlen - 1]);
+}
+
+int incircle(const Scalar* a, const Scalar* b, const Scalar* c, const Scalar* d)
+{
+    const double adx = double(a[0]) - d[0], ady = double(a[1]) - d[1];
+    const double bdx = double(b[0]) - d[0], bdy = double(b[1]) - d[1];
+    const double cdx = double(c[0]) - d[0], cdy = double(c[1]) - d[1];
+
+    const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    const double cdxady = cdx * ady, adxcdy = adx * cdy;
+    const double adxbdy = adx * bdy, bdxady = bdx * ady;
+    const double alift = adx * adx + ady * ady;
+    const double blift = bdx * bdx + bdy * bdy;
+    const double clift = cdx * cdx + cdy * cdy;
+
+    const double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) +
+                       clift * (adxbdy - bdxady);
+    const double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift +
+                             (std::abs(cdxady) + std::abs(adxcdy)) * blift +
+                             (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+    const double errbound = iccerrboundA * permanent;
+    if (det > errbound || -det > errbound) {
+        return sign(det);
+    }
+    return incircle_exact(a, b, c, d);
+}
+
+int orient2d(const Scalar* a, const Scalar* b, const Scalar* c)
+{
+    const double detleft = (double(a[0]) - c[0]) * (double(b[1]) - c[1]);
+    const double detright = (double(a[1]) - c[1]) * (double(b[0]) - c[0]);
+    const double det = detleft - detright;
+    const double errbound = ccwerrboundA * (std::abs(detleft) + std::abs(detright));
+    if (det > errbound || -det > errbound) {
+        return sign(det);
+    }
+    return orient2d_exact(a, b, c);
+}
+
+void orient2d_batch(
+    const Scalar* a, const Scalar* b, const Scalar* points, Index num_points, int* signs)
+{
+    const double ax = a[0], ay = a[1];
+    const double bx = b[0], by = b[1];
+    for (Index begin = 0; begin < num_points; begin += batch_block_size) {
+        const Index count = std::min(batch_block_size, num_points - begin);
+        const Scalar* p = points + static_cast<size_t>(begin) * 2;
+        int* s = signs + begin;
+
+        // Filter: the sign if certified, 0 otherwise.
+        int uncertain = 0;
+        for (Index i = 0; i < count; i++) {
+            const double cx = p[i * 2], cy = p[i * 2 + 1];
+            const double detleft = (ax - cx) * (by - cy);
+            const double detright = (ay - cy) * (bx - cx);
+            const double det = detleft - detright;
+            const double errbound = ccwerrboundA * (std::abs(detleft) + std::abs(detright));
+            s[i] = int(det > errbound) - int(-det > errbound);
+            uncertain |= int(s[i] == 0);
+        }
+        if (uncertain == 0) continue;
+        for (Index i = 0; i < count; i++) {
+            if (s[i] == 0) s[i] = orient2d_exact(a, b, p + i * 2);
+        }
+    }
+}
+
+void incircle_batch(const Scalar* a,
+    const Scalar* b,
+    const Scalar* c,
+    const Scalar* points,
+    Index num_points,
+    int* signs)
+{
+    const double ax = a[0], ay = a[1];
+    const double bx = b[0], by = b[1];
+    const double cx = c[0], cy = c[1];
+    for (Index begin = 0; begin < num_points; begin += batch_block_size) {
+        const Index count = std::min(batch_block_size, num_points - begin);
+        const Scalar* p = points + static_cast<size_t>(begin) * 2;
+        int* s = signs + begin;
+
+        int uncertain = 0;
+        for (Index i = 0; i < count; i++) {
+            const double dx = p[i * 2], dy = p[i * 2 + 1];
+            const double adx = ax - dx, ady = ay - dy;
+            const double bdx = bx - dx, bdy = by - dy;
+            const double cdx = cx - dx, cdy = cy - dy;
+
+            const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+            const double cdxady = cdx * ady, adxcdy = adx * cdy;
+            const double adxbdy = adx * bdy, bdxady = bdx * ady;
+            const double alift = adx * adx + ady * ady;
+            const double blift = bdx * bdx + bdy * bdy;
+            const double clift = cdx * cdx + cdy * cdy;
+
+            const double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) +
+                               clift * (adxbdy - bdxady);
+            const double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift +
+                                     (std::abs(cdxady) + std::abs(adxcdy)) * blift +
+                                     (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+            const double errbound = iccerrboundA * permanent;
+            s[i] = int(det > errbound) - int(-det > errbound);
+            uncertain |= int(s[i] == 0);
+        }
+        if (uncertain == 0) continue;
+        for (Index i = 0; i < count; i++) {
+            if (s[i] == 0) s[i] = incircle_exact(a, b, c, p + i * 2);
+        }
+    }
+}
+
+} // namespace predicates
+} // namespace trianglelite
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <trianglelite/common.h>
+
+namespace trianglelite {
+namespace predicates {
+
+/**
+ * Exact 2D orientation predicate.
+ *
+ * A floating point filter is evaluated first, and the exact expansion arithmetic is only used when
+ * the filter cannot certify the sign.
+ *
+ * @returns  1 if (a, b, c) is counterclockwise, -1 if clockwise and 0 if collinear.
+ */
+int orient2d(const Scalar* a, const Scalar* b, const Scalar* c);
+
+/**
+ * Same as `orient2d` but always evaluated with expansion arithmetic.  Exposed for testing.
+ */
+int orient2d_exact(const Scalar* a, const Scalar* b, const Scalar* c);
+
+/**
+ * Exact 2D incircle predicate.
+ *
+ * @returns  1 if d lies inside the circle through (a, b, c), -1 if outside and 0 if cocircular.
+ *           The sign is reversed if (a, b, c) is clockwise.
+ */
+int incircle(const Scalar* a, const Scalar* b, const Scalar* c, const Scalar* d);
+
+/**
+ * Same as `incircle` but always evaluated with expansion arithmetic.  Exposed for testing.
+ */
+int incircle_exact(const Scalar* a, const Scalar* b, const Scalar* c, const Scalar* d);
+
+/**
+ * `orient2d(a, b, c)` for each point c of the row major array `points`, written to `signs`.
+ *
+ * The floating point filter is evaluated over blocks of points in a branch-free loop that the
+ * compiler can vectorize, and only the points it cannot certify go through the exact routine.
+ * Results are identical to those of `orient2d`.
+ */
+void orient2d_batch(
+    const Scalar* a, const Scalar* b, const Scalar* points, Index num_points, int* signs);
+
+/**
+ * `incircle(a, b, c, d)` for each point d of the row major array `points`, written to `signs`.
+ * Evaluated like `orient2d_batch`.
+ */
+void incircle_batch(const Scalar* a,
+    const Scalar* b,
+    const Scalar* c,
+    const Scalar* points,
+    Index num_points,
+    int* signs);
+
+} // namespace predicates
+} // namespace trianglelite
@@ -0,0 +1,53 @@
+/**
+ * Prelude injected at the top of the patched copy of Triangle's `triangle.c` (see
+ * `cmake/triangle.cmake`).  It must remain valid C.
+ */
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#define TRI_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define TRI_THREAD_LOCAL _Thread_local
+#else
+#define TRI_THREAD_LOCAL __thread
+#endif
+
+/**
+ * All of Triangle's heap memory, including its internal pools and the output arrays, goes through
+ * these hooks (defined in `BufferCache.cpp`) so that it can be recycled across runs.
+ */
+void* trianglelite_malloc(size_t size);
+void* trianglelite_calloc(size_t count, size_t size);
+void* trianglelite_realloc(void* ptr, size_t size);
+void trianglelite_free(void* ptr);
+
+#define malloc(size) trianglelite_malloc(size)
+#define calloc(count, size) trianglelite_calloc(count, size)
+#define realloc(ptr, size) trianglelite_realloc(ptr, size)
+#define free(ptr) trianglelite_free(ptr)
+
+/**
+ * Called by triangle right before it allocates the output vertex (triangle) array, which it only
+ * does if the array is still null.  Setting `*list` makes triangle write the `count` output
+ * vertices (triangles) into the given memory instead (see `OutputSink.cpp`).
+ */
+#define TRIANGLELITE_OUTPUT_POINTS 0
+#define TRIANGLELITE_OUTPUT_TRIANGLES 1
+void trianglelite_output_hook(int kind, long count, void** list);
+
+/**
+ * Called by triangle when it starts (phase 0) and at the end of each of its phases: building the
+ * mesh from the input (1), Delaunay triangulation or reconstruction (2), segment insertion (3),
+ * hole carving (4), quality refinement (5) and output (6), with its predicate counters so far.
+ * Called as well when the floating point filter of a predicate fails and exact arithmetic takes
+ * over (see `RunStatsScope.cpp`).
+ */
+#define TRIANGLELITE_EXACT_ORIENT2D 0
+#define TRIANGLELITE_EXACT_INCIRCLE 1
+void trianglelite_phase_hook(int phase, long num_orient2d, long num_incircle);
+void trianglelite_exact_hook(int predicate);
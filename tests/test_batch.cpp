@@ -0,0 +1,77 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <trianglelite/trianglelite.h>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Regular polygon with `n` vertices inscribed in the unit circle.
+void make_polygon(int n, std::vector<trianglelite::Scalar>& points, std::vector<int>& segments)
+{
+    points.resize(n * 2);
+    segments.resize(n * 2);
+    for (int i = 0; i < n; i++) {
+        const double theta = 2 * std::acos(-1.0) * i / n;
+        points[i * 2] = static_cast<trianglelite::Scalar>(std::cos(theta));
+        points[i * 2 + 1] = static_cast<trianglelite::Scalar>(std::sin(theta));
+        segments[i * 2] = i;
+        segments[i * 2 + 1] = (i + 1) % n;
+    }
+}
+
+} // namespace
+
+TEST_CASE("Batch", "[trianglelite][batch]")
+{
+    using namespace trianglelite;
+
+    constexpr int num_jobs = 16;
+    std::vector<std::vector<Scalar>> points(num_jobs);
+    std::vector<std::vector<int>> segments(num_jobs);
+    std::vector<Engine> engines(num_jobs);
+    std::vector<Engine> reference_engines(num_jobs);
+
+    Config config;
+    config.verbose_level = 0;
+    config.max_area = 0.01;
+
+    for (int i = 0; i < num_jobs; i++) {
+        make_polygon(3 + i * 7, points[i], segments[i]);
+        for (auto* engine : {&engines[i], &reference_engines[i]}) {
+            engine->set_in_points(points[i].data(), static_cast<int>(points[i].size() / 2));
+            engine->set_in_segments(segments[i].data(), static_cast<int>(segments[i].size() / 2));
+        }
+        reference_engines[i].run(config);
+    }
+
+    SECTION("Multi-threaded") { run_batch(engines.data(), num_jobs, config, 4); }
+    SECTION("Single-threaded") { run_batch(engines.data(), num_jobs, config, 1); }
+
+    for (int i = 0; i < num_jobs; i++) {
+        const auto out_points = engines[i].get_out_points();
+        const auto out_triangles = engines[i].get_out_triangles();
+        REQUIRE(out_points.rows() == reference_engines[i].get_out_points().rows());
+        REQUIRE(out_triangles.rows() == reference_engines[i].get_out_triangles().rows());
+        REQUIRE(out_points == reference_engines[i].get_out_points());
+        REQUIRE(out_triangles == reference_engines[i].get_out_triangles());
+    }
+}
+
+TEST_CASE("Batch error", "[trianglelite][batch]")
+{
+    using namespace trianglelite;
+
+    std::vector<Scalar> points{0, 0, 1, 0, 0, 1};
+    std::vector<Engine> engines(3);
+    engines[0].set_in_points(points.data(), 3);
+    engines[2].set_in_points(points.data(), 3);
+    // engines[1] has no input, which is an error.
+
+    Config config;
+    config.verbose_level = 0;
+    REQUIRE_THROWS(run_batch(engines.data(), 3, config, 2));
+    REQUIRE(engines[0].get_out_triangles().rows() >= 1);
+    REQUIRE(engines[2].get_out_triangles().rows() >= 1);
+}
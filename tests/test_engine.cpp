@@ -4,7 +4,12 @@
 #include <trianglelite/trianglelite.h>
 
 #include <Eigen/Core>
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <iostream>
+#include <random>
+#include <set>
 
 TEST_CASE("Point cloud", "[trianglelite]")
 {
@@ -40,6 +45,48 @@ TEST_CASE("Point cloud", "[trianglelite]")
     REQUIRE(out_triangles.rows() >= 1);
 }
 
+TEST_CASE("Voronoi", "[trianglelite][voronoi]")
+{
+    using namespace trianglelite;
+
+    Config config;
+    Engine engine;
+    config.verbose_level = 0;
+
+    std::vector<Scalar> points{0, 0, 1, 0, 1, 1, 0, 1, 0.5, 0.4};
+    engine.set_in_points(points.data(), static_cast<int>(points.size() / 2));
+
+    SECTION("Disabled")
+    {
+        engine.run(config);
+        REQUIRE(engine.get_out_triangles().rows() > 0);
+        REQUIRE(engine.get_voronoi_points().rows() == 0);
+        REQUIRE(engine.get_voronoi_edges().rows() == 0);
+    }
+
+    SECTION("Enabled")
+    {
+        config.voronoi = true;
+        engine.run(config);
+
+        auto triangles = engine.get_out_triangles();
+        auto voronoi_points = engine.get_voronoi_points();
+        auto voronoi_edges = engine.get_voronoi_edges();
+        auto voronoi_normals = engine.get_voronoi_normals();
+        REQUIRE(voronoi_points.rows() == triangles.rows());
+        REQUIRE(voronoi_edges.rows() == engine.get_out_edges().rows());
+        REQUIRE(voronoi_normals.rows() == voronoi_edges.rows());
+
+        for (Index i = 0; i < voronoi_edges.rows(); i++) {
+            REQUIRE(voronoi_edges(i, 0) >= 0);
+            REQUIRE(voronoi_edges(i, 0) < voronoi_points.rows());
+            if (voronoi_edges(i, 1) < 0) {
+                REQUIRE(voronoi_normals.row(i).norm() > 0);
+            }
+        }
+    }
+}
+
 TEST_CASE("Quad", "[trianglelite]")
 {
     using namespace trianglelite;
@@ -77,6 +124,9 @@ TEST_CASE("QuadWithHole", "[trianglelite][hole]")
     config.verbose_level = 0;
     config.auto_hole_detection = true;
 
+    SECTION("Remesh") { config.auto_hole_reuse_mesh = false; }
+    SECTION("Reuse mesh") { config.auto_hole_reuse_mesh = true; }
+
     Eigen::Matrix<Scalar, 8, 2, Eigen::RowMajor> points;
     points << 0.0, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0, 1.0, 0.2, 0.2, 0.2, 0.8, 0.8, 0.8, 0.8, 0.2;
     engine.set_in_points(points.data(), static_cast<int>(points.rows()));
@@ -96,6 +146,82 @@ TEST_CASE("QuadWithHole", "[trianglelite][hole]")
     REQUIRE(euler == 0);
 }
 
+TEST_CASE("NestedHoles", "[trianglelite][hole]")
+{
+    using namespace trianglelite;
+
+    Config config;
+    Engine engine;
+
+    config.verbose_level = 0;
+    config.auto_hole_detection = true;
+
+    // Unit square (ccw) with a square hole (cw) containing a square island (ccw).
+    std::vector<Scalar> points{0, 0, 1, 0, 1, 1, 0, 1, 0.2, 0.2, 0.2, 0.8, 0.8, 0.8, 0.8, 0.2, 0.4,
+        0.4, 0.6, 0.4, 0.6, 0.6, 0.4, 0.6};
+    std::vector<Index> segments{
+        0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6, 6, 7, 7, 4, 8, 9, 9, 10, 10, 11, 11, 8};
+    std::vector<int> segment_markers(segments.size() / 2, 7);
+    engine.set_in_points(points.data(), static_cast<int>(points.size() / 2));
+    engine.set_in_segments(segments.data(), static_cast<int>(segments.size() / 2));
+    engine.set_in_segment_markers(segment_markers.data(), static_cast<int>(segment_markers.size()));
+
+    auto compute_total_area = [&]() {
+        auto out_points = engine.get_out_points();
+        auto out_triangles = engine.get_out_triangles();
+        Scalar total_area = 0;
+        for (Index i = 0; i < out_triangles.rows(); i++) {
+            const Eigen::Matrix<Scalar, 1, 2> e0 =
+                out_points.row(out_triangles(i, 1)) - out_points.row(out_triangles(i, 0));
+            const Eigen::Matrix<Scalar, 1, 2> e1 =
+                out_points.row(out_triangles(i, 2)) - out_points.row(out_triangles(i, 0));
+            total_area += (e0[0] * e1[1] - e0[1] * e1[0]) / 2;
+        }
+        return total_area;
+    };
+
+    SECTION("Reuse mesh")
+    {
+        config.auto_hole_reuse_mesh = true;
+        engine.run(config);
+        REQUIRE_THAT(compute_total_area(), Catch::Matchers::WithinAbs(1 - 0.36 + 0.04, 1e-6));
+
+        auto out_segment_markers = engine.get_out_segment_markers();
+        REQUIRE(out_segment_markers.size() > 0);
+        for (Index i = 0; i < out_segment_markers.size(); i++) {
+            REQUIRE(out_segment_markers[i] == 7);
+        }
+    }
+
+    SECTION("Closed loops")
+    {
+        engine.run(config);
+        REQUIRE_THAT(compute_total_area(), Catch::Matchers::WithinAbs(1 - 0.36 + 0.04, 1e-6));
+
+        // User segment markers are preserved.
+        auto out_segment_markers = engine.get_out_segment_markers();
+        REQUIRE(out_segment_markers.size() > 0);
+        for (Index i = 0; i < out_segment_markers.size(); i++) {
+            REQUIRE(out_segment_markers[i] == 7);
+        }
+    }
+
+    SECTION("Shared edge")
+    {
+        // Split the unit square into two ccw rectangles sharing the edge (12, 13).
+        points.insert(points.end(), {0.1, 0, 0.1, 1});
+        segments = {0, 12, 12, 13, 13, 3, 3, 0, 12, 1, 1, 2, 2, 13, 13, 12, 4, 5, 5, 6, 6, 7, 7,
+            4, 8, 9, 9, 10, 10, 11, 11, 8};
+        segment_markers.assign(segments.size() / 2, 7);
+        engine.set_in_points(points.data(), static_cast<int>(points.size() / 2));
+        engine.set_in_segments(segments.data(), static_cast<int>(segments.size() / 2));
+        engine.set_in_segment_markers(
+            segment_markers.data(), static_cast<int>(segment_markers.size()));
+        engine.run(config);
+        REQUIRE_THAT(compute_total_area(), Catch::Matchers::WithinAbs(1 - 0.36 + 0.04, 1e-6));
+    }
+}
+
 TEST_CASE("Marker", "[trianglelite][marker]")
 {
     using namespace trianglelite;
@@ -177,6 +303,42 @@ TEST_CASE("Marker", "[trianglelite][marker]")
     }
 }
 
+TEST_CASE("Output flags", "[trianglelite][output]")
+{
+    using namespace trianglelite;
+
+    Config config;
+    Engine engine;
+    config.max_area = 0.1;
+    config.verbose_level = 0;
+
+    std::vector<Scalar> points{0, 0, 1, 0, 1, 1, 0, 1};
+    std::vector<Index> segments{0, 1, 1, 2, 2, 3, 3, 0};
+    engine.set_in_points(points.data(), static_cast<int>(points.size() / 2));
+    engine.set_in_segments(segments.data(), static_cast<int>(segments.size() / 2));
+
+    SECTION("Mesh only")
+    {
+        config.output_flags = OUTPUT_POINTS | OUTPUT_TRIANGLES;
+        engine.run(config);
+        REQUIRE(engine.get_out_points().rows() >= 4);
+        REQUIRE(engine.get_out_triangles().rows() >= 2);
+        REQUIRE(engine.get_out_edges().rows() == 0);
+        REQUIRE(engine.get_out_segments().rows() == 0);
+        REQUIRE(engine.get_out_triangle_neighbors().data() == nullptr);
+        REQUIRE(engine.get_out_point_markers().data() == nullptr);
+    }
+
+    SECTION("Edges without markers")
+    {
+        config.output_flags = OUTPUT_ALL & ~OUTPUT_MARKERS;
+        engine.run(config);
+        REQUIRE(engine.get_out_edges().rows() > 0);
+        REQUIRE(engine.get_out_edge_markers().data() == nullptr);
+        REQUIRE(engine.get_out_triangle_neighbors().data() != nullptr);
+    }
+}
+
 TEST_CASE("Debug Issue 1", "[trianglelite][issue][!mayfail]")
 {
     using namespace trianglelite;
@@ -248,3 +410,805 @@ TEST_CASE("Debug Issue 2", "[trianglelite][issue]")
         REQUIRE(out_triangles.rows() == 2);
     }
 }
+
+TEST_CASE("Reuse buffers", "[trianglelite][buffers]")
+{
+    using namespace trianglelite;
+
+    Config config;
+    config.max_area = 0.01;
+    config.verbose_level = 0;
+
+    std::vector<Scalar> points{
+        0, 0, 1, 0, 1, 1, 0, 1, 0.25, 0.25, 0.75, 0.25, 0.75, 0.75, 0.25, 0.75};
+    std::vector<Index> segments{0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6, 6, 7, 7, 4};
+
+    Engine reference;
+    reference.set_in_points(points.data(), static_cast<int>(points.size() / 2));
+    reference.set_in_segments(segments.data(), static_cast<int>(segments.size() / 2));
+
+    SECTION("Auto hole detection") { config.auto_hole_detection = true; }
+    SECTION("Refinement") { config.max_area = 0.005; }
+
+    reference.run(config);
+    const Eigen::Matrix<Index, Eigen::Dynamic, 3, Eigen::RowMajor> expected =
+        reference.get_out_triangles();
+
+    config.reuse_buffers = true;
+    Engine engine;
+    engine.set_in_points(points.data(), static_cast<int>(points.size() / 2));
+    engine.set_in_segments(segments.data(), static_cast<int>(segments.size() / 2));
+    for (int i = 0; i < 3; i++) {
+        engine.run(config);
+        REQUIRE(engine.get_out_triangles() == expected);
+        REQUIRE(engine.get_out_edges().rows() == reference.get_out_edges().rows());
+    }
+
+    // Switching reuse off releases the cached memory; results are unaffected.
+    config.reuse_buffers = false;
+    engine.run(config);
+    REQUIRE(engine.get_out_triangles() == expected);
+}
+
+TEST_CASE("Output sink", "[trianglelite][sink]")
+{
+    using namespace trianglelite;
+
+    Config config;
+    config.max_area = 0.01;
+    config.verbose_level = 0;
+
+    std::vector<Scalar> points{0, 0, 1, 0, 1, 1, 0, 1};
+    std::vector<Index> segments{0, 1, 1, 2, 2, 3, 3, 0};
+
+    Engine engine;
+    engine.set_in_points(points.data(), static_cast<int>(points.size() / 2));
+    engine.set_in_segments(segments.data(), static_cast<int>(segments.size() / 2));
+    engine.run(config);
+    const Eigen::Matrix<Scalar, Eigen::Dynamic, 2, Eigen::RowMajor> expected_points =
+        engine.get_out_points();
+    const Eigen::Matrix<Index, Eigen::Dynamic, 3, Eigen::RowMajor> expected_triangles =
+        engine.get_out_triangles();
+    const Index num_points = static_cast<Index>(expected_points.rows());
+    const Index num_triangles = static_cast<Index>(expected_triangles.rows());
+
+    SECTION("Fixed capacity")
+    {
+        std::vector<Scalar> out_points(num_points * 2 + 10);
+        std::vector<Index> out_triangles(num_triangles * 3 + 10);
+        FixedOutputSink sink(
+            out_points.data(), num_points + 5, out_triangles.data(), num_triangles + 5);
+        engine.run(config, sink);
+
+        REQUIRE(sink.get_num_points() == num_points);
+        REQUIRE(sink.get_num_triangles() == num_triangles);
+        REQUIRE(Matrix2FrMap(out_points.data(), num_points, 2) == expected_points);
+        REQUIRE(Matrix3IrMap(out_triangles.data(), num_triangles, 3) == expected_triangles);
+        REQUIRE(engine.get_out_points().rows() == 0);
+        REQUIRE(engine.get_out_triangles().rows() == 0);
+        REQUIRE(engine.get_out_edges().rows() > 0);
+    }
+
+    SECTION("Overflow")
+    {
+        std::vector<Scalar> out_points(num_points * 2);
+        std::vector<Index> out_triangles(3);
+        FixedOutputSink sink(out_points.data(), num_points, out_triangles.data(), 1);
+        REQUIRE_THROWS_AS(engine.run(config, sink), std::overflow_error);
+
+        // The output is still available from the engine.
+        REQUIRE(engine.get_out_points() == expected_points);
+        REQUIRE(engine.get_out_triangles() == expected_triangles);
+    }
+
+    SECTION("Append")
+    {
+        struct CopySink : public OutputSink
+        {
+            std::vector<Scalar> points;
+            std::vector<Index> triangles;
+            void append_points(const Scalar* data, Index n) override
+            {
+                points.assign(data, data + n * 2);
+            }
+            void append_triangles(const Index* data, Index n) override
+            {
+                triangles.assign(data, data + n * 3);
+            }
+        } sink;
+        engine.run(config, sink);
+
+        REQUIRE(sink.points.size() == static_cast<size_t>(num_points * 2));
+        REQUIRE(Matrix3IrMap(sink.triangles.data(), num_triangles, 3) == expected_triangles);
+        REQUIRE(engine.get_out_triangles() == expected_triangles);
+    }
+}
+
+TEST_CASE("Output owner", "[trianglelite][output]")
+{
+    using namespace trianglelite;
+
+    Config config;
+    config.max_area = 0.01;
+    config.verbose_level = 0;
+
+    std::vector<Scalar> points{0, 0, 1, 0, 1, 1, 0, 1};
+    std::vector<Index> segments{0, 1, 1, 2, 2, 3, 3, 0};
+
+    std::shared_ptr<const void> owner;
+    Eigen::Matrix<Index, Eigen::Dynamic, 3, Eigen::RowMajor> expected;
+    const Index* triangles = nullptr;
+    Index num_triangles = 0;
+    {
+        Engine engine;
+        engine.set_in_points(points.data(), static_cast<int>(points.size() / 2));
+        engine.set_in_segments(segments.data(), static_cast<int>(segments.size() / 2));
+        engine.run(config);
+
+        owner = engine.get_out_owner();
+        expected = engine.get_out_triangles();
+        triangles = engine.get_out_triangles().data();
+        num_triangles = static_cast<Index>(expected.rows());
+
+        // Running again does not touch the shared output.
+        config.max_area = 0.1;
+        engine.run(config);
+        REQUIRE(engine.get_out_triangles().data() != triangles);
+        REQUIRE(engine.get_out_triangles().rows() < num_triangles);
+        REQUIRE(Matrix3IrMap(const_cast<Index*>(triangles), num_triangles, 3) == expected);
+    }
+
+    // Nor does destroying the engine.
+    REQUIRE(Matrix3IrMap(const_cast<Index*>(triangles), num_triangles, 3) == expected);
+    owner.reset();
+}
+
+TEST_CASE("Parallel Delaunay", "[trianglelite][parallel]")
+{
+    using namespace trianglelite;
+
+    // Large enough to be split into 4 strips.
+    const Index n = 40000;
+    std::vector<Scalar> points(n * 2);
+    bool is_unique = true;
+    SECTION("Random")
+    {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<Scalar> dist(0, 1);
+        for (auto& x : points) x = dist(gen);
+    }
+    SECTION("Grid")
+    {
+        // Cocircular points everywhere, the triangulation is not unique.  The merge may fail its
+        // sanity checks, in which case the serial algorithm is used.
+        is_unique = false;
+        for (Index i = 0; i < n; i++) {
+            points[i * 2] = static_cast<Scalar>(i % 200);
+            points[i * 2 + 1] = static_cast<Scalar>(i / 200);
+        }
+    }
+
+    Config config;
+    config.min_angle = 0;
+    config.verbose_level = 0;
+
+    auto canonical_triangles = [](const Engine& engine) {
+        const auto triangles = engine.get_out_triangles();
+        std::vector<std::array<Index, 3>> result;
+        for (Index i = 0; i < triangles.rows(); i++) {
+            std::array<Index, 3> t{triangles(i, 0), triangles(i, 1), triangles(i, 2)};
+            std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+            result.push_back(t);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+    auto total_area = [&](const Engine& engine) {
+        const auto triangles = engine.get_out_triangles();
+        double area = 0;
+        for (Index i = 0; i < triangles.rows(); i++) {
+            const Scalar* p0 = points.data() + triangles(i, 0) * 2;
+            const Scalar* p1 = points.data() + triangles(i, 1) * 2;
+            const Scalar* p2 = points.data() + triangles(i, 2) * 2;
+            const double a =
+                (p1[0] - p0[0]) * (p2[1] - p0[1]) - (p1[1] - p0[1]) * (p2[0] - p0[0]);
+            REQUIRE(a > 0);
+            area += a / 2;
+        }
+        return area;
+    };
+
+    Engine serial;
+    serial.set_in_points(points.data(), n);
+    serial.run(config);
+    REQUIRE(serial.get_run_stats().num_subdomains == 0);
+
+    config.algorithm = Algorithm::PARALLEL_DIVIDE_AND_CONQUER;
+    config.num_threads = 4;
+    Engine engine;
+    engine.set_in_points(points.data(), n);
+    engine.run(config);
+    const Index num_strips = engine.get_run_stats().num_subdomains;
+    if (is_unique) {
+        REQUIRE(num_strips == 4);
+    } else {
+        REQUIRE((num_strips == 0 || num_strips == 4));
+    }
+
+    REQUIRE(engine.get_out_points() == serial.get_out_points());
+    REQUIRE(engine.get_out_triangles().rows() == serial.get_out_triangles().rows());
+    REQUIRE_THAT(total_area(engine), Catch::Matchers::WithinRel(total_area(serial), 1e-9));
+    if (is_unique) {
+        REQUIRE(canonical_triangles(engine) == canonical_triangles(serial));
+    }
+
+    // Other outputs and refinement are computed by triangle from the parallel triangulation.
+    config.min_angle = 20;
+    engine.run(config);
+    REQUIRE(engine.get_run_stats().num_subdomains == num_strips);
+    REQUIRE(engine.get_out_points().rows() >= n);
+    REQUIRE(engine.get_out_triangle_neighbors().rows() == engine.get_out_triangles().rows());
+
+    // Segments are not supported by the strips, the serial algorithm is used instead.
+    const Index segments[] = {0, 1};
+    engine.set_in_segments(segments, 1);
+    engine.run(config);
+    REQUIRE(engine.get_run_stats().num_subdomains == 0);
+    REQUIRE(engine.get_out_points().rows() >= n);
+}
+
+TEST_CASE("Parallel refinement", "[trianglelite][parallel]")
+{
+    using namespace trianglelite;
+
+    Config config;
+    config.min_angle = 20;
+    config.max_area = 1e-4;
+    config.verbose_level = 0;
+    config.auto_hole_detection = true;
+    config.parallel_refinement = true;
+    config.num_threads = 4;
+
+    SECTION("Split boundary") {}
+    SECTION("Keep boundary") { config.split_boundary = false; }
+
+    Eigen::Matrix<Scalar, 8, 2, Eigen::RowMajor> points;
+    points << 0.0, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0, 1.0, 0.2, 0.2, 0.2, 0.8, 0.8, 0.8, 0.8, 0.2;
+    Eigen::Matrix<int, 8, 2, Eigen::RowMajor> segments;
+    segments << 0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6, 6, 7, 7, 4;
+
+    Engine engine;
+    engine.set_in_points(points.data(), static_cast<int>(points.rows()));
+    engine.set_in_segments(segments.data(), static_cast<int>(segments.rows()));
+    engine.run(config);
+
+    auto out_points = engine.get_out_points();
+    auto out_edges = engine.get_out_edges();
+    auto out_triangles = engine.get_out_triangles();
+    auto out_segments = engine.get_out_segments();
+
+    // A single conforming mesh of the quad with a hole.
+    const int euler = static_cast<int>(out_points.rows()) - static_cast<int>(out_edges.rows()) +
+                      static_cast<int>(out_triangles.rows());
+    REQUIRE(euler == 0);
+    if (!config.split_boundary) {
+        REQUIRE(out_segments.rows() == segments.rows());
+    }
+
+    double total_area = 0;
+    double min_angle = 180;
+    for (Index i = 0; i < out_triangles.rows(); i++) {
+        Eigen::Matrix<double, 3, 2> v;
+        for (Index j = 0; j < 3; j++) v.row(j) = out_points.row(out_triangles(i, j)).cast<double>();
+        const Eigen::RowVector2d e0 = v.row(1) - v.row(0);
+        const Eigen::RowVector2d e1 = v.row(2) - v.row(0);
+        const double area = (e0[0] * e1[1] - e0[1] * e1[0]) / 2;
+        REQUIRE(area > 0);
+        REQUIRE(area <= config.max_area * (1 + 1e-6));
+        total_area += area;
+        for (Index j = 0; j < 3; j++) {
+            const Eigen::RowVector2d a = v.row((j + 1) % 3) - v.row(j);
+            const Eigen::RowVector2d b = v.row((j + 2) % 3) - v.row(j);
+            const double angle = std::acos(a.normalized().dot(b.normalized()));
+            min_angle = std::min(min_angle, angle * 180 / std::acos(-1.0));
+        }
+    }
+    REQUIRE_THAT(total_area, Catch::Matchers::WithinRel(0.64, 1e-9));
+    REQUIRE(min_angle >= config.min_angle - 1e-3);
+    REQUIRE(engine.get_run_stats().num_subdomains == config.num_threads);
+}
+
+TEST_CASE("Parallel refinement of clustered points", "[trianglelite][parallel]")
+{
+    using namespace trianglelite;
+
+    Config config;
+    config.min_angle = 20;
+    config.max_area = 1e-3;
+    config.verbose_level = 0;
+    config.parallel_refinement = true;
+    config.num_threads = 4;
+
+    // Enough points for a fine constrained triangulation, all in a corner of the unit square, so
+    // that a few coarse triangles hold most of the area.
+    std::vector<Scalar> points{0, 0, 1, 0, 1, 1, 0, 1};
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<Scalar> dist(0.001, 0.01);
+    for (Index i = 0; i < 1000; i++) {
+        points.push_back(dist(gen));
+        points.push_back(dist(gen));
+    }
+    const std::vector<Index> segments{0, 1, 1, 2, 2, 3, 3, 0};
+
+    Engine engine;
+    engine.set_in_points(points.data(), static_cast<Index>(points.size() / 2));
+    engine.set_in_segments(segments.data(), 4);
+    engine.run(config);
+    REQUIRE(engine.get_run_stats().num_subdomains == config.num_threads);
+
+    const auto out_points = engine.get_out_points();
+    const auto out_triangles = engine.get_out_triangles();
+    const auto out_edges = engine.get_out_edges();
+    const int euler = static_cast<int>(out_points.rows()) - static_cast<int>(out_edges.rows()) +
+                      static_cast<int>(out_triangles.rows());
+    REQUIRE(euler == 1);
+
+    double total_area = 0;
+    for (Index i = 0; i < out_triangles.rows(); i++) {
+        const Eigen::RowVector2d p0 = out_points.row(out_triangles(i, 0)).cast<double>();
+        const Eigen::RowVector2d e0 = out_points.row(out_triangles(i, 1)).cast<double>() - p0;
+        const Eigen::RowVector2d e1 = out_points.row(out_triangles(i, 2)).cast<double>() - p0;
+        const double area = (e0[0] * e1[1] - e0[1] * e1[0]) / 2;
+        REQUIRE(area > 0);
+        REQUIRE(area <= config.max_area * (1 + 1e-6));
+        total_area += area;
+    }
+    REQUIRE_THAT(total_area, Catch::Matchers::WithinRel(1.0, 1e-9));
+}
+
+TEST_CASE("Spatial sort", "[trianglelite][sort]")
+{
+    using namespace trianglelite;
+
+    Config config;
+    config.min_angle = 0;
+    config.verbose_level = 0;
+
+    SECTION("Point cloud")
+    {
+        const Index n = 5000;
+        std::vector<Scalar> points(n * 2);
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<Scalar> dist(0, 1);
+        for (auto& x : points) x = dist(gen);
+
+        // Triangles as sorted triplets of point coordinates, independent of numbering.
+        auto geometric_triangles = [](const Engine& engine) {
+            const auto out_points = engine.get_out_points();
+            const auto triangles = engine.get_out_triangles();
+            std::vector<std::array<std::pair<Scalar, Scalar>, 3>> result;
+            for (Index i = 0; i < triangles.rows(); i++) {
+                std::array<std::pair<Scalar, Scalar>, 3> t;
+                for (Index j = 0; j < 3; j++) {
+                    t[j] = {out_points(triangles(i, j), 0), out_points(triangles(i, j), 1)};
+                }
+                std::sort(t.begin(), t.end());
+                result.push_back(t);
+            }
+            std::sort(result.begin(), result.end());
+            return result;
+        };
+
+        Engine unsorted;
+        unsorted.set_in_points(points.data(), n);
+        unsorted.run(config);
+
+        config.spatial_sort = true;
+        Engine engine;
+        engine.set_in_points(points.data(), n);
+        engine.run(config);
+
+        // Same triangulation, numbered as the input.
+        REQUIRE(engine.get_out_points() == unsorted.get_out_points());
+        REQUIRE(geometric_triangles(engine) == geometric_triangles(unsorted));
+
+        config.keep_spatial_order = true;
+        engine.run(config);
+        REQUIRE(geometric_triangles(engine) == geometric_triangles(unsorted));
+
+        // Neighbors follow the triangles.
+        const auto triangles = engine.get_out_triangles();
+        const auto neighbors = engine.get_out_triangle_neighbors();
+        REQUIRE(neighbors.rows() == triangles.rows());
+        for (Index i = 0; i < neighbors.rows(); i++) {
+            for (Index j = 0; j < 3; j++) {
+                const Index k = neighbors(i, j);
+                if (k < 0) continue;
+                const auto row = neighbors.row(k);
+                REQUIRE(std::find(row.data(), row.data() + 3, i) != row.data() + 3);
+            }
+        }
+
+        // Consecutive points are much closer than in the random input.
+        const auto out_points = engine.get_out_points();
+        double sorted_length = 0, unsorted_length = 0;
+        for (Index i = 1; i < n; i++) {
+            sorted_length += (out_points.row(i) - out_points.row(i - 1)).norm();
+            unsorted_length += (unsorted.get_out_points().row(i) -
+                                   unsorted.get_out_points().row(i - 1))
+                                   .norm();
+        }
+        REQUIRE(sorted_length * 10 < unsorted_length);
+    }
+
+    SECTION("PSLG")
+    {
+        Eigen::Matrix<Scalar, 8, 2, Eigen::RowMajor> points;
+        points << 0.0, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0, 1.0, 0.2, 0.2, 0.2, 0.8, 0.8, 0.8, 0.8, 0.2;
+        Eigen::Matrix<int, 8, 2, Eigen::RowMajor> segments;
+        segments << 0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6, 6, 7, 7, 4;
+        std::vector<int> segment_markers{1, 2, 3, 4, 5, 6, 7, 8};
+
+        config.min_angle = 20;
+        config.max_area = 1e-3;
+        config.auto_hole_detection = true;
+        config.spatial_sort = true;
+
+        Engine engine;
+        engine.set_in_points(points.data(), static_cast<int>(points.rows()));
+        engine.set_in_segments(segments.data(), static_cast<int>(segments.rows()));
+        engine.set_in_segment_markers(segment_markers.data(), 8);
+        engine.run(config);
+
+        auto out_points = engine.get_out_points();
+        auto out_segments = engine.get_out_segments();
+        auto out_segment_markers = engine.get_out_segment_markers();
+        REQUIRE(out_points.topRows(8) == points);
+
+        // Output segments lie on the input segment given by their marker.
+        for (Index i = 0; i < out_segments.rows(); i++) {
+            const int s = out_segment_markers[i] - 1;
+            REQUIRE(s >= 0);
+            REQUIRE(s < 8);
+            const auto a = points.row(segments(s, 0));
+            const auto d = points.row(segments(s, 1)) - a;
+            for (Index j = 0; j < 2; j++) {
+                const auto e = out_points.row(out_segments(i, j)) - a;
+                REQUIRE(std::abs(d[0] * e[1] - d[1] * e[0]) < 1e-6);
+            }
+        }
+    }
+}
+
+TEST_CASE("Output order", "[trianglelite][order]")
+{
+    using namespace trianglelite;
+
+    Config config;
+    config.min_angle = 20;
+    config.max_area = 1e-3;
+    config.verbose_level = 0;
+    config.auto_hole_detection = true;
+    config.voronoi = true;
+
+    Eigen::Matrix<Scalar, 8, 2, Eigen::RowMajor> points;
+    points << 0.0, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0, 1.0, 0.2, 0.2, 0.2, 0.8, 0.8, 0.8, 0.8, 0.2;
+    Eigen::Matrix<int, 8, 2, Eigen::RowMajor> segments;
+    segments << 0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6, 6, 7, 7, 4;
+    std::vector<int> point_markers{1, 2, 3, 4, 5, 6, 7, 8};
+    std::vector<int> segment_markers{1, 2, 3, 4, 5, 6, 7, 8};
+
+    Engine engine;
+    engine.set_in_points(points.data(), static_cast<int>(points.rows()));
+    engine.set_in_segments(segments.data(), static_cast<int>(segments.rows()));
+    engine.set_in_point_markers(point_markers.data(), 8);
+    engine.set_in_segment_markers(segment_markers.data(), 8);
+
+    // Output points with their markers, and triangles as sorted triplets of point coordinates,
+    // independent of numbering.
+    using Point = std::pair<Scalar, Scalar>;
+    auto marked_points = [](const Engine& engine) {
+        const auto out_points = engine.get_out_points();
+        const auto markers = engine.get_out_point_markers();
+        std::vector<std::pair<Point, int>> result;
+        for (Index i = 0; i < out_points.rows(); i++) {
+            result.push_back({{out_points(i, 0), out_points(i, 1)}, markers[i]});
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+    auto geometric_triangles = [](const Engine& engine) {
+        const auto out_points = engine.get_out_points();
+        const auto triangles = engine.get_out_triangles();
+        std::vector<std::array<Point, 3>> result;
+        for (Index i = 0; i < triangles.rows(); i++) {
+            std::array<Point, 3> t;
+            for (Index j = 0; j < 3; j++) {
+                t[j] = {out_points(triangles(i, j), 0), out_points(triangles(i, j), 1)};
+            }
+            std::sort(t.begin(), t.end());
+            result.push_back(t);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    engine.run(config);
+    const auto expected_points = marked_points(engine);
+    const auto expected_triangles = geometric_triangles(engine);
+    const auto num_segments = engine.get_out_segments().rows();
+    const auto num_edges = engine.get_out_edges().rows();
+
+    SECTION("Hilbert") { config.output_order = OutputOrder::HILBERT; }
+    SECTION("Reverse Cuthill-McKee") { config.output_order = OutputOrder::REVERSE_CUTHILL_MCKEE; }
+    SECTION("Strip") { config.output_order = OutputOrder::STRIP; }
+    engine.run(config);
+
+    // Same mesh, renumbered.
+    REQUIRE(marked_points(engine) == expected_points);
+    REQUIRE(geometric_triangles(engine) == expected_triangles);
+    REQUIRE(engine.get_out_segments().rows() == num_segments);
+    REQUIRE(engine.get_out_edges().rows() == num_edges);
+
+    // Output segments lie on the input segment given by their marker.
+    const auto out_points = engine.get_out_points();
+    const auto out_segments = engine.get_out_segments();
+    const auto out_segment_markers = engine.get_out_segment_markers();
+    for (Index i = 0; i < out_segments.rows(); i++) {
+        const int s = out_segment_markers[i] - 1;
+        REQUIRE(s >= 0);
+        REQUIRE(s < 8);
+        const auto a = points.row(segments(s, 0));
+        const auto d = points.row(segments(s, 1)) - a;
+        for (Index j = 0; j < 2; j++) {
+            const auto e = out_points.row(out_segments(i, j)) - a;
+            REQUIRE(std::abs(d[0] * e[1] - d[1] * e[0]) < 1e-6);
+        }
+    }
+
+    // Neighbors share an edge, and Voronoi vertices are the circumcenters of their triangle.
+    const auto triangles = engine.get_out_triangles();
+    const auto neighbors = engine.get_out_triangle_neighbors();
+    const auto voronoi_points = engine.get_voronoi_points();
+    REQUIRE(voronoi_points.rows() == triangles.rows());
+    for (Index i = 0; i < triangles.rows(); i++) {
+        for (Index j = 0; j < 3; j++) {
+            const Index k = neighbors(i, j);
+            if (k < 0) continue;
+            Index num_shared = 0;
+            for (Index l = 0; l < 3; l++) {
+                const auto row = triangles.row(k);
+                num_shared += std::count(row.data(), row.data() + 3, triangles(i, l));
+            }
+            REQUIRE(num_shared == 2);
+        }
+        const auto c = voronoi_points.row(i);
+        const double r0 = (out_points.row(triangles(i, 0)) - c).norm();
+        for (Index j = 1; j < 3; j++) {
+            REQUIRE_THAT((out_points.row(triangles(i, j)) - c).norm(),
+                Catch::Matchers::WithinRel(r0, 1e-6));
+        }
+    }
+}
+
+TEST_CASE("Incremental updates", "[trianglelite][incremental]")
+{
+    using namespace trianglelite;
+
+    Config config;
+    config.min_angle = 0;
+    config.verbose_level = 0;
+
+    auto canonical_triangles = [](const Engine& engine) {
+        const auto triangles = engine.get_out_triangles();
+        std::vector<std::array<Index, 3>> result;
+        for (Index i = 0; i < triangles.rows(); i++) {
+            std::array<Index, 3> t{triangles(i, 0), triangles(i, 1), triangles(i, 2)};
+            std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+            result.push_back(t);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    SECTION("Point cloud")
+    {
+        const Index n = 2000, m = 200;
+        std::vector<Scalar> points((n + m) * 2);
+        std::mt19937 gen(11);
+        std::uniform_real_distribution<Scalar> dist(0, 1);
+        for (Index i = 0; i < n + m; i++) {
+            // Corners first, so that the other points are inside the initial convex hull.
+            points[i * 2] = i < 4 ? Scalar(i % 2) : dist(gen);
+            points[i * 2 + 1] = i < 4 ? Scalar(i / 2) : dist(gen);
+        }
+
+        Engine full;
+        full.set_in_points(points.data(), n + m);
+        full.run(config);
+
+        Engine engine;
+        engine.set_in_points(points.data(), n);
+        engine.run(config);
+        const auto initial_triangles = canonical_triangles(engine);
+        const auto owner = engine.get_out_owner();
+        const auto initial_view = engine.get_out_triangles();
+
+        // Same Delaunay triangulation as a full run.
+        engine.insert_points(points.data() + n * 2, m);
+        REQUIRE(engine.get_out_points() == full.get_out_points());
+        REQUIRE(canonical_triangles(engine) == canonical_triangles(full));
+        REQUIRE(engine.get_out_triangle_neighbors().rows() == engine.get_out_triangles().rows());
+
+        // Outputs in use are left untouched.
+        REQUIRE(initial_view.rows() < engine.get_out_triangles().rows());
+
+        for (Index i = n + m - 1; i >= n; i--) engine.remove_point(i);
+        REQUIRE(engine.get_out_points().rows() == n);
+        REQUIRE(canonical_triangles(engine) == initial_triangles);
+    }
+
+    SECTION("PSLG")
+    {
+        Eigen::Matrix<Scalar, 8, 2, Eigen::RowMajor> points;
+        points << 0.0, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0, 1.0, 0.2, 0.2, 0.2, 0.8, 0.8, 0.8, 0.8, 0.2;
+        Eigen::Matrix<int, 8, 2, Eigen::RowMajor> segments;
+        segments << 0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6, 6, 7, 7, 4;
+        std::vector<int> segment_markers{1, 2, 3, 4, 5, 6, 7, 8};
+
+        config.min_angle = 20;
+        config.auto_hole_detection = true;
+
+        Engine engine;
+        engine.set_in_points(points.data(), static_cast<int>(points.rows()));
+        engine.set_in_segments(segments.data(), static_cast<int>(segments.rows()));
+        engine.set_in_segment_markers(segment_markers.data(), 8);
+        engine.run(config);
+        const Index num_points = static_cast<Index>(engine.get_out_points().rows());
+        const Index num_segments = static_cast<Index>(engine.get_out_segments().rows());
+
+        // One point on the bottom segment, and a few inside of the domain.
+        const std::vector<Scalar> new_points{0.37, 0, 0.1, 0.1, 0.9, 0.5, 0.5, 0.9, 0.15, 0.6};
+        engine.insert_points(new_points.data(), 5);
+        REQUIRE(engine.get_out_points().rows() == num_points + 5);
+        REQUIRE(engine.get_out_segments().rows() == num_segments + 1);
+        REQUIRE(engine.get_out_point_markers()[num_points] == 1);
+        REQUIRE(engine.get_out_edges().rows() == 0);
+
+        const Scalar outside[] = {0.5, 0.5};
+        REQUIRE_THROWS(engine.insert_points(outside, 1));
+        REQUIRE_THROWS(engine.remove_point(0));
+        REQUIRE_THROWS(engine.remove_point(num_points));
+        engine.remove_point(num_points + 1);
+
+        const auto out_points = engine.get_out_points();
+        const auto triangles = engine.get_out_triangles();
+        const auto neighbors = engine.get_out_triangle_neighbors();
+        double total_area = 0;
+        for (Index i = 0; i < triangles.rows(); i++) {
+            const auto e0 = out_points.row(triangles(i, 1)) - out_points.row(triangles(i, 0));
+            const auto e1 = out_points.row(triangles(i, 2)) - out_points.row(triangles(i, 0));
+            const double area = (double(e0[0]) * e1[1] - double(e0[1]) * e1[0]) / 2;
+            REQUIRE(area > 0);
+            total_area += area;
+            for (Index j = 0; j < 3; j++) {
+                const Index k = neighbors(i, j);
+                if (k < 0) continue;
+                const auto row = neighbors.row(k);
+                REQUIRE(std::count(row.data(), row.data() + 3, i) == 1);
+            }
+        }
+        REQUIRE_THAT(total_area, Catch::Matchers::WithinRel(0.64, 1e-9));
+    }
+}
+
+TEST_CASE("Local refinement", "[trianglelite][incremental]")
+{
+    using namespace trianglelite;
+
+    Eigen::Matrix<Scalar, 4, 2, Eigen::RowMajor> points;
+    points << 0.0, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0, 1.0;
+    Eigen::Matrix<int, 5, 2, Eigen::RowMajor> segments;
+    segments << 0, 1, 1, 2, 2, 3, 3, 0, 0, 2;
+
+    Config config;
+    config.verbose_level = 0;
+    config.max_area = 0.01;
+
+    Engine engine;
+    engine.set_in_points(points.data(), 4);
+    engine.set_in_segments(segments.data(), 5);
+    engine.run(config);
+    const Matrix3Ir initial_triangles = engine.get_out_triangles();
+    const Matrix2Fr initial_points = engine.get_out_points();
+    const Index num_points = static_cast<Index>(engine.get_out_points().rows());
+    const Index num_segments = static_cast<Index>(engine.get_out_segments().rows());
+
+    // Refine a window across the diagonal segment.
+    const Scalar window[] = {0.25, 0.25, 0.5, 0.25, 0.5, 0.5, 0.25, 0.5};
+    config.max_area = 1e-4;
+    const RefinementDelta delta = engine.refine_polygon(window, 4, config);
+    REQUIRE(!delta.removed_triangles.empty());
+    REQUIRE(delta.added_triangles.size() > delta.removed_triangles.size());
+    REQUIRE(engine.get_out_points().rows() == num_points + Index(delta.added_points.size()));
+    REQUIRE(engine.get_out_segments().rows() > num_segments);
+
+    // The rest of the mesh is untouched.
+    const auto triangles = engine.get_out_triangles();
+    const std::set<Index> removed(delta.removed_triangles.begin(), delta.removed_triangles.end());
+    for (Index i = 0; i < initial_triangles.rows(); i++) {
+        if (removed.count(i) == 0) REQUIRE(triangles.row(i) == initial_triangles.row(i));
+    }
+
+    const auto out_points = engine.get_out_points();
+    const auto neighbors = engine.get_out_triangle_neighbors();
+    auto area = [&](Index i) {
+        const auto e0 = out_points.row(triangles(i, 1)) - out_points.row(triangles(i, 0));
+        const auto e1 = out_points.row(triangles(i, 2)) - out_points.row(triangles(i, 0));
+        return (double(e0[0]) * e1[1] - double(e0[1]) * e1[0]) / 2;
+    };
+    double total_area = 0;
+    for (Index i = 0; i < triangles.rows(); i++) {
+        REQUIRE(area(i) > 0);
+        total_area += area(i);
+        for (Index j = 0; j < 3; j++) {
+            const Index k = neighbors(i, j);
+            if (k < 0) continue;
+            const auto row = neighbors.row(k);
+            REQUIRE(std::count(row.data(), row.data() + 3, i) == 1);
+        }
+    }
+    REQUIRE_THAT(total_area, Catch::Matchers::WithinRel(1.0, 1e-9));
+    REQUIRE(out_points.topRows(num_points) == initial_points);
+
+    const Index invalid = static_cast<Index>(triangles.rows());
+    REQUIRE_THROWS(engine.refine_triangles(&invalid, 1, config));
+}
+
+TEST_CASE("Run statistics", "[trianglelite][stats]")
+{
+    using namespace trianglelite;
+
+    Eigen::Matrix<Scalar, 8, 2, Eigen::RowMajor> points;
+    points << 0.0, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0, 1.0, 0.2, 0.2, 0.2, 0.8, 0.8, 0.8, 0.8, 0.2;
+    Eigen::Matrix<int, 8, 2, Eigen::RowMajor> segments;
+    segments << 0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6, 6, 7, 7, 4;
+
+    Engine engine;
+    engine.set_in_points(points.data(), static_cast<int>(points.rows()));
+    engine.set_in_segments(segments.data(), static_cast<int>(segments.rows()));
+    Config config;
+    config.verbose_level = 0;
+    config.max_area = 0.01;
+    engine.run(config);
+
+    const RunStats stats = engine.get_run_stats();
+    REQUIRE(stats.num_triangle_runs == 1);
+    REQUIRE(stats.num_orient2d > 0);
+    REQUIRE(stats.num_incircle > 0);
+    REQUIRE(stats.num_exact_orient2d <= stats.num_orient2d);
+    REQUIRE(stats.num_exact_incircle <= stats.num_incircle);
+    REQUIRE(stats.num_steiner_points == engine.get_out_points().rows() - points.rows());
+    REQUIRE(stats.num_steiner_points > 0);
+    REQUIRE(stats.peak_memory > 0);
+    const double phases = stats.input_time + stats.delaunay_time + stats.segment_time +
+                          stats.hole_time + stats.quality_time + stats.output_time;
+    REQUIRE(phases <= stats.total_time);
+    REQUIRE(stats.auto_hole_triangulation_time == 0);
+
+    // The triangulation of auto hole detection is part of the run.
+    config.auto_hole_detection = true;
+    config.auto_hole_reuse_mesh = false;
+    engine.run(config);
+    REQUIRE(engine.get_run_stats().num_triangle_runs == 2);
+    REQUIRE(engine.get_run_stats().auto_hole_triangulation_time > 0);
+    REQUIRE(engine.get_run_stats().num_incircle > stats.num_incircle);
+
+    // Points on a line are decided by exact arithmetic.
+    Eigen::Matrix<Scalar, 4, 2, Eigen::RowMajor> line;
+    line << 0.0, 0.0, 0.1, 0.1, 0.3, 0.3, 1.0, 0.0;
+    Engine collinear;
+    collinear.set_in_points(line.data(), 4);
+    collinear.run(Config());
+    REQUIRE(collinear.get_run_stats().num_exact_orient2d > 0);
+}
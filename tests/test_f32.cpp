@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <trianglelite/f32/trianglelite.h>
+#include <trianglelite/trianglelite.h>
+
+#include <Eigen/Core>
+#include <cmath>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+/**
+ * Refine the two triangles of the unit square with `Engine`, in either precision, and return the
+ * total area of the output.
+ */
+template <typename Engine, typename Config, typename Scalar>
+double refine_square(Engine& engine, Config config, Scalar max_area)
+{
+    const std::vector<Scalar> points{0, 0, 1, 0, 1, 1, 0, 1};
+    const std::vector<int> triangles{0, 1, 2, 0, 2, 3};
+    config.max_area = max_area;
+    config.verbose_level = 0;
+    engine.set_in_points(points.data(), 4);
+    engine.set_in_triangles(triangles.data(), 2);
+    engine.run(config);
+
+    auto out_points = engine.get_out_points();
+    auto out_triangles = engine.get_out_triangles();
+    double total_area = 0;
+    for (int i = 0; i < out_triangles.rows(); i++) {
+        const auto p0 = out_points.row(out_triangles(i, 0)).template cast<double>();
+        const auto p1 = out_points.row(out_triangles(i, 1)).template cast<double>();
+        const auto p2 = out_points.row(out_triangles(i, 2)).template cast<double>();
+        total_area += 0.5 * ((p1[0] - p0[0]) * (p2[1] - p0[1]) - (p1[1] - p0[1]) * (p2[0] - p0[0]));
+    }
+    return total_area;
+}
+
+} // namespace
+
+TEST_CASE("Single precision copy", "[trianglelite][f32]")
+{
+    static_assert(std::is_same<trianglelite::Scalar, double>::value, "");
+    static_assert(std::is_same<trianglelite::f32::Scalar, float>::value, "");
+    static_assert(
+        std::is_same<trianglelite::f32::Matrix2FrMap::Scalar, float>::value,
+        "f32 output maps must hold floats");
+
+    trianglelite::Engine engine;
+    trianglelite::f32::Engine engine_f32;
+
+    SECTION("Same mesh")
+    {
+        const double area = refine_square(engine, trianglelite::Config(), 0.01);
+        const double area_f32 = refine_square(engine_f32, trianglelite::f32::Config(), 0.01f);
+        REQUIRE(engine_f32.get_out_triangles().rows() == engine.get_out_triangles().rows());
+        REQUIRE(engine_f32.get_out_points().rows() == engine.get_out_points().rows());
+        REQUIRE(std::abs(area - 1) < 1e-12);
+        REQUIRE(std::abs(area_f32 - 1) < 1e-5);
+
+        auto out_points = engine.get_out_points();
+        auto out_points_f32 = engine_f32.get_out_points();
+        for (int i = 0; i < out_points.rows(); i++) {
+            REQUIRE((out_points.row(i).cast<float>() - out_points_f32.row(i)).norm() < 1e-5f);
+        }
+    }
+
+    SECTION("Concurrent runs")
+    {
+        // Each copy of Triangle keeps its own thread-local state and allocation hooks.
+        double area = 0;
+        double area_f32 = 0;
+        std::thread worker([&]() { area = refine_square(engine, trianglelite::Config(), 0.001); });
+        area_f32 = refine_square(engine_f32, trianglelite::f32::Config(), 0.001f);
+        worker.join();
+        REQUIRE(std::abs(area - 1) < 1e-12);
+        REQUIRE(std::abs(area_f32 - 1) < 1e-5);
+    }
+}
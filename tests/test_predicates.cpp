@@ -0,0 +1,102 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "predicates.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace trianglelite;
+
+// Query counts around the batch block size (256 points).
+const std::vector<Index> batch_sizes = {0, 1, 7, 255, 256, 257, 1000};
+
+/**
+ * Check that the batch predicates agree with one call per point on the first `n` points of
+ * `points`, for the triangle (a, b, c).
+ */
+void check_batches(
+    const Scalar* a, const Scalar* b, const Scalar* c, const std::vector<Scalar>& points, Index n)
+{
+    std::vector<int> signs(n + 1, 2);
+    predicates::orient2d_batch(a, b, points.data(), n, signs.data());
+    for (Index i = 0; i < n; i++) {
+        REQUIRE(signs[i] == predicates::orient2d(a, b, points.data() + i * 2));
+    }
+    REQUIRE(signs[n] == 2);
+
+    predicates::incircle_batch(a, b, c, points.data(), n, signs.data());
+    for (Index i = 0; i < n; i++) {
+        REQUIRE(signs[i] == predicates::incircle(a, b, c, points.data() + i * 2));
+    }
+    REQUIRE(signs[n] == 2);
+}
+
+} // namespace
+
+TEST_CASE("Batch predicates", "[trianglelite][predicates]")
+{
+    const Index max_size = batch_sizes.back();
+    std::vector<Scalar> points(max_size * 2);
+    std::mt19937 gen(42);
+
+    SECTION("Random")
+    {
+        std::uniform_real_distribution<double> dist(-1, 1);
+        for (auto& x : points) x = static_cast<Scalar>(dist(gen));
+        const Scalar a[] = {Scalar(-0.5), Scalar(-0.3)};
+        const Scalar b[] = {Scalar(0.6), Scalar(-0.2)};
+        const Scalar c[] = {Scalar(0.1), Scalar(0.7)};
+        for (Index n : batch_sizes) check_batches(a, b, c, points, n);
+    }
+
+    SECTION("Collinear")
+    {
+        // Points on the line through a and b, some of them nudged off it by one ulp, so that both
+        // certified and exact evaluations occur within a block.
+        const Scalar a[] = {Scalar(0.1), Scalar(0.1)};
+        const Scalar b[] = {Scalar(0.7), Scalar(0.7)};
+        const Scalar c[] = {Scalar(0.3), Scalar(0.9)};
+        std::uniform_real_distribution<double> dist(-10, 10);
+        for (Index i = 0; i < max_size; i++) {
+            const Scalar t = static_cast<Scalar>(dist(gen));
+            points[i * 2] = t;
+            points[i * 2 + 1] = i % 3 == 0 ? std::nextafter(t, Scalar(100)) : t;
+        }
+        for (Index n : batch_sizes) check_batches(a, b, c, points, n);
+
+        std::vector<int> signs(max_size);
+        predicates::orient2d_batch(a, b, points.data(), max_size, signs.data());
+        for (Index i = 0; i < max_size; i++) {
+            if (i % 3 != 0) REQUIRE(signs[i] == 0);
+        }
+    }
+
+    SECTION("Cocircular")
+    {
+        // Integer points on the circle of radius 25, possibly moved by one ulp.
+        const std::vector<Scalar> circle = {
+            25, 0, 24, 7, 20, 15, 15, 20, 7, 24, 0, 25, -7, 24, -15, 20, -20, 15, -24, 7, -25, 0,
+            -24, -7, -20, -15, -15, -20, -7, -24, 0, -25, 7, -24, 15, -20, 20, -15, 24, -7};
+        const Index num_circle = static_cast<Index>(circle.size() / 2);
+        const Scalar a[] = {25, 0};
+        const Scalar b[] = {0, 25};
+        const Scalar c[] = {-25, 0};
+        for (Index i = 0; i < max_size; i++) {
+            const Index k = i % num_circle;
+            points[i * 2] = circle[k * 2];
+            points[i * 2 + 1] = circle[k * 2 + 1];
+            if (i % 5 == 1) points[i * 2] = std::nextafter(points[i * 2], Scalar(0));
+            if (i % 5 == 3) points[i * 2 + 1] = std::nextafter(points[i * 2 + 1], Scalar(100));
+        }
+        for (Index n : batch_sizes) check_batches(a, b, c, points, n);
+
+        std::vector<int> signs(max_size);
+        predicates::incircle_batch(a, b, c, points.data(), max_size, signs.data());
+        for (Index i = 0; i < max_size; i++) {
+            if (i % 5 == 0 || i % 5 == 2 || i % 5 == 4) REQUIRE(signs[i] == 0);
+        }
+    }
+}
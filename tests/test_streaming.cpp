@@ -0,0 +1,171 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <trianglelite/trianglelite.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace trianglelite;
+
+class VectorWriter : public TriangleWriter
+{
+public:
+    void write_triangles(const LargeIndex* triangles, Index num_triangles) override
+    {
+        this->triangles.insert(this->triangles.end(), triangles, triangles + num_triangles * 3);
+    }
+
+    std::vector<LargeIndex> triangles;
+};
+
+// Sorted triangles, each starting with its smallest index.
+template <typename T>
+std::vector<std::array<LargeIndex, 3>> canonical_triangles(const T* triangles, size_t count)
+{
+    std::vector<std::array<LargeIndex, 3>> result;
+    for (size_t i = 0; i < count; i++) {
+        std::array<LargeIndex, 3> t{triangles[i * 3], triangles[i * 3 + 1], triangles[i * 3 + 2]};
+        std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+        result.push_back(t);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Streaming Delaunay", "[trianglelite][streaming]")
+{
+    const Index n = 20000;
+    std::vector<Scalar> points(n * 2);
+    bool is_unique = true;
+    SECTION("Random")
+    {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<Scalar> dist(0, 1);
+        for (auto& x : points) x = dist(gen);
+    }
+    SECTION("Grid")
+    {
+        // Cocircular points everywhere, the triangulation is not unique.
+        is_unique = false;
+        for (Index i = 0; i < n; i++) {
+            points[i * 2] = static_cast<Scalar>(i % 100);
+            points[i * 2 + 1] = static_cast<Scalar>(i / 100);
+        }
+    }
+
+    Config config;
+    config.min_angle = 0;
+    config.verbose_level = 0;
+    Engine serial;
+    serial.set_in_points(points.data(), n);
+    serial.run(config);
+    const auto expected = serial.get_out_triangles();
+
+    // 20 tiles, loaded in several batches.
+    StreamingConfig streaming_config;
+    streaming_config.points_per_tile = 1000;
+    streaming_config.max_points_in_memory = 5000;
+    streaming_config.num_threads = 4;
+    ArrayPointStream stream(points.data(), n);
+    VectorWriter writer;
+    const LargeIndex num_triangles = stream_delaunay(stream, writer, streaming_config);
+
+    REQUIRE(num_triangles == expected.rows());
+    REQUIRE(writer.triangles.size() == static_cast<size_t>(num_triangles) * 3);
+    if (is_unique) {
+        REQUIRE(canonical_triangles(writer.triangles.data(), num_triangles) ==
+                canonical_triangles(expected.data(), expected.rows()));
+    }
+}
+
+TEST_CASE("Streaming Delaunay files", "[trianglelite][streaming]")
+{
+    const Index n = 5000;
+    std::vector<Scalar> points(n * 2);
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<Scalar> dist(-1, 1);
+    for (auto& x : points) x = dist(gen);
+
+    const std::string points_file = "test_streaming_points.bin";
+    const std::string triangles_file = "test_streaming_triangles.bin";
+    {
+        std::FILE* file = std::fopen(points_file.c_str(), "wb");
+        REQUIRE(file != nullptr);
+        std::fwrite(points.data(), sizeof(Scalar), points.size(), file);
+        std::fclose(file);
+    }
+
+    StreamingConfig config;
+    config.points_per_tile = 500;
+    LargeIndex num_triangles = 0;
+    {
+        MappedPointFile stream(points_file);
+        REQUIRE(stream.size() == n);
+        TriangleFileWriter writer(triangles_file);
+        num_triangles = stream_delaunay(stream, writer, config);
+    }
+
+    std::vector<LargeIndex> triangles(num_triangles * 3);
+    {
+        std::FILE* file = std::fopen(triangles_file.c_str(), "rb");
+        REQUIRE(file != nullptr);
+        REQUIRE(std::fread(triangles.data(), sizeof(LargeIndex), triangles.size() + 1, file) ==
+                triangles.size());
+        std::fclose(file);
+    }
+    std::remove(points_file.c_str());
+    std::remove(triangles_file.c_str());
+
+    ArrayPointStream stream(points.data(), n);
+    VectorWriter writer;
+    REQUIRE(stream_delaunay(stream, writer, config) == num_triangles);
+    REQUIRE(writer.triangles == triangles);
+
+    REQUIRE_THROWS(MappedPointFile("missing_points.bin"));
+}
+
+TEST_CASE("Streaming Delaunay single precision", "[trianglelite][streaming]")
+{
+    const Index n = 5000;
+    std::vector<float> points(n * 2);
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> dist(-1, 1);
+    for (auto& x : points) x = dist(gen);
+    const std::vector<double> points_f64(points.begin(), points.end());
+
+    const std::string points_file = "test_streaming_points_f32.bin";
+    {
+        std::FILE* file = std::fopen(points_file.c_str(), "wb");
+        REQUIRE(file != nullptr);
+        std::fwrite(points.data(), sizeof(float), points.size(), file);
+        std::fclose(file);
+    }
+
+    // Same triangles as from the double precision copy of the points.
+    StreamingConfig config;
+    config.points_per_tile = 500;
+    ArrayPointStream stream_f64(points_f64.data(), n);
+    VectorWriter expected;
+    const LargeIndex num_triangles = stream_delaunay(stream_f64, expected, config);
+
+    ArrayPointStream stream(points.data(), n);
+    VectorWriter writer;
+    REQUIRE(stream_delaunay(stream, writer, config) == num_triangles);
+    REQUIRE(writer.triangles == expected.triangles);
+
+    {
+        MappedPointFile file_stream(points_file, CoordinateType::FLOAT32);
+        REQUIRE(file_stream.size() == n);
+        VectorWriter file_writer;
+        REQUIRE(stream_delaunay(file_stream, file_writer, config) == num_triangles);
+        REQUIRE(file_writer.triangles == expected.triangles);
+    }
+    std::remove(points_file.c_str());
+}
@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <trianglelite/trianglelite.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace trianglelite;
+
+// Check that the welded mesh covers the unit square without overlaps or cracks.
+void check_welded_mesh(const TiledMesh& tiles)
+{
+    Matrix2Fr points;
+    Matrix3Ir triangles;
+    tiles.weld(points, triangles);
+
+    double area = 0;
+    std::map<std::pair<Index, Index>, Index> edges;
+    for (Index t = 0; t < triangles.rows(); t++) {
+        const auto p0 = points.row(triangles(t, 0));
+        const auto p1 = points.row(triangles(t, 1));
+        const auto p2 = points.row(triangles(t, 2));
+        const double a = (p1[0] - p0[0]) * (p2[1] - p0[1]) - (p1[1] - p0[1]) * (p2[0] - p0[0]);
+        REQUIRE(a > 0);
+        area += a / 2;
+        for (Index i = 0; i < 3; i++) {
+            edges[{triangles(t, i), triangles(t, (i + 1) % 3)}]++;
+        }
+    }
+    REQUIRE_THAT(area, Catch::Matchers::WithinRel(1.0, 1e-9));
+
+    // Edges without a twin are on the boundary of the square.
+    for (const auto& entry : edges) {
+        REQUIRE(entry.second == 1);
+        if (edges.count({entry.first.second, entry.first.first}) > 0) continue;
+        const auto p0 = points.row(entry.first.first);
+        const auto p1 = points.row(entry.first.second);
+        const bool on_boundary = (p0[0] == p1[0] && (p0[0] == 0 || p0[0] == 1)) ||
+                                 (p0[1] == p1[1] && (p0[1] == 0 || p0[1] == 1));
+        REQUIRE(on_boundary);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Tiled mesh", "[trianglelite][tiling]")
+{
+    // Random points in the unit square, with its corners and a few points on tile borders.
+    const Index n = 10000;
+    std::vector<Scalar> points(n * 2);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<Scalar> dist(0, 1);
+    for (auto& x : points) x = dist(gen);
+    const Scalar extra[] = {0, 0, 1, 0, 1, 1, 0, 1, 0.5, 0.3, 0.2, 0.5, 0.5, 0.5};
+    std::copy(extra, extra + 14, points.begin());
+
+    TilingConfig tiling_config;
+    tiling_config.num_cols = 4;
+    tiling_config.num_rows = 2;
+    tiling_config.num_threads = 4;
+    TiledMesh tiles(points.data(), n, tiling_config);
+    REQUIRE(tiles.get_num_tiles() == 8);
+
+    Config config;
+    config.verbose_level = 0;
+    config.max_area = 1e-4;
+    tiles.run(config);
+    check_welded_mesh(tiles);
+
+    // Input points keep their index.
+    Matrix2Fr welded_points;
+    Matrix3Ir welded_triangles;
+    tiles.weld(welded_points, welded_triangles);
+    REQUIRE(welded_points.topRows(n) == Matrix2FrMap(points.data(), n, 2));
+
+    // Tile borders are segments, marked 1 on the boundary of the square and 2 inside of it.
+    const Engine& tile = tiles.get_tile(0);
+    const auto segment_markers = tile.get_out_segment_markers();
+    REQUIRE(segment_markers.size() > 0);
+    for (Index i = 0; i < segment_markers.size(); i++) {
+        REQUIRE((segment_markers[i] == 1 || segment_markers[i] == 2));
+    }
+    const auto ids = tiles.get_tile_point_ids(0);
+    REQUIRE(static_cast<Index>(ids.size()) == tile.get_out_points().rows());
+    REQUIRE(ids[0] == 0); // The corner (0, 0) is an input point.
+
+    // 64-bit welding gives the same mesh.
+    class VectorWriter : public TriangleWriter
+    {
+    public:
+        void write_triangles(const LargeIndex* triangles, Index num_triangles) override
+        {
+            this->triangles.insert(this->triangles.end(), triangles, triangles + num_triangles * 3);
+        }
+
+        std::vector<LargeIndex> triangles;
+    } writer;
+    std::vector<Scalar> steiner_points;
+    REQUIRE(tiles.weld(writer, steiner_points) == welded_triangles.rows());
+    REQUIRE(std::equal(writer.triangles.begin(), writer.triangles.end(), welded_triangles.data()));
+    REQUIRE(tiles.get_num_points() == n);
+    REQUIRE(static_cast<Index>(steiner_points.size() / 2) == welded_points.rows() - n);
+    REQUIRE(Matrix2FrMap(steiner_points.data(), welded_points.rows() - n, 2) ==
+            welded_points.bottomRows(welded_points.rows() - n));
+
+    // Meshing a tile again keeps it matching its neighbors.
+    config.max_area = 1e-5;
+    tiles.run_tile(5, config);
+    check_welded_mesh(tiles);
+
+    REQUIRE_THROWS(tiles.get_tile(8));
+}